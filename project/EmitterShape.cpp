@@ -0,0 +1,198 @@
+#include "EmitterShape.h"
+#include <algorithm>
+#include <cassert>
+#include <numbers>
+#include <math.h>
+#include "Random.h"
+#include "MeshSurfaceSampler.h"
+
+namespace {
+	// 1度に乱数を作る数
+	constexpr size_t kBatchSize = 256;
+	constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+
+	// 向きを(sinθcosφ, cosθ, sinθsinφ)で求める（+Y軸からの角度θ）
+	void MakeDirection(float cosTheta, float phi, float* outX, float* outY, float* outZ)
+	{
+		float sinTheta = sqrtf((std::max)(1.0f - cosTheta * cosTheta, 0.0f));
+		*outX = sinTheta * cosf(phi);
+		*outY = cosTheta;
+		*outZ = sinTheta * sinf(phi);
+	}
+}
+
+EmitterShape EmitterShape::Box(const Float3& size)
+{
+	EmitterShape shape;
+	shape.type = Type::Box;
+	shape.size = size;
+	return shape;
+}
+
+EmitterShape EmitterShape::Sphere(float radius, float innerRadius)
+{
+	EmitterShape shape;
+	shape.type = Type::Sphere;
+	shape.radius = radius;
+	shape.innerRadius = innerRadius;
+	return shape;
+}
+
+EmitterShape EmitterShape::Hemisphere(float radius, float innerRadius)
+{
+	EmitterShape shape;
+	shape.type = Type::Hemisphere;
+	shape.radius = radius;
+	shape.innerRadius = innerRadius;
+	return shape;
+}
+
+EmitterShape EmitterShape::Cone(float radius, float angle)
+{
+	EmitterShape shape;
+	shape.type = Type::Cone;
+	shape.radius = radius;
+	shape.angle = angle;
+	return shape;
+}
+
+EmitterShape EmitterShape::BoxSurface(const Float3& size)
+{
+	EmitterShape shape;
+	shape.type = Type::BoxSurface;
+	shape.size = size;
+	return shape;
+}
+
+EmitterShape EmitterShape::Ring(float radius, float innerRadius)
+{
+	EmitterShape shape;
+	shape.type = Type::Ring;
+	shape.radius = radius;
+	shape.innerRadius = innerRadius;
+	return shape;
+}
+
+EmitterShape EmitterShape::Mesh(const MeshSurfaceSampler* mesh)
+{
+	EmitterShape shape;
+	shape.type = Type::Mesh;
+	shape.mesh = mesh;
+	return shape;
+}
+
+void EmitterShape::Sample(Random& random, size_t count, float* outX, float* outY, float* outZ,
+	float* outDirectionX, float* outDirectionY, float* outDirectionZ) const
+{
+	// 箱の内部は軸ごとにそのまま埋める（向きはない）
+	if (type == Type::Box) {
+		random.FillUniform(outX, count, -size.x, size.x);
+		random.FillUniform(outY, count, -size.y, size.y);
+		random.FillUniform(outZ, count, -size.z, size.z);
+		std::fill_n(outDirectionX, count, 0.0f);
+		std::fill_n(outDirectionY, count, 0.0f);
+		std::fill_n(outDirectionZ, count, 0.0f);
+		return;
+	}
+
+	// メッシュは表の側で選ぶ
+	if (type == Type::Mesh) {
+		assert(mesh && !mesh->IsEmpty());
+		mesh->Sample(random, count, outX, outY, outZ, outDirectionX, outDirectionY, outDirectionZ);
+		return;
+	}
+
+	// それ以外は乱数を4つずつまとめて作り、1つずつ形に合わせて変換する
+	float random0[kBatchSize], random1[kBatchSize], random2[kBatchSize], random3[kBatchSize];
+	for (size_t batchBegin = 0; batchBegin < count; batchBegin += kBatchSize) {
+		size_t batchCount = (std::min)(kBatchSize, count - batchBegin);
+		random.FillUniform(random0, batchCount, 0.0f, 1.0f);
+		random.FillUniform(random1, batchCount, 0.0f, 1.0f);
+		random.FillUniform(random2, batchCount, 0.0f, 1.0f);
+		random.FillUniform(random3, batchCount, 0.0f, 1.0f);
+
+		for (size_t i = 0; i < batchCount; ++i) {
+			size_t out = batchBegin + i;
+			float& x = outX[out];
+			float& y = outY[out];
+			float& z = outZ[out];
+			float& directionX = outDirectionX[out];
+			float& directionY = outDirectionY[out];
+			float& directionZ = outDirectionZ[out];
+
+			switch (type) {
+			case Type::Sphere:
+			case Type::Hemisphere: {
+				// 球面上で一様な向き（半球はcosθを0～1に限る）と、体積で一様になる半径
+				float cosTheta = type == Type::Sphere ? 1.0f - 2.0f * random0[i] : random0[i];
+				MakeDirection(cosTheta, kTwoPi * random1[i], &directionX, &directionY, &directionZ);
+				float inner3 = innerRadius * innerRadius * innerRadius;
+				float outer3 = radius * radius * radius;
+				float distance = cbrtf(inner3 + (outer3 - inner3) * random2[i]);
+				x = directionX * distance;
+				y = directionY * distance;
+				z = directionZ * distance;
+				break;
+			}
+			case Type::Cone: {
+				// 底面の円内で一様な位置と、+Y軸からangleまでの球冠で一様な向き
+				float cosTheta = 1.0f - random0[i] * (1.0f - cosf(angle));
+				MakeDirection(cosTheta, kTwoPi * random1[i], &directionX, &directionY, &directionZ);
+				float distance = radius * sqrtf(random2[i]);
+				float phi = kTwoPi * random3[i];
+				x = distance * cosf(phi);
+				y = 0.0f;
+				z = distance * sinf(phi);
+				break;
+			}
+			case Type::BoxSurface: {
+				// 面積に比例して6面から選び、面内で一様な位置
+				float areaX = size.y * size.z, areaY = size.x * size.z, areaZ = size.x * size.y;
+				float pick = random0[i] * (areaX + areaY + areaZ);
+				float sign = random1[i] < 0.5f ? -1.0f : 1.0f;
+				float u = random2[i] * 2.0f - 1.0f;
+				float v = random3[i] * 2.0f - 1.0f;
+				if (pick < areaX) {
+					x = sign * size.x; y = u * size.y; z = v * size.z;
+					directionX = sign; directionY = 0.0f; directionZ = 0.0f;
+				} else if (pick < areaX + areaY) {
+					x = u * size.x; y = sign * size.y; z = v * size.z;
+					directionX = 0.0f; directionY = sign; directionZ = 0.0f;
+				} else {
+					x = u * size.x; y = v * size.y; z = sign * size.z;
+					directionX = 0.0f; directionY = 0.0f; directionZ = sign;
+				}
+				break;
+			}
+			case Type::Ring: {
+				// 面積で一様になる半径と、外向きの向き
+				float phi = kTwoPi * random0[i];
+				float inner2 = innerRadius * innerRadius;
+				float distance = sqrtf(inner2 + (radius * radius - inner2) * random1[i]);
+				directionX = cosf(phi);
+				directionY = 0.0f;
+				directionZ = sinf(phi);
+				x = directionX * distance;
+				y = 0.0f;
+				z = directionZ * distance;
+				break;
+			}
+			default:
+				break;
+			}
+		}
+	}
+}
+
+float EmitterShape::GetBoundingRadius() const
+{
+	switch (type) {
+	case Type::Box:
+	case Type::BoxSurface:
+		return sqrtf(size.x * size.x + size.y * size.y + size.z * size.z);
+	case Type::Mesh:
+		return mesh ? mesh->GetBoundingRadius() : 0.0f;
+	default:
+		return radius;
+	}
+}
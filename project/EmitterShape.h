@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include "MyMath.h"
+
+class Random;
+class MeshSurfaceSampler;
+
+// パーティクルを発生させる範囲の形
+// ・位置はエミッタの原点を中心としたローカル座標で求め、向きは面の外向き（Coneは広がる向き）
+// ・上はY軸。Hemisphere, Cone, Ringは+Y側に開き、XZ平面に広がる
+class EmitterShape
+{
+public:
+	enum class Type {
+		Box,		// 箱の内部（各軸±size）
+		Sphere,		// 球の内部（innerRadiusより外側）
+		Hemisphere,	// +Y側の半球の内部（innerRadiusより外側）
+		Cone,		// 半径radiusの底面から、+Y軸を中心にangleまで広がる向きに出す
+		BoxSurface,	// 箱の表面（各軸±size）
+		Ring,		// XZ平面の輪（innerRadiusからradiusまで）
+		Mesh,		// メッシュの表面
+	};
+
+	Type type = Type::Box;
+	Float3 size = { 1.0f, 1.0f, 1.0f }; //!< Box, BoxSurface: 各軸の大きさの半分
+	float radius = 1.0f; //!< Sphere, Hemisphere, Ring: 外側の半径 / Cone: 底面の半径
+	float innerRadius = 0.0f; //!< Sphere, Hemisphere, Ring: 内側の半径
+	float angle = 0.5f; //!< Cone: 広がりの半角（ラジアン）
+	const MeshSurfaceSampler* mesh = nullptr; //!< Mesh: 表面を選ぶ表（使う間は破棄しないこと）
+	float speed = 0.0f; //!< 向きに沿って初速度に加える速さ
+
+	///
+	/// 形ごとの作成
+	///
+
+	static EmitterShape Box(const Float3& size);
+	static EmitterShape Sphere(float radius, float innerRadius = 0.0f);
+	static EmitterShape Hemisphere(float radius, float innerRadius = 0.0f);
+	static EmitterShape Cone(float radius, float angle);
+	static EmitterShape BoxSurface(const Float3& size);
+	static EmitterShape Ring(float radius, float innerRadius = 0.0f);
+	static EmitterShape Mesh(const MeshSurfaceSampler* mesh);
+
+	// count個の発生位置と向きを求める
+	void Sample(Random& random, size_t count, float* outX, float* outY, float* outZ,
+		float* outDirectionX, float* outDirectionY, float* outDirectionZ) const;
+
+	// 発生位置を全て囲む、原点中心の球の半径
+	float GetBoundingRadius() const;
+};
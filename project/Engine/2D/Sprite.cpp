@@ -2,6 +2,8 @@
 #include "SpriteCommon.h"
 #include "DirectXUtil.h"
 #include "TextureManager.h"
+#include "FrameStats.h"
+#include "TransformBatch.h"
 
 void Sprite::Initialize(SpriteCommon* spriteCommon, uint32_t textureIndex)
 {
@@ -38,6 +40,9 @@ void Sprite::Initialize(SpriteCommon* spriteCommon, uint32_t textureIndex)
 
 	// IndexResourceにデータを書き込むためのアドレスを取得してindexDataに割り当てる
 	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData_));
+	// インデックスは変わらないので最初に一度だけ書き込む
+	indexData_[0] = 0; indexData_[1] = 1; indexData_[2] = 2;
+	indexData_[3] = 1; indexData_[4] = 3; indexData_[5] = 2;
 
 	// materialResourceにデータを書き込むためのアドレスを取得してmaterialDataに割り当てる
 	materialResource_->Map(0, nullptr, reinterpret_cast<void**>(&materialData_));
@@ -65,12 +70,83 @@ void Sprite::Initialize(SpriteCommon* spriteCommon, uint32_t textureIndex)
 
 void Sprite::Update()
 {
+	if (BeginUpdate()) {
+		WriteTransform(transform_.MakeAffineMatrix());
+	}
+}
+
+void Sprite::UpdateSprites(Sprite* const* sprites, size_t count)
+{
+	// 行列を書き込むものだけを集めて、ワールド行列はTransformBatchでまとめて求める
+	thread_local TransformBatch batch;
+	thread_local std::vector<Sprite*> changedSprites;
+	thread_local std::vector<Matrix> worldMatrices;
+	batch.Clear();
+	changedSprites.clear();
+	for (size_t index = 0; index < count; ++index) {
+		Sprite* sprite = sprites[index];
+		if (sprite->BeginUpdate()) {
+			changedSprites.push_back(sprite);
+			batch.Add(sprite->transform_);
+		}
+	}
+
+	worldMatrices.resize(changedSprites.size());
+	batch.MakeAffineMatrices(worldMatrices.data());
+	for (size_t index = 0; index < changedSprites.size(); ++index) {
+		changedSprites[index]->WriteTransform(worldMatrices[index]);
+	}
+}
+
+bool Sprite::BeginUpdate()
+{
+	if (Window::GetWidth() != cachedWindowWidth_ || Window::GetHeight() != cachedWindowHeight_) {
+		isTransformDirty_ = true;
+	}
+
+	// 何も変わっていなければ書き込まない
+	if (!isVertexDirty_ && !isTransformDirty_) {
+		FrameStats::GetInstance()->Add(FrameStats::Counter::SpriteSkip);
+		return false;
+	}
+	FrameStats::GetInstance()->Add(FrameStats::Counter::SpriteUpdate);
+
+	if (isVertexDirty_) {
+		UpdateVertexData();
+		isVertexDirty_ = false;
+	}
+
+	if (!isTransformDirty_) {
+		return false;
+	}
 	// 座標を反映
 	transform_.translate = { position_.x, position_.y, 0.0f };
 	// 回転を反映
 	transform_.rotate = { 0.0f, 0.0f, rotation };
 	// サイズを反映
 	transform_.scale = { size_.x, size_.y, 1.0f };
+	return true;
+}
+
+void Sprite::WriteTransform(const Matrix& worldMatrix)
+{
+	uint32_t windowWidth = Window::GetWidth();
+	uint32_t windowHeight = Window::GetHeight();
+
+	// Transform情報を作る
+	Matrix viewMatrix = Matrix::Identity();
+	Matrix projectionMatrix = Matrix::Orthographic(static_cast<float>(windowWidth), static_cast<float>(windowHeight), 0.0f, 1000.0f);
+	Matrix worldViewProjectionMatrix = worldMatrix * viewMatrix * projectionMatrix;
+	transformationMatrixData_->WVP = worldViewProjectionMatrix;
+	transformationMatrixData_->World = worldMatrix;
+
+	cachedWindowWidth_ = windowWidth;
+	cachedWindowHeight_ = windowHeight;
+	isTransformDirty_ = false;
+}
+
+void Sprite::UpdateVertexData()
+{
 	// アンカーポイント
 	float left = 0.0f - anchorPoint.x;
 	float right = 1.0f - anchorPoint.x;
@@ -112,19 +188,6 @@ void Sprite::Update()
 	vertexData_[3].position = { right, top, 0.0f, 1.0f };
 	vertexData_[3].texcoord = { tex_right, tex_top };
 	vertexData_[3].normal = { 0.0f, 0.0f, -1.0f };
-
-	// インデックスリソースにデータを書き込む
-	indexData_[0] = 0; indexData_[1] = 1; indexData_[2] = 2;
-	indexData_[3] = 1; indexData_[4] = 3; indexData_[5] = 2;
-
-
-	// Transform情報を作る
-	Matrix worldMatrix = transform_.MakeAffineMatrix();
-	Matrix viewMatrix = Matrix::Identity();
-	Matrix projectionMatrix = Matrix::Orthographic(static_cast<float>(Window::GetWidth()), static_cast<float>(Window::GetHeight()), 0.0f, 1000.0f);
-	Matrix worldViewProjectionMatrix = worldMatrix * viewMatrix * projectionMatrix;
-	transformationMatrixData_->WVP = worldViewProjectionMatrix;
-	transformationMatrixData_->World = worldMatrix;
 }
 
 void Sprite::Draw()
@@ -152,4 +215,7 @@ void Sprite::AdjustTextureSize()
 	textureSize_.y = static_cast<float>(metadata.height);
 	// 画像サイズをテクスチャサイズに合わせる
 	size_ = textureSize_;
+
+	isVertexDirty_ = true;
+	isTransformDirty_ = true;
 }
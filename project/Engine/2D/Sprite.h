@@ -28,7 +28,11 @@ public:
 	// 初期化
 	void Initialize(SpriteCommon* spriteCommon, uint32_t textureIndex);
 	// 更新
+	// パラメータが変わったときだけ頂点・行列を書き込む
 	void Update();
+	// 複数のSpriteのUpdateをまとめて行う
+	// 行列を書き込むものだけワールド行列をTransformBatchでまとめて求める
+	static void UpdateSprites(Sprite* const* sprites, size_t count);
 	// 描画
 	void Draw();
 
@@ -38,31 +42,31 @@ public:
 
 	// 座標
 	const Float2 GetPosition() const { return position_; }
-	void SetPosition(const Float2& position) { this->position_ = position; }
+	void SetPosition(const Float2& position) { this->position_ = position; isTransformDirty_ = true; }
 	// 回転
 	float GetRotation() const { return rotation; }
-	void SetRotation(float rotation) { this->rotation = rotation; }
+	void SetRotation(float rotation) { this->rotation = rotation; isTransformDirty_ = true; }
 	// 色
 	const Float4& GetColor() const { return materialData_->color; }
 	void SetColor(const Float4& color) { materialData_->color = color; }
 	// サイズ
 	const Float2& GetSize() const { return size_; }
-	void SetSize(const Float2& size) { this->size_ = size; }
+	void SetSize(const Float2& size) { this->size_ = size; isTransformDirty_ = true; }
 	// アンカーポイント
 	const Float2& GetAnchorPoint() const { return anchorPoint; }
-	void SetAnchorPoint(const Float2& anchorPoint) { this->anchorPoint = anchorPoint; }
+	void SetAnchorPoint(const Float2& anchorPoint) { this->anchorPoint = anchorPoint; isVertexDirty_ = true; }
 	// 左右フリップ
 	bool IsFlipX() const { return isFlipX_; }
-	void SetFlipX(bool flipX) { isFlipX_ = flipX; }
+	void SetFlipX(bool flipX) { isFlipX_ = flipX; isVertexDirty_ = true; }
 	// 上下フリップ
 	bool IsFlipY() const { return isFlipY_; }
-	void SetFlipY(bool flipY) { isFlipY_ = flipY; }
+	void SetFlipY(bool flipY) { isFlipY_ = flipY; isVertexDirty_ = true; }
 	// テクスチャ左上座標
 	const Float2& GetTextureLeftTop() const { return textureLeftTop_; }
-	void SetTextureLeftTop(const Float2& textureLeftTop) { this->textureLeftTop_ = textureLeftTop; }
+	void SetTextureLeftTop(const Float2& textureLeftTop) { this->textureLeftTop_ = textureLeftTop; isVertexDirty_ = true; }
 	// テクスチャ切り出しサイズ
 	const Float2& GetTextureSize() const { return textureSize_; }
-	void SetTextureSize(const Float2& textureSize) { this->textureSize_ = textureSize; }
+	void SetTextureSize(const Float2& textureSize) { this->textureSize_ = textureSize; isVertexDirty_ = true; }
 
 private:
 	SpriteCommon* spriteCommon = nullptr;
@@ -104,7 +108,20 @@ private:
 	// テクスチャ切り出しサイズ
 	Float2 textureSize_ = { 100.0f, 100.0f };
 
+	// 変更があったか（Setterで立て、Updateで書き込んだら下ろす）
+	bool isVertexDirty_ = true;
+	bool isTransformDirty_ = true;
+	// 前回行列を書き込んだときのウィンドウサイズ
+	uint32_t cachedWindowWidth_ = 0;
+	uint32_t cachedWindowHeight_ = 0;
+
+	// Updateの前半。頂点を書き込み、行列を書き込む必要があればtransform_を設定してtrueを返す
+	bool BeginUpdate();
+	// Updateの後半。ワールド行列から行列を書き込む
+	void WriteTransform(const Matrix& worldMatrix);
 	// テクスチャサイズをイメージに合わせる
 	void AdjustTextureSize();
+	// 頂点リソースに4頂点を書き込む
+	void UpdateVertexData();
 };
 
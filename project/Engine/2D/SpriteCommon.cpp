@@ -36,7 +36,7 @@ void SpriteCommon::PreDraw()
 	// ルートシグネチャをセット
 	dxBase_->GetCommandList()->SetGraphicsRootSignature(rootSignature_.Get());
 	// グラフィックスパイプラインステートをセット
-	dxBase_->GetCommandList()->SetPipelineState(graphicsPipelineState_.Get());
+	dxBase_->SetPipelineState(graphicsPipelineState_.Get());
 	// プリミティブトポロジーをセット
 	dxBase_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
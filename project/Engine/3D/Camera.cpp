@@ -1,6 +1,7 @@
 #include "camera.h"
 #include "MyWindow.h"
 #include "DirectXBase.h"
+#include "FrameStats.h"
 
 Camera::Camera(Float3 argTranslate, Float3 argRotate, float argFov)
 {
@@ -16,16 +17,69 @@ void Camera::TransferConstantBuffer()
 	DirectXBase::GetInstance()->GetCommandList()->SetGraphicsRootConstantBufferView(4, current_->cameraCB_.resource_->GetGPUVirtualAddress());
 }
 
-Matrix Camera::MakeViewMatrix()
+const Matrix& Camera::GetViewMatrix()
 {
-	// カメラのtransformからアフィン変換行列を作成
-	Matrix affine = transform.MakeAffineMatrix();
-	// 逆行列を計算して返す（ビューマトリックス）
-	return Matrix::Inverse(affine);
+	UpdateIfDirty();
+	return viewMatrix_;
 }
 
-Matrix Camera::MakePerspectiveFovMatrix()
+const Matrix& Camera::GetProjectionMatrix()
 {
-	// 透視投影行列を生成して返す
-	return Matrix::PerspectiveFovLH(fov, static_cast<float>(Window::GetWidth()) / static_cast<float>(Window::GetHeight()), nearZ, farZ);
+	UpdateIfDirty();
+	return projectionMatrix_;
+}
+
+const Matrix& Camera::GetViewProjectionMatrix()
+{
+	UpdateIfDirty();
+	return viewProjectionMatrix_;
+}
+
+const Frustum& Camera::GetFrustum()
+{
+	UpdateIfDirty();
+	return frustum_;
+}
+
+const Culling::Planes& Camera::GetCullingPlanes()
+{
+	UpdateIfDirty();
+	return cullingPlanes_;
+}
+
+uint32_t Camera::GetVersion()
+{
+	UpdateIfDirty();
+	return version_;
+}
+
+void Camera::UpdateIfDirty()
+{
+	float aspectRatio = static_cast<float>(Window::GetWidth()) / static_cast<float>(Window::GetHeight());
+
+	// 前回計算したときから何も変わっていなければキャッシュをそのまま使う
+	if (isCacheValid_ &&
+		transform.scale == cachedTransform_.scale &&
+		transform.rotate == cachedTransform_.rotate &&
+		transform.translate == cachedTransform_.translate &&
+		fov == cachedFov_ && aspectRatio == cachedAspectRatio_ &&
+		nearZ == cachedNearZ_ && farZ == cachedFarZ_) {
+		return;
+	}
+
+	viewMatrix_ = transform.MakeInverseAffineMatrix();
+	projectionMatrix_ = Matrix::PerspectiveFovLH(fov, aspectRatio, nearZ, farZ);
+	viewProjectionMatrix_ = viewMatrix_ * projectionMatrix_;
+	frustum_ = Frustum::FromViewProjection(viewProjectionMatrix_);
+	cullingPlanes_ = Culling::MakePlanes(frustum_);
+
+	isCacheValid_ = true;
+	cachedTransform_ = transform;
+	cachedFov_ = fov;
+	cachedAspectRatio_ = aspectRatio;
+	cachedNearZ_ = nearZ;
+	cachedFarZ_ = farZ;
+	version_ = ++versionCounter_;
+
+	FrameStats::GetInstance()->Add(FrameStats::Counter::CameraRecompute);
 }
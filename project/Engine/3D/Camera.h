@@ -1,5 +1,7 @@
 #pragma once
 #include "MyMath.h"
+#include "Frustum.h"
+#include "Culling.h"
 #include "ConstBuffer.h"
 
 struct CameraCBData {
@@ -19,14 +21,48 @@ public:
 	// クリップの設定
 	float nearZ = 0.1f, farZ = 1000.0f;
 
-	Matrix MakeViewMatrix();
-	Matrix MakePerspectiveFovMatrix();
+	///
+	/// キャッシュ済みの値
+	/// transform / fov / アスペクト比 / クリップ距離が前回の計算から変わっていれば再計算する
+	///
+
+	const Matrix& GetViewMatrix();
+	const Matrix& GetProjectionMatrix();
+	const Matrix& GetViewProjectionMatrix();
+	const Frustum& GetFrustum();
+	// カリング判定用に並べ替えた視錐台の平面
+	const Culling::Planes& GetCullingPlanes();
+
+	// 再計算のたびに変わる。キャッシュ側で変更を検出するのに使う
+	// 全カメラで通し番号なので、カメラが差し替わっても同じ値にはならない
+	uint32_t GetVersion();
 
 	static void Set(Camera* camera) { current_ = camera; }
 	static Camera* GetCurrent() { return current_; }
 private:
+	// 変更があればキャッシュを作り直す
+	void UpdateIfDirty();
+
 	inline static Camera* current_;
+	// 全カメラ共通のバージョン番号
+	inline static uint32_t versionCounter_ = 0;
 
 	ConstBuffer<CameraCBData> cameraCB_;
+
+	// キャッシュ
+	Matrix viewMatrix_;
+	Matrix projectionMatrix_;
+	Matrix viewProjectionMatrix_;
+	Frustum frustum_;
+	Culling::Planes cullingPlanes_;
+	uint32_t version_ = 0;
+
+	// キャッシュを作ったときの値
+	bool isCacheValid_ = false;
+	Transform cachedTransform_;
+	float cachedFov_ = 0.0f;
+	float cachedAspectRatio_ = 0.0f;
+	float cachedNearZ_ = 0.0f;
+	float cachedFarZ_ = 0.0f;
 };
 
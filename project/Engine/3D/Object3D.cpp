@@ -1,6 +1,11 @@
 #include "Object3D.h"
+#include <cassert>
 #include "Camera.h"
 #include "SRVManager.h"
+#include "FrameStats.h"
+#include "Culling.h"
+#include "TransformBatch.h"
+#include "VertexQuantization.h"
 
 Object3D::Object3D()
 {
@@ -23,16 +28,114 @@ Object3D::Object3D()
 
 void Object3D::UpdateMatrix()
 {
-	Matrix worldMatrix = transform_.MakeAffineMatrix();
-	Matrix viewMatrix = Camera::GetCurrent()->MakeViewMatrix();
-	Matrix projectionMatrix = Camera::GetCurrent()->MakePerspectiveFovMatrix();
-	Matrix worldViewProjectionMatrix = worldMatrix * viewMatrix * projectionMatrix;
+	if (IsMatrixCurrent()) {
+		FrameStats::GetInstance()->Add(FrameStats::Counter::ObjectMatrixSkip);
+		return;
+	}
+	WriteMatrix(transform_.MakeAffineMatrix());
+}
+
+void Object3D::UpdateMatrices(Object3D* const* objects, size_t count)
+{
+	// 変わったものだけを集めて、ワールド行列はTransformBatchでまとめて求める
+	thread_local TransformBatch batch;
+	thread_local std::vector<Object3D*> changedObjects;
+	thread_local std::vector<Matrix> worldMatrices;
+	batch.Clear();
+	changedObjects.clear();
+	for (size_t index = 0; index < count; ++index) {
+		Object3D* object = objects[index];
+		if (object->IsMatrixCurrent()) {
+			FrameStats::GetInstance()->Add(FrameStats::Counter::ObjectMatrixSkip);
+			continue;
+		}
+		changedObjects.push_back(object);
+		batch.Add(object->transform_);
+	}
+
+	worldMatrices.resize(changedObjects.size());
+	batch.MakeAffineMatrices(worldMatrices.data());
+	for (size_t index = 0; index < changedObjects.size(); ++index) {
+		changedObjects[index]->WriteMatrix(worldMatrices[index]);
+	}
+}
+
+bool Object3D::IsMatrixCurrent() const
+{
+	Camera* camera = Camera::GetCurrent();
+
+	// モデルは範囲と頂点の形式が同じなら同じとみなす
+	bool isSameModel = model_ ?
+		cachedHasModel_ &&
+		model_->bounds.min == cachedModelBounds_.min && model_->bounds.max == cachedModelBounds_.max &&
+		model_->vertexFormat == cachedVertexFormat_ :
+		!cachedHasModel_;
+
+	// 前回書き込んだときから何も変わっていなければ、CBの中身はそのまま使える
+	return isMatrixValid_ &&
+		transform_.scale == cachedTransform_.scale &&
+		transform_.rotate == cachedTransform_.rotate &&
+		transform_.translate == cachedTransform_.translate &&
+		isSameModel &&
+		camera == cachedCamera_ && camera->GetVersion() == cachedCameraVersion_;
+}
+
+void Object3D::WriteMatrix(Matrix worldMatrix)
+{
+	Camera* camera = Camera::GetCurrent();
+
+	if (hasLocalMatrix_) {
+		worldMatrix = localMatrix_ * worldMatrix;
+	}
+
+	// モデルの範囲をワールド座標に変換して視錐台と判定する
+	isVisible_ = true;
+	if (model_) {
+		AABB worldBounds = Culling::TransformAABB(model_->bounds, worldMatrix);
+		isVisible_ = Culling::IsVisible(camera->GetCullingPlanes(), worldBounds);
+	}
+	// 見えないものはCBに書き込まない（Drawで何もしないので古い中身のままでよい）
+	// isMatrixValid_を下ろしておき、見えるようになったフレームで必ず書き込ませる
+	if (!isVisible_) {
+		isMatrixValid_ = false;
+		return;
+	}
+	// ビュープロジェクション行列はカメラ側でキャッシュされているので、かけるのは1回だけ
+	Matrix worldViewProjectionMatrix = worldMatrix * camera->GetViewProjectionMatrix();
+	// 圧縮した頂点の位置は0～1なので、モデルの座標に戻す行列を前にかけておく（Worldは法線にだけ使う）
+	if (model_ && model_->vertexFormat == ModelManager::VertexFormat::Quantized) {
+		worldViewProjectionMatrix = VertexQuantization::MakeDequantizeMatrix(model_->bounds) * worldViewProjectionMatrix;
+	}
 	wvpCB_.data_->WVP = worldViewProjectionMatrix;
 	wvpCB_.data_->World = worldMatrix;
+
+	isMatrixValid_ = true;
+	cachedTransform_ = transform_;
+	cachedHasModel_ = model_ != nullptr;
+	if (model_) {
+		cachedModelBounds_ = model_->bounds;
+		cachedVertexFormat_ = model_->vertexFormat;
+	}
+	cachedCamera_ = camera;
+	cachedCameraVersion_ = camera->GetVersion();
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ObjectMatrixUpdate);
+}
+
+void Object3D::SetLocalMatrix(const Matrix& localMatrix)
+{
+	localMatrix_ = localMatrix;
+	hasLocalMatrix_ = true;
+	isMatrixValid_ = false;
 }
 
 void Object3D::Draw()
 {
+	// 視錐台の外なら描画しない
+	if (!isVisible_) {
+		FrameStats::GetInstance()->Add(FrameStats::Counter::ObjectCulled);
+		return;
+	}
+
 	DirectXBase* dxBase = DirectXBase::GetInstance();
 
 	// 平行光源の定数バッファをセット
@@ -40,18 +143,32 @@ void Object3D::Draw()
 
 	// commandListにVBVを設定
 	dxBase->GetCommandList()->IASetVertexBuffers(0, 1, &model_->vertexBufferView);
+	// commandListにIBVを設定
+	dxBase->GetCommandList()->IASetIndexBuffer(&model_->indexBufferView);
 	// マテリアルCBufferの場所を設定
 	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialCB_.resource_->GetGPUVirtualAddress());
 	// wvp用のCBufferの場所を設定
 	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(1, wvpCB_.resource_->GetGPUVirtualAddress());
 	// SRVのDescriptorTableの先頭を設定（Textureの設定）
 	TextureManager::SetDescriptorTable(2, dxBase->GetCommandList(), model_->material.textureHandle); // モデルデータに格納されたテクスチャを使用する
+	// 圧縮した頂点のモデルならPSOを切り替える
+	ID3D12PipelineState* boundPipelineState = SetQuantizedPipelineState();
 	// 描画を行う（DrawCall/ドローコール）
-	dxBase->GetCommandList()->DrawInstanced(UINT(model_->vertices.size()), 1, 0, 0);
+	dxBase->GetCommandList()->DrawIndexedInstanced(UINT(model_->indices.size()), 1, 0, 0, 0);
+	// PSOを元に戻す
+	if (boundPipelineState) {
+		dxBase->SetPipelineState(boundPipelineState);
+	}
 }
 
 void Object3D::Draw(const int TextureHandle)
 {
+	// 視錐台の外なら描画しない
+	if (!isVisible_) {
+		FrameStats::GetInstance()->Add(FrameStats::Counter::ObjectCulled);
+		return;
+	}
+
 	DirectXBase* dxBase = DirectXBase::GetInstance();
 
 	// 平行光源の定数バッファをセット
@@ -59,32 +176,61 @@ void Object3D::Draw(const int TextureHandle)
 
 	// commandListにVBVを設定
 	dxBase->GetCommandList()->IASetVertexBuffers(0, 1, &model_->vertexBufferView);
+	// commandListにIBVを設定
+	dxBase->GetCommandList()->IASetIndexBuffer(&model_->indexBufferView);
 	// マテリアルCBufferの場所を設定
 	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialCB_.resource_->GetGPUVirtualAddress());
 	// wvp用のCBufferの場所を設定
 	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(1, wvpCB_.resource_->GetGPUVirtualAddress());
 	// SRVのDescriptorTableの先頭を設定（Textureの設定）
 	TextureManager::SetDescriptorTable(2, dxBase->GetCommandList(), TextureHandle); // 指定したテクスチャを使用する
+	// 圧縮した頂点のモデルならPSOを切り替える
+	ID3D12PipelineState* boundPipelineState = SetQuantizedPipelineState();
 	// 描画を行う（DrawCall/ドローコール）
-	dxBase->GetCommandList()->DrawInstanced(UINT(model_->vertices.size()), 1, 0, 0);
+	dxBase->GetCommandList()->DrawIndexedInstanced(UINT(model_->indices.size()), 1, 0, 0, 0);
+	// PSOを元に戻す
+	if (boundPipelineState) {
+		dxBase->SetPipelineState(boundPipelineState);
+	}
 }
 
-void Object3D::DrawInstancing(StructuredBuffer<ParticleForGPU>& structuredBuffer, uint32_t numInstance, const uint32_t TextureHandle)
+void Object3D::DrawInstancing(RingStructuredBuffer<ParticleForGPU>& structuredBuffer, ConstBuffer<ParticleViewForGPU>& viewCB, const uint32_t TextureHandle)
 {
+	// パーティクル用のVSはfloatの頂点しか読めない
+	assert(model_->vertexFormat == ModelManager::VertexFormat::Float);
+
 	DirectXBase* dxBase = DirectXBase::GetInstance();
 
 	// パーティクル用ルートシグネチャを設定
 	dxBase->GetCommandList()->SetGraphicsRootSignature(dxBase->GetRootSignatureParticle());
 	// パーティクル用PSOを設定
-	dxBase->GetCommandList()->SetPipelineState(dxBase->GetPipelineStateParticle());
+	dxBase->SetPipelineState(dxBase->GetPipelineStateParticle());
 	// commandListにVBVを設定
 	dxBase->GetCommandList()->IASetVertexBuffers(0, 1, &model_->vertexBufferView);
+	// commandListにIBVを設定
+	dxBase->GetCommandList()->IASetIndexBuffer(&model_->indexBufferView);
 	// マテリアルCBufferの場所を設定
 	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialCB_.resource_->GetGPUVirtualAddress());
 	// instancing用のDataを読むためにStructuredBufferのSRVを設定する
-	dxBase->GetCommandList()->SetGraphicsRootDescriptorTable(1, SRVManager::GetInstance()->descriptorHeap.GetGPUHandle(structuredBuffer.heapIndex_));
+	dxBase->GetCommandList()->SetGraphicsRootDescriptorTable(1, SRVManager::GetInstance()->descriptorHeap.GetGPUHandle(structuredBuffer.GetSRVIndex()));
+	// ビルボードとビュープロジェクション行列のCBufferの場所を設定
+	dxBase->GetCommandList()->SetGraphicsRootConstantBufferView(5, viewCB.resource_->GetGPUVirtualAddress());
 	// SRVのDescriptorTableの先頭を設定（Textureの設定）
 	TextureManager::SetDescriptorTable(2, dxBase->GetCommandList(), TextureHandle); // 引数で指定したテクスチャを使用する
 	// 描画を行う（DrawCall/ドローコール）
-	dxBase->GetCommandList()->DrawInstanced(UINT(model_->vertices.size()), numInstance, 0, 0);
+	dxBase->GetCommandList()->DrawIndexedInstanced(UINT(model_->indices.size()), structuredBuffer.GetNumWritten(), 0, 0, 0);
+}
+
+ID3D12PipelineState* Object3D::SetQuantizedPipelineState()
+{
+	if (model_->vertexFormat != ModelManager::VertexFormat::Quantized) {
+		return nullptr;
+	}
+	DirectXBase* dxBase = DirectXBase::GetInstance();
+	ID3D12PipelineState* boundPipelineState = dxBase->GetBoundPipelineState();
+	ID3D12PipelineState* quantizedPipelineState = dxBase->GetQuantizedPipelineState(boundPipelineState);
+	// 圧縮した頂点用が無いPSO（パーティクル用など）では描画できない
+	assert(quantizedPipelineState);
+	dxBase->SetPipelineState(quantizedPipelineState);
+	return boundPipelineState;
 }
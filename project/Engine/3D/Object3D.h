@@ -3,7 +3,9 @@
 #include "ModelManager.h"
 #include "TextureManager.h"
 #include "ConstBuffer.h"
-#include "StructuredBuffer.h"
+#include "RingStructuredBuffer.h"
+
+class Camera;
 
 class Object3D
 {
@@ -26,23 +28,50 @@ public:
 		float intensity; // 輝度
 	};
 
+	// パーティクル1つ分のインスタンスデータ（32バイト）
+	// ビルボードとビュープロジェクションはParticleViewForGPUでグループ共通に渡し、VSで合成する
 	struct ParticleForGPU {
-		Matrix WVP;
-		Matrix World;
-		Float4 color;
+		Float3 position;
+		float scale; // 一様スケール
+		float rotation; // ビルボードの面内（Z軸）の回転
+		uint32_t color; // RGBA8（下位からR, G, B, A）
+		float padding[2];
+	};
+	static_assert(sizeof(ParticleForGPU) == 32, "ParticleForGPU must match the layout in Particle.VS.hlsl");
+
+	// パーティクルの描画に共通で使う行列
+	struct ParticleViewForGPU {
+		Matrix billboard; // 平行移動を含まないビルボード行列
+		Matrix viewProjection;
 	};
 
 	Object3D();
 
-	// マトリックス情報の更新
+	// マトリックス情報の更新と視錐台カリング
+	// transform_・ローカル行列・モデル・カメラが前回から変わっていなければ何もしない
+	// 視錐台の外ならCBには書き込まず、次のUpdateMatrixで判定し直す
 	void UpdateMatrix();
 
+	// 複数のObject3DのUpdateMatrixをまとめて行う
+	// 変わったものだけワールド行列をTransformBatchでまとめて求める（結果はUpdateMatrixと同じ）
+	static void UpdateMatrices(Object3D* const* objects, size_t count);
+
+	// モデルのルートノードなど、ワールド行列の前にかける行列を設定
+	void SetLocalMatrix(const Matrix& localMatrix);
+
+	// 次のUpdateMatrixで必ず行列を書き込ませる
+	void SetDirty() { isMatrixValid_ = false; }
+
+	// 直前のUpdateMatrixで視錐台の中にあると判定されたか
+	bool IsVisible() const { return isVisible_; }
+
 	// 描画（モデル内のテクスチャを参照 / テクスチャを指定して描画）
 	void Draw();
 
 	void Draw(const int TextureHandle);
 
-	void DrawInstancing(StructuredBuffer<ParticleForGPU>& structuredBuffer, uint32_t numInstance, const uint32_t TextureHandle);
+	// structuredBufferに直前に書き込んだ数だけインスタンスを描画する
+	void DrawInstancing(RingStructuredBuffer<ParticleForGPU>& structuredBuffer, ConstBuffer<ParticleViewForGPU>& viewCB, const uint32_t TextureHandle);
 
 	// マテリアルの定数バッファ
 	ConstBuffer<Material>materialCB_;
@@ -58,5 +87,33 @@ public:
 
 	// 平行光源の定数バッファ
 	ConstBuffer<DirectionalLight> directionalLightCB_;
+
+private:
+	// 圧縮した頂点のモデルなら、設定中のPSOを対応する圧縮頂点用のPSOに切り替える
+	// 切り替えたときは元のPSOを返すので、描画後にそれを設定し直す（切り替えなければnullptr）
+	ID3D12PipelineState* SetQuantizedPipelineState();
+
+	// 前回wvpCB_に書き込んだときから、行列と可視判定に使うものが何も変わっていないか
+	bool IsMatrixCurrent() const;
+	// Transformから求めたワールド行列で視錐台カリングを行い、wvpCB_に書き込む
+	void WriteMatrix(Matrix worldMatrix);
+
+	// ワールド行列の前にかける行列
+	Matrix localMatrix_;
+	bool hasLocalMatrix_ = false;
+
+	// 視錐台の中にあるか（見えないものはDrawで何もしない）
+	bool isVisible_ = true;
+
+	// 前回wvpCB_に書き込んだときの値
+	bool isMatrixValid_ = false;
+	Transform cachedTransform_;
+	// 行列と可視判定がモデルから使うのは範囲と頂点の形式だけなので、ポインタではなく中身を覚えておく
+	// （解放されたモデルと同じアドレスに別のモデルが読み込まれても取り違えない）
+	bool cachedHasModel_ = false;
+	AABB cachedModelBounds_;
+	ModelManager::VertexFormat cachedVertexFormat_ = ModelManager::VertexFormat::Float;
+	const Camera* cachedCamera_ = nullptr;
+	uint32_t cachedCameraVersion_ = 0;
 };
 
@@ -31,10 +31,11 @@ void OutlinedObject::Draw()
 		// アウトラインのモデル情報を更新
 		outline_.model_ = this->model_;
 		// アウトライン用のPSOを設定
-		dxBase->GetCommandList()->SetPipelineState(dxBase->GetPipelineStateOutline());
+		ID3D12PipelineState* boundPipelineState = dxBase->GetBoundPipelineState();
+		dxBase->SetPipelineState(dxBase->GetPipelineStateOutline());
 		// アウトラインの描画
 		outline_.Draw();
 		// PSOを元に戻す
-		dxBase->GetCommandList()->SetPipelineState(dxBase->GetPipelineState());
+		dxBase->SetPipelineState(boundPipelineState);
 	}
 }
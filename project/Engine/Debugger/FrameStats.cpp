@@ -0,0 +1,44 @@
+#include "FrameStats.h"
+#include "externals/imgui/imgui.h"
+
+namespace {
+	// Counterの並びと対応させること
+	const char* const kCounterNames[] = {
+		"Camera recompute",
+		"Object3D matrix update",
+		"Object3D matrix skip",
+		"Sprite update",
+		"Sprite skip",
+		"Object3D culled",
+		"Particle drawn",
+		"Particle culled",
+		"Particle sorted",
+		"Particle emitted",
+		"Particle emit throttled",
+	};
+}
+
+FrameStats* FrameStats::GetInstance()
+{
+	static FrameStats instance;
+	return &instance;
+}
+
+void FrameStats::BeginFrame()
+{
+	for (size_t i = 0; i < kCounterCount; ++i) {
+		last_[i] = current_[i];
+		current_[i] = 0;
+	}
+}
+
+void FrameStats::DrawImGui()
+{
+	static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) == kCounterCount, "kCounterNamesとCounterの数が一致していません");
+
+	ImGui::Begin("FrameStats");
+	for (size_t i = 0; i < kCounterCount; ++i) {
+		ImGui::Text("%s: %u", kCounterNames[i], last_[i]);
+	}
+	ImGui::End();
+}
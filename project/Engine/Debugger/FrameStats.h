@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// フレームごとの処理回数を数える
+// BeginFrameで前フレームの値を確定させてからリセットする
+class FrameStats
+{
+public:
+	enum class Counter {
+		CameraRecompute,	// カメラの行列・視錐台の再計算回数
+		ObjectMatrixUpdate,	// Object3Dの行列を計算して書き込んだ回数
+		ObjectMatrixSkip,	// Object3Dの行列が変わらず省略した回数
+		SpriteUpdate,		// Spriteの頂点・行列を書き込んだ回数
+		SpriteSkip,			// Spriteに変更がなく省略した回数
+		ObjectCulled,		// 視錐台の外にあり描画しなかったObject3Dの数
+		ParticleDrawn,		// 描画したパーティクルの数
+		ParticleCulled,		// 視錐台の外にあり描画しなかったパーティクルの数
+		ParticleSorted,		// 描画順を並べ替えたパーティクルの数
+		ParticleEmitted,	// 発生させたパーティクルの数
+		ParticleEmitThrottled,	// 上限やLODで発生させなかったパーティクルの数
+
+		kCount
+	};
+
+	static FrameStats* GetInstance();
+
+	// フレーム開始時に呼ぶ
+	void BeginFrame();
+
+	// カウンタを加算
+	void Add(Counter counter, uint32_t value = 1) { current_[static_cast<size_t>(counter)] += value; }
+
+	// 直前のフレームで確定した値
+	uint32_t Get(Counter counter) const { return last_[static_cast<size_t>(counter)]; }
+
+	// ImGuiに一覧を表示
+	void DrawImGui();
+
+private:
+	static constexpr size_t kCounterCount = static_cast<size_t>(Counter::kCount);
+
+	uint32_t current_[kCounterCount] = {};
+	uint32_t last_[kCounterCount] = {};
+};
@@ -307,7 +307,7 @@ void DirectXBase::CreateRootSignatureParticle()
 	descriptorRangeForInstancing[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
 	// RootParameterの作成
-	D3D12_ROOT_PARAMETER rootParameters[5] = {};
+	D3D12_ROOT_PARAMETER rootParameters[6] = {};
 
 	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; // CBVを使う
 	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL; // PixelShaderで使う
@@ -331,6 +331,11 @@ void DirectXBase::CreateRootSignatureParticle()
 	rootParameters[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 	rootParameters[4].Descriptor.ShaderRegister = 2;
 
+	// ビルボードとビュープロジェクション行列（パーティクルグループで共通）
+	rootParameters[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; // CBVを使う
+	rootParameters[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX; // VertexShaderで使う
+	rootParameters[5].Descriptor.ShaderRegister = 0; // レジスタ番号0とバインド
+
 	descriptionRootSignature.pParameters = rootParameters; // ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters); // 配列の長さ
 
@@ -378,6 +383,16 @@ void DirectXBase::SetInputLayout()
 	inputElementDescs_[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 	inputLayoutDesc_.pInputElementDescs = inputElementDescs_;
 	inputLayoutDesc_.NumElements = _countof(inputElementDescs_);
+
+	// 圧縮した頂点（ModelManager::QuantizedVertexData）用のInputLayout
+	inputElementDescsQuantized_[0] = inputElementDescs_[0];
+	inputElementDescsQuantized_[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+	inputElementDescsQuantized_[1] = inputElementDescs_[1];
+	inputElementDescsQuantized_[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	inputElementDescsQuantized_[2] = inputElementDescs_[2];
+	inputElementDescsQuantized_[2].Format = DXGI_FORMAT_R16G16_SNORM;
+	inputLayoutDescQuantized_.pInputElementDescs = inputElementDescsQuantized_;
+	inputLayoutDescQuantized_.NumElements = _countof(inputElementDescsQuantized_);
 }
 
 D3D12_BLEND_DESC DirectXBase::SetBlendState()
@@ -482,6 +497,10 @@ void DirectXBase::ShaderCompile()
 	pixelShaderBlob_ = CompileShader(L"resources/Shaders/Object3D.PS.hlsl", L"ps_6_0", dxcUtils_, dxcCompiler_, includeHandler_);
 	assert(pixelShaderBlob_ != nullptr);
 
+	// 圧縮した頂点用のVertexShader（PixelShaderは共通）
+	vertexShaderBlobQuantized_ = CompileShader(L"resources/Shaders/Object3dQuantized.VS.hlsl", L"vs_6_0", dxcUtils_, dxcCompiler_, includeHandler_);
+	assert(vertexShaderBlobQuantized_ != nullptr);
+
 	// Particle用Shader
 	vertexShaderBlobParticle_ = CompileShader(L"resources/Shaders/Particle.VS.hlsl", L"vs_6_0", dxcUtils_, dxcCompiler_, includeHandler_);
 	assert(vertexShaderBlobParticle_ != nullptr);
@@ -558,6 +577,26 @@ void DirectXBase::CreatePipelineStateObject()
 	graphicsPipelineStateNoCulling_ = nullptr;
 	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineStateNoCulling_));
 
+	// 圧縮した頂点用のPSOを、選べる全てのPSOについて作成（InputLayoutとVertexShaderだけが違う）
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC quantizedSourceDesc = graphicsPipelineStateDefault;
+	CreateQuantizedPipelineState(quantizedSourceDesc, graphicsPipelineState_.Get());
+	const std::pair<D3D12_BLEND_DESC*, ID3D12PipelineState*> kBlendModes[] = {
+		{ &blendDescNone_, graphicsPipelineStateBlendModeNone_.Get() },
+		{ &blendDescAdd_, graphicsPipelineStateBlendModeAdd_.Get() },
+		{ &blendDescSubtract_, graphicsPipelineStateBlendModeSubtract_.Get() },
+		{ &blendDescMultiply_, graphicsPipelineStateBlendModeMultiply_.Get() },
+		{ &blendDescScreen_, graphicsPipelineStateBlendModeScreen_.Get() },
+	};
+	for (const auto& [blend, pipelineState] : kBlendModes) {
+		quantizedSourceDesc.BlendState = *blend;
+		CreateQuantizedPipelineState(quantizedSourceDesc, pipelineState);
+	}
+	// アウトライン用・カリング無しは、floatの頂点用と同じく最後に設定したBlendStateが残ったdescから作る
+	quantizedSourceDesc.RasterizerState.CullMode = D3D12_CULL_MODE_FRONT;
+	CreateQuantizedPipelineState(quantizedSourceDesc, graphicsPipelineStateOutline_.Get());
+	quantizedSourceDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	CreateQuantizedPipelineState(quantizedSourceDesc, graphicsPipelineStateNoCulling_.Get());
+
 	// パーティクル用PSOを作成
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateParticleDesc = graphicsPipelineStateDefault;
 	graphicsPipelineStateParticleDesc.BlendState = blendDescAdd_;
@@ -569,6 +608,16 @@ void DirectXBase::CreatePipelineStateObject()
 	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateParticleDesc, IID_PPV_ARGS(&graphicsPipelineStateParticle_));
 }
 
+void DirectXBase::CreateQuantizedPipelineState(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, ID3D12PipelineState* pipelineState)
+{
+	desc.InputLayout = inputLayoutDescQuantized_;
+	desc.VS = { vertexShaderBlobQuantized_->GetBufferPointer(), vertexShaderBlobQuantized_->GetBufferSize() }; // VertexShader
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> quantized;
+	HRESULT result = device_->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&quantized));
+	assert(SUCCEEDED(result));
+	quantizedPipelineStates_[pipelineState] = quantized;
+}
+
 void DirectXBase::SetViewport()
 {
 	// クライアント領域のサイズと一緒にして画面全体に表示
@@ -671,6 +720,7 @@ void DirectXBase::EndFrame()
 	assert(SUCCEEDED(result));
 	result = commandList_->Reset(commandAllocator_.Get(), nullptr);
 	assert(SUCCEEDED(result));
+	boundPipelineState_ = nullptr;
 }
 
 void DirectXBase::PreDraw()
@@ -680,7 +730,7 @@ void DirectXBase::PreDraw()
 	commandList_->RSSetScissorRects(1, &scissorRect_); // Scirssorを設定
 	// RootSignatureを設定。PSOに設定しているけど別途設定が必要
 	commandList_->SetGraphicsRootSignature(rootSignature_.Get());
-	commandList_->SetPipelineState((graphicsPipelineState_.Get())); // PSOを設定
+	SetPipelineState(graphicsPipelineState_.Get()); // PSOを設定
 	// 形状を設定。PSOに設定しているものとはまた別。同じものを設定すると考えておければ良い
 	commandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
@@ -740,6 +790,18 @@ ID3D12PipelineState* DirectXBase::GetPipelineStateNoCulling()
 	return graphicsPipelineStateNoCulling_.Get();
 }
 
+void DirectXBase::SetPipelineState(ID3D12PipelineState* pipelineState)
+{
+	commandList_->SetPipelineState(pipelineState);
+	boundPipelineState_ = pipelineState;
+}
+
+ID3D12PipelineState* DirectXBase::GetQuantizedPipelineState(ID3D12PipelineState* pipelineState) const
+{
+	auto it = quantizedPipelineStates_.find(pipelineState);
+	return it != quantizedPipelineStates_.end() ? it->second.Get() : nullptr;
+}
+
 void DirectXBase::InitializeFixFPS()
 {
 	// 現在時間を記録する
@@ -6,6 +6,7 @@
 #include <dxcapi.h>
 #include <dxgidebug.h>
 #include <chrono>
+#include <unordered_map>
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -125,6 +126,8 @@ public:
 	void ShaderCompile();
 	// PSO生成
 	void CreatePipelineStateObject();
+	// descのInputLayoutとVertexShaderを圧縮した頂点用に差し替えたPSOを生成し、pipelineStateに対応付ける
+	void CreateQuantizedPipelineState(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, ID3D12PipelineState* pipelineState);
 	// Viewportの設定
 	void SetViewport();
 	// Scissorの設定
@@ -164,6 +167,15 @@ public:
 	ID3D12PipelineState* GetPipelineStateBlendModeMultiply() { return graphicsPipelineStateBlendModeMultiply_.Get(); };
 	ID3D12PipelineState* GetPipelineStateBlendModeScreen() { return graphicsPipelineStateBlendModeScreen_.Get(); };
 
+	// PSOを設定する（設定したPSOはGetBoundPipelineStateで取得できる）
+	// コマンドリストへのPSOの設定は全てこれを通す
+	void SetPipelineState(ID3D12PipelineState* pipelineState);
+	// 最後にSetPipelineStateで設定したPSO
+	ID3D12PipelineState* GetBoundPipelineState() const { return boundPipelineState_; }
+	// 圧縮した頂点（ModelManager::VertexFormat::Quantized）のモデル用に、InputLayoutとVertexShaderだけを差し替えたPSOを取得
+	// 通常・BlendMode・アウトライン・カリング無しの各PSOに対応するものがある（無ければnullptr）
+	ID3D12PipelineState* GetQuantizedPipelineState(ID3D12PipelineState* pipelineState) const;
+
 	// Particle用ルートシグネチャを取得
 	ID3D12RootSignature* GetRootSignatureParticle() { return rootSignatureParticle_.Get(); }
 	// Particle用PSOを取得
@@ -195,6 +207,8 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignatureParticle_;
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs_[3];
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc_;
+	D3D12_INPUT_ELEMENT_DESC inputElementDescsQuantized_[3];
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDescQuantized_;
 
 	D3D12_BLEND_DESC blendDesc_; // kBlendModeNormal
 	D3D12_BLEND_DESC blendDescNone_; // kBlendModeNone
@@ -212,11 +226,16 @@ private:
 	D3D12_RASTERIZER_DESC rasterizerDesc_;
 	IDxcBlob* vertexShaderBlob_;
 	IDxcBlob* pixelShaderBlob_;
+	IDxcBlob* vertexShaderBlobQuantized_;
 	IDxcBlob* vertexShaderBlobParticle_;
 	IDxcBlob* pixelShaderBlobParticle_;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineStateOutline_;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineStateNoCulling_;
+	// floatの頂点用PSO → 圧縮した頂点用PSO
+	std::unordered_map<ID3D12PipelineState*, Microsoft::WRL::ComPtr<ID3D12PipelineState>> quantizedPipelineStates_;
+	// 最後に設定したPSO
+	ID3D12PipelineState* boundPipelineState_ = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineStateParticle_;
 	D3D12_VIEWPORT viewport_;
 	D3D12_RECT scissorRect_;
@@ -0,0 +1,664 @@
+#include "AABBTree.h"
+#include <cassert>
+#include <algorithm>
+#include <math.h>
+
+namespace {
+	// 葉にまとめる要素数の上限（SAHで分割しない方が安くても、これを超えたら分割する）
+	constexpr int32_t kMaxLeafItems = 4;
+	// SAHの分割候補の数
+	constexpr int32_t kBinCount = 16;
+	// これより深くなったらSAHをやめて要素数で半分に分ける（クエリのスタックを溢れさせないため）
+	constexpr int32_t kMaxSAHDepth = 64;
+	// クエリで使うスタックの大きさ
+	constexpr int32_t kStackSize = 128;
+
+	AABB Union(const AABB& a, const AABB& b)
+	{
+		return AABB{
+			{ (std::min)(a.min.x, b.min.x), (std::min)(a.min.y, b.min.y), (std::min)(a.min.z, b.min.z) },
+			{ (std::max)(a.max.x, b.max.x), (std::max)(a.max.y, b.max.y), (std::max)(a.max.z, b.max.z) },
+		};
+	}
+
+	// 何も含まない範囲（Unionの初期値）
+	AABB EmptyAABB()
+	{
+		return AABB{ { 3.0e38f, 3.0e38f, 3.0e38f }, { -3.0e38f, -3.0e38f, -3.0e38f } };
+	}
+
+	float SurfaceArea(const AABB& aabb)
+	{
+		float x = aabb.max.x - aabb.min.x;
+		float y = aabb.max.y - aabb.min.y;
+		float z = aabb.max.z - aabb.min.z;
+		return 2.0f * (x * y + y * z + z * x);
+	}
+
+	float Axis(const Float3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	// スラブ法でレイとAABBが [0, maxDistance] の範囲で交わるか
+	bool RayHitsAABB(const Float3& origin, const Float3& inverseDirection, float maxDistance, const AABB& aabb)
+	{
+		float t1 = (aabb.min.x - origin.x) * inverseDirection.x;
+		float t2 = (aabb.max.x - origin.x) * inverseDirection.x;
+		float tMin = (std::min)(t1, t2);
+		float tMax = (std::max)(t1, t2);
+
+		t1 = (aabb.min.y - origin.y) * inverseDirection.y;
+		t2 = (aabb.max.y - origin.y) * inverseDirection.y;
+		tMin = (std::max)(tMin, (std::min)(t1, t2));
+		tMax = (std::min)(tMax, (std::max)(t1, t2));
+
+		t1 = (aabb.min.z - origin.z) * inverseDirection.z;
+		t2 = (aabb.max.z - origin.z) * inverseDirection.z;
+		tMin = (std::max)(tMin, (std::min)(t1, t2));
+		tMax = (std::min)(tMax, (std::max)(t1, t2));
+
+		return tMax >= (std::max)(tMin, 0.0f) && tMin <= maxDistance;
+	}
+
+	// 全ての成分が有限か
+	bool IsFinite(const AABB& aabb)
+	{
+		return isfinite(aabb.min.x) && isfinite(aabb.min.y) && isfinite(aabb.min.z) &&
+			isfinite(aabb.max.x) && isfinite(aabb.max.y) && isfinite(aabb.max.z);
+	}
+
+	// 0除算でNaNが出ないように、0の成分は非常に大きな値にする
+	float SafeInverse(float value)
+	{
+		if (value == 0.0f) {
+			return 1.0e30f;
+		}
+		return 1.0f / value;
+	}
+}
+
+int32_t AABBTree::Insert(const AABB& aabb, uint32_t userData)
+{
+	int32_t proxy;
+	if (!freeProxies_.empty()) {
+		proxy = freeProxies_.back();
+		freeProxies_.pop_back();
+	} else {
+		proxy = static_cast<int32_t>(proxies_.size());
+		proxies_.push_back({});
+	}
+	proxies_[proxy] = Proxy{ aabb, userData, -1, -1, -1, true };
+
+	// 無限大を含むものは木に入れない
+	if (!IsFinite(aabb)) {
+		proxies_[proxy].unboundedIndex = static_cast<int32_t>(unboundedItems_.size());
+		unboundedItems_.push_back(Item{ aabb, userData, proxy });
+		return proxy;
+	}
+
+	// 要素1つだけの葉を作って木に加える
+	int32_t itemIndex = AllocateItem();
+	items_[itemIndex] = Item{ aabb, userData, proxy };
+	int32_t leaf = AllocateNode();
+	nodes_[leaf] = Node{ aabb, -1, -1, itemIndex, 1, -1, 0 };
+	proxies_[proxy].itemIndex = itemIndex;
+	proxies_[proxy].leafNode = leaf;
+	InsertLeaf(leaf);
+	return proxy;
+}
+
+void AABBTree::Remove(int32_t proxy)
+{
+	assert(proxy >= 0 && proxy < static_cast<int32_t>(proxies_.size()) && proxies_[proxy].isAlive);
+	Proxy& target = proxies_[proxy];
+
+	if (target.unboundedIndex >= 0) {
+		// 末尾の要素を空いた位置に移す
+		int32_t index = target.unboundedIndex;
+		unboundedItems_[index] = unboundedItems_.back();
+		proxies_[unboundedItems_[index].proxy].unboundedIndex = index;
+		unboundedItems_.pop_back();
+	} else {
+		int32_t leaf = target.leafNode;
+		Node& node = nodes_[leaf];
+		if (node.count > 1) {
+			// 葉の末尾の要素を空いた位置に移し、葉を1つ縮める
+			int32_t last = node.first + node.count - 1;
+			if (target.itemIndex != last) {
+				items_[target.itemIndex] = items_[last];
+				proxies_[items_[target.itemIndex].proxy].itemIndex = target.itemIndex;
+			}
+			freeItems_.push_back(last);
+			--node.count;
+
+			// 高さは変わらないので範囲だけ直す
+			RefitLeaf(node);
+			for (int32_t p = node.parent; p >= 0; p = nodes_[p].parent) {
+				nodes_[p].bounds = Union(nodes_[nodes_[p].left].bounds, nodes_[nodes_[p].right].bounds);
+			}
+		} else {
+			// 葉ごと外す
+			RemoveLeaf(leaf);
+			freeItems_.push_back(target.itemIndex);
+			freeNodes_.push_back(leaf);
+		}
+	}
+
+	target = Proxy{ AABB{}, 0, -1, -1, -1, false };
+	freeProxies_.push_back(proxy);
+}
+
+void AABBTree::Clear()
+{
+	nodes_.clear();
+	root_ = -1;
+	freeNodes_.clear();
+	items_.clear();
+	freeItems_.clear();
+	unboundedItems_.clear();
+	proxies_.clear();
+	freeProxies_.clear();
+}
+
+void AABBTree::Build()
+{
+	nodes_.clear();
+	root_ = -1;
+	freeNodes_.clear();
+	items_.clear();
+	freeItems_.clear();
+	unboundedItems_.clear();
+
+	// 生きている要素を集める（無限大を含むものは木に入れない）
+	std::vector<Float3> centroids;
+	for (int32_t proxy = 0; proxy < static_cast<int32_t>(proxies_.size()); ++proxy) {
+		Proxy& source = proxies_[proxy];
+		source.itemIndex = -1;
+		source.leafNode = -1;
+		source.unboundedIndex = -1;
+		if (!source.isAlive) {
+			continue;
+		}
+		if (!IsFinite(source.bounds)) {
+			source.unboundedIndex = static_cast<int32_t>(unboundedItems_.size());
+			unboundedItems_.push_back(Item{ source.bounds, source.userData, proxy });
+			continue;
+		}
+		items_.push_back(Item{ source.bounds, source.userData, proxy });
+		centroids.push_back({
+			(source.bounds.min.x + source.bounds.max.x) * 0.5f,
+			(source.bounds.min.y + source.bounds.max.y) * 0.5f,
+			(source.bounds.min.z + source.bounds.max.z) * 0.5f });
+	}
+
+	if (items_.empty()) {
+		return;
+	}
+
+	// ノード数は最大で要素数の2倍
+	nodes_.reserve(items_.size() * 2);
+	root_ = BuildRecursive(0, static_cast<int32_t>(items_.size()), -1, centroids);
+
+	// proxyから木の中の位置を引けるようにする
+	for (int32_t itemIndex = 0; itemIndex < static_cast<int32_t>(items_.size()); ++itemIndex) {
+		proxies_[items_[itemIndex].proxy].itemIndex = itemIndex;
+	}
+	for (int32_t nodeIndex = 0; nodeIndex < static_cast<int32_t>(nodes_.size()); ++nodeIndex) {
+		const Node& node = nodes_[nodeIndex];
+		for (int32_t i = 0; i < node.count; ++i) {
+			proxies_[items_[node.first + i].proxy].leafNode = nodeIndex;
+		}
+	}
+}
+
+int32_t AABBTree::BuildRecursive(int32_t first, int32_t count, int32_t parent, std::vector<Float3>& centroids)
+{
+	int32_t nodeIndex = static_cast<int32_t>(nodes_.size());
+	nodes_.push_back(Node{ EmptyAABB(), -1, -1, first, count, parent, 0 });
+
+	// 範囲と、中心点の範囲を求める
+	AABB bounds = EmptyAABB();
+	AABB centroidBounds = EmptyAABB();
+	for (int32_t i = first; i < first + count; ++i) {
+		bounds = Union(bounds, items_[i].bounds);
+		centroidBounds = Union(centroidBounds, AABB{ centroids[i], centroids[i] });
+	}
+	nodes_[nodeIndex].bounds = bounds;
+
+	if (count <= 1) {
+		return nodeIndex;
+	}
+
+	// 親をたどって深さを数える
+	int32_t depth = 0;
+	for (int32_t p = parent; p >= 0; p = nodes_[p].parent) {
+		++depth;
+	}
+
+	// 分割の位置を決める
+	int32_t bestAxis = -1;
+	int32_t bestSplit = 0;
+	float bestCost = static_cast<float>(count); // 葉にしたときのコスト
+
+	if (depth < kMaxSAHDepth) {
+		float parentArea = SurfaceArea(bounds);
+		for (int axis = 0; axis < 3; ++axis) {
+			float axisMin = Axis(centroidBounds.min, axis);
+			float axisExtent = Axis(centroidBounds.max, axis) - axisMin;
+			if (axisExtent <= 0.0f) {
+				continue;
+			}
+
+			// 中心点で区間に振り分ける
+			AABB binBounds[kBinCount];
+			int32_t binCount[kBinCount] = {};
+			for (int32_t bin = 0; bin < kBinCount; ++bin) {
+				binBounds[bin] = EmptyAABB();
+			}
+			float scale = kBinCount / axisExtent;
+			for (int32_t i = first; i < first + count; ++i) {
+				int32_t bin = (std::min)(static_cast<int32_t>((Axis(centroids[i], axis) - axisMin) * scale), kBinCount - 1);
+				binBounds[bin] = Union(binBounds[bin], items_[i].bounds);
+				++binCount[bin];
+			}
+
+			// 右側から累積した面積と数
+			float rightArea[kBinCount];
+			int32_t rightCount[kBinCount];
+			AABB accumulated = EmptyAABB();
+			int32_t accumulatedCount = 0;
+			for (int32_t bin = kBinCount - 1; bin > 0; --bin) {
+				accumulated = Union(accumulated, binBounds[bin]);
+				accumulatedCount += binCount[bin];
+				rightArea[bin] = accumulatedCount ? SurfaceArea(accumulated) : 0.0f;
+				rightCount[bin] = accumulatedCount;
+			}
+
+			// 左側を累積しながら、区間の境目ごとのコストを比べる
+			accumulated = EmptyAABB();
+			accumulatedCount = 0;
+			for (int32_t split = 1; split < kBinCount; ++split) {
+				accumulated = Union(accumulated, binBounds[split - 1]);
+				accumulatedCount += binCount[split - 1];
+				if (accumulatedCount == 0 || rightCount[split] == 0) {
+					continue;
+				}
+				float cost = 1.0f + (SurfaceArea(accumulated) * accumulatedCount + rightArea[split] * rightCount[split]) / parentArea;
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+	}
+
+	// 分割しない方が安く、要素数も少なければ葉にする
+	if (bestAxis < 0 && count <= kMaxLeafItems) {
+		return nodeIndex;
+	}
+
+	int32_t middle = first + count / 2;
+	if (bestAxis >= 0) {
+		// 区間の境目で2つに分ける
+		float axisMin = Axis(centroidBounds.min, bestAxis);
+		float scale = kBinCount / (Axis(centroidBounds.max, bestAxis) - axisMin);
+		int32_t left = first;
+		int32_t right = first + count - 1;
+		while (left <= right) {
+			int32_t bin = (std::min)(static_cast<int32_t>((Axis(centroids[left], bestAxis) - axisMin) * scale), kBinCount - 1);
+			if (bin < bestSplit) {
+				++left;
+			} else {
+				std::swap(items_[left], items_[right]);
+				std::swap(centroids[left], centroids[right]);
+				--right;
+			}
+		}
+		middle = left;
+	}
+	if (middle == first || middle == first + count) {
+		// 分けられなかった（中心点がすべて同じなど）ので要素数で半分にする
+		middle = first + count / 2;
+	}
+
+	// 深さ優先で左、右の順に追加する
+	int32_t leftChild = BuildRecursive(first, middle - first, nodeIndex, centroids);
+	int32_t rightChild = BuildRecursive(middle, first + count - middle, nodeIndex, centroids);
+	Node& node = nodes_[nodeIndex];
+	node.left = leftChild;
+	node.right = rightChild;
+	node.first = -1;
+	node.count = 0;
+	node.height = 1 + (std::max)(nodes_[leftChild].height, nodes_[rightChild].height);
+	return nodeIndex;
+}
+
+void AABBTree::Update(int32_t proxy, const AABB& aabb)
+{
+	SetAABB(proxy, aabb);
+
+	int32_t nodeIndex = proxies_[proxy].leafNode;
+	if (nodeIndex < 0) {
+		return;
+	}
+
+	// 葉から根までの範囲を直す
+	RefitLeaf(nodes_[nodeIndex]);
+	for (int32_t p = nodes_[nodeIndex].parent; p >= 0; p = nodes_[p].parent) {
+		nodes_[p].bounds = Union(nodes_[nodes_[p].left].bounds, nodes_[nodes_[p].right].bounds);
+	}
+}
+
+void AABBTree::SetAABB(int32_t proxy, const AABB& aabb)
+{
+	assert(proxy >= 0 && proxy < static_cast<int32_t>(proxies_.size()) && proxies_[proxy].isAlive);
+	Proxy& target = proxies_[proxy];
+	target.bounds = aabb;
+	if (target.itemIndex >= 0) {
+		assert(IsFinite(aabb));
+		items_[target.itemIndex].bounds = aabb;
+	} else if (target.unboundedIndex >= 0) {
+		assert(!IsFinite(aabb));
+		unboundedItems_[target.unboundedIndex].bounds = aabb;
+	}
+}
+
+void AABBTree::Refit()
+{
+	if (root_ < 0) {
+		return;
+	}
+
+	// 根から親が先に並ぶ順に集め、後ろからたどれば子が先に直る
+	thread_local std::vector<int32_t> order;
+	order.clear();
+	order.push_back(root_);
+	for (size_t i = 0; i < order.size(); ++i) {
+		const Node& node = nodes_[order[i]];
+		if (node.count == 0) {
+			order.push_back(node.left);
+			order.push_back(node.right);
+		}
+	}
+	for (size_t i = order.size(); i-- > 0;) {
+		Node& node = nodes_[order[i]];
+		if (node.count > 0) {
+			RefitLeaf(node);
+		} else {
+			node.bounds = Union(nodes_[node.left].bounds, nodes_[node.right].bounds);
+		}
+	}
+}
+
+void AABBTree::RefitLeaf(Node& node)
+{
+	AABB bounds = EmptyAABB();
+	for (int32_t i = 0; i < node.count; ++i) {
+		bounds = Union(bounds, items_[node.first + i].bounds);
+	}
+	node.bounds = bounds;
+}
+
+int32_t AABBTree::AllocateNode()
+{
+	if (!freeNodes_.empty()) {
+		int32_t nodeIndex = freeNodes_.back();
+		freeNodes_.pop_back();
+		return nodeIndex;
+	}
+	nodes_.push_back({});
+	return static_cast<int32_t>(nodes_.size()) - 1;
+}
+
+int32_t AABBTree::AllocateItem()
+{
+	if (!freeItems_.empty()) {
+		int32_t itemIndex = freeItems_.back();
+		freeItems_.pop_back();
+		return itemIndex;
+	}
+	items_.push_back({});
+	return static_cast<int32_t>(items_.size()) - 1;
+}
+
+void AABBTree::InsertLeaf(int32_t leaf)
+{
+	if (root_ < 0) {
+		root_ = leaf;
+		nodes_[leaf].parent = -1;
+		return;
+	}
+
+	// 表面積の増え方が最も小さくなる兄弟を探す
+	// 子を兄弟にする場合、自分を通るコスト（祖先が広がる分）も加えて比べる
+	AABB leafBounds = nodes_[leaf].bounds;
+	float leafArea = SurfaceArea(leafBounds);
+	int32_t index = root_;
+	while (nodes_[index].count == 0) {
+		const Node& node = nodes_[index];
+		float area = SurfaceArea(node.bounds);
+		float combinedArea = SurfaceArea(Union(node.bounds, leafBounds));
+
+		// ここで新しい親を作るコスト
+		float cost = 2.0f * combinedArea;
+		// これより下に入れる場合に、このノードが広がる分のコスト
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		int32_t children[2] = { node.left, node.right };
+		for (int32_t i = 0; i < 2; ++i) {
+			const Node& child = nodes_[children[i]];
+			float childArea = SurfaceArea(Union(child.bounds, leafBounds));
+			if (child.count == 0) {
+				childArea -= SurfaceArea(child.bounds);
+			} else {
+				childArea = (std::max)(childArea, leafArea);
+			}
+			childCost[i] = childArea + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1]) {
+			break;
+		}
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+
+	// 兄弟と葉をまとめる親を作り、兄弟の位置に置く
+	int32_t sibling = index;
+	int32_t oldParent = nodes_[sibling].parent;
+	int32_t newParent = AllocateNode();
+	nodes_[newParent] = Node{
+		Union(leafBounds, nodes_[sibling].bounds), sibling, leaf, -1, 0, oldParent, nodes_[sibling].height + 1 };
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+	if (oldParent < 0) {
+		root_ = newParent;
+	} else if (nodes_[oldParent].left == sibling) {
+		nodes_[oldParent].left = newParent;
+	} else {
+		nodes_[oldParent].right = newParent;
+	}
+
+	FixUpwards(newParent);
+}
+
+void AABBTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == root_) {
+		root_ = -1;
+		return;
+	}
+
+	// 親を外し、兄弟を親の位置に置く
+	int32_t parent = nodes_[leaf].parent;
+	int32_t grandParent = nodes_[parent].parent;
+	int32_t sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+	nodes_[sibling].parent = grandParent;
+	freeNodes_.push_back(parent);
+
+	if (grandParent < 0) {
+		root_ = sibling;
+		return;
+	}
+	if (nodes_[grandParent].left == parent) {
+		nodes_[grandParent].left = sibling;
+	} else {
+		nodes_[grandParent].right = sibling;
+	}
+	FixUpwards(grandParent);
+}
+
+void AABBTree::FixUpwards(int32_t nodeIndex)
+{
+	while (nodeIndex >= 0) {
+		nodeIndex = Balance(nodeIndex);
+		Node& node = nodes_[nodeIndex];
+		const Node& left = nodes_[node.left];
+		const Node& right = nodes_[node.right];
+		node.bounds = Union(left.bounds, right.bounds);
+		node.height = 1 + (std::max)(left.height, right.height);
+		nodeIndex = node.parent;
+	}
+}
+
+int32_t AABBTree::Balance(int32_t nodeIndex)
+{
+	Node& a = nodes_[nodeIndex];
+	if (a.count > 0 || a.height < 2) {
+		return nodeIndex;
+	}
+
+	int32_t indexB = a.left;
+	int32_t indexC = a.right;
+	Node& b = nodes_[indexB];
+	Node& c = nodes_[indexC];
+	int32_t balance = c.height - b.height;
+	if (-1 <= balance && balance <= 1) {
+		return nodeIndex;
+	}
+
+	// 高い方の子（up）をaの位置に上げ、upの低い方の子をaに渡す
+	bool rotateRight = balance > 1;
+	int32_t indexUp = rotateRight ? indexC : indexB;
+	Node& up = rotateRight ? c : b;
+	Node& other = rotateRight ? b : c;
+	int32_t indexF = up.left;
+	int32_t indexG = up.right;
+	Node& f = nodes_[indexF];
+	Node& g = nodes_[indexG];
+
+	// upをaの親につなぎ替える
+	up.left = nodeIndex;
+	up.parent = a.parent;
+	a.parent = indexUp;
+	if (up.parent < 0) {
+		root_ = indexUp;
+	} else if (nodes_[up.parent].left == nodeIndex) {
+		nodes_[up.parent].left = indexUp;
+	} else {
+		nodes_[up.parent].right = indexUp;
+	}
+
+	// upの高い方の子はupに残し、低い方の子をaに渡す
+	int32_t indexKeep = f.height > g.height ? indexF : indexG;
+	int32_t indexMove = f.height > g.height ? indexG : indexF;
+	Node& keep = nodes_[indexKeep];
+	Node& move = nodes_[indexMove];
+	up.right = indexKeep;
+	if (rotateRight) {
+		a.right = indexMove;
+	} else {
+		a.left = indexMove;
+	}
+	move.parent = nodeIndex;
+
+	a.bounds = Union(other.bounds, move.bounds);
+	a.height = 1 + (std::max)(other.height, move.height);
+	up.bounds = Union(a.bounds, keep.bounds);
+	up.height = 1 + (std::max)(a.height, keep.height);
+	return indexUp;
+}
+
+///
+/// クエリ
+/// ノードの範囲と重なるかをoverlapsで判定し、葉では要素ごとにitemHitsで判定する
+/// 木に入れていない無限大を含む要素は、最後にitemHitsで1つずつ判定する
+///
+
+namespace {
+	template <class Item, class ItemTest>
+	void CollectItems(const std::vector<Item>& items, std::vector<uint32_t>& out, ItemTest itemHits)
+	{
+		for (const Item& item : items) {
+			if (itemHits(item.bounds)) {
+				out.push_back(item.userData);
+			}
+		}
+	}
+
+	template <class Node, class Item, class NodeTest, class ItemTest>
+	void Traverse(const std::vector<Node>& nodes, int32_t root, const std::vector<Item>& items, std::vector<uint32_t>& out, NodeTest overlaps, ItemTest itemHits)
+	{
+		if (root < 0) {
+			return;
+		}
+
+		int32_t stack[kStackSize];
+		int32_t stackSize = 0;
+		stack[stackSize++] = root;
+
+		while (stackSize > 0) {
+			int32_t nodeIndex = stack[--stackSize];
+			const Node& node = nodes[nodeIndex];
+			if (!overlaps(node.bounds)) {
+				continue;
+			}
+
+			if (node.count > 0) {
+				for (int32_t i = node.first; i < node.first + node.count; ++i) {
+					if (itemHits(items[i].bounds)) {
+						out.push_back(items[i].userData);
+					}
+				}
+				continue;
+			}
+
+			assert(stackSize + 2 <= kStackSize);
+			stack[stackSize++] = node.right;
+			stack[stackSize++] = node.left;
+		}
+	}
+}
+
+void AABBTree::QueryPoint(const Float3& point, std::vector<uint32_t>& out) const
+{
+	auto contains = [&point](const AABB& aabb) { return IsCollision(aabb, point); };
+	Traverse(nodes_, root_, items_, out, contains, contains);
+	CollectItems(unboundedItems_, out, contains);
+}
+
+void AABBTree::QueryAABB(const AABB& aabb, std::vector<uint32_t>& out) const
+{
+	auto overlaps = [&aabb](const AABB& other) { return IsCollision(aabb, other); };
+	Traverse(nodes_, root_, items_, out, overlaps, overlaps);
+	CollectItems(unboundedItems_, out, overlaps);
+}
+
+void AABBTree::QueryRay(const Float3& origin, const Float3& direction, float maxDistance, std::vector<uint32_t>& out) const
+{
+	Float3 inverseDirection = { SafeInverse(direction.x), SafeInverse(direction.y), SafeInverse(direction.z) };
+	auto hits = [&](const AABB& aabb) { return RayHitsAABB(origin, inverseDirection, maxDistance, aabb); };
+	Traverse(nodes_, root_, items_, out, hits, hits);
+	// 無限大との演算でNaNになり得るので判定しない
+	CollectItems(unboundedItems_, out, [](const AABB&) { return true; });
+}
+
+void AABBTree::QueryFrustum(const Culling::Planes& planes, std::vector<uint32_t>& out) const
+{
+	auto visible = [&planes](const AABB& aabb) { return Culling::IsVisible(planes, aabb); };
+	Traverse(nodes_, root_, items_, out, visible, visible);
+	// 無限大との演算でNaNになり得るので判定しない
+	CollectItems(unboundedItems_, out, [](const AABB&) { return true; });
+}
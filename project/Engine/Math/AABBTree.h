@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+#include "Culling.h"
+
+// AABBの階層構造（BVH）
+// 登録したAABBを木にまとめ、点・AABB・レイ・視錐台と重なるものを線形探索より少ない判定回数で列挙する
+//
+// ・Insert / Remove はその場で木に反映する（Buildは不要）
+//   Insertは範囲の表面積が最も増えない位置に葉を足し、Removeは葉を外して親を兄弟で置き換える
+//   どちらも祖先の範囲を直しながら、左右の高さの差が1以内になるように回転する
+// ・Buildは登録されている全ての要素からSAH（表面積ヒューリスティック）で木を作り直す
+//   まとめて登録した後など、クエリの回数が多く木の質を上げたいときに呼ぶ（直後はノードが深さ優先順に並ぶ）
+// ・移動だけならUpdate / Refitで木の形を保ったまま範囲を更新できる
+// ・クエリの結果は登録時に渡したuserDataで返す
+// ・無限大を含むAABB（平面や範囲のない力場など）は木に入れず、クエリのたびに個別に判定する
+//   レイと視錐台のクエリでは、これらは判定せず常に結果に含める
+class AABBTree
+{
+public:
+	static constexpr int32_t kNullProxy = -1;
+
+	// AABBを登録し、操作用のproxyを返す
+	int32_t Insert(const AABB& aabb, uint32_t userData);
+	// 登録を解除する
+	void Remove(int32_t proxy);
+	// 全て解除する
+	void Clear();
+
+	// 登録されているAABBからSAHで木を作り直す
+	void Build();
+
+	// proxyのAABBを更新し、祖先ノードの範囲をたどって直す
+	// 有限の範囲と無限大を含む範囲の間で変える場合は、RemoveしてInsertし直すこと
+	void Update(int32_t proxy, const AABB& aabb);
+	// 範囲だけを書き換え、最後にRefitでまとめて直す（多数を動かすとき用）
+	void SetAABB(int32_t proxy, const AABB& aabb);
+	// 全ノードの範囲を子から作り直す
+	void Refit();
+
+	///
+	/// クエリ（結果はoutの末尾に追加する）
+	///
+
+	// 点を含むもの
+	void QueryPoint(const Float3& point, std::vector<uint32_t>& out) const;
+	// AABBと重なるもの
+	void QueryAABB(const AABB& aabb, std::vector<uint32_t>& out) const;
+	// origin + direction * t（0 <= t <= maxDistance）と交わるもの
+	void QueryRay(const Float3& origin, const Float3& direction, float maxDistance, std::vector<uint32_t>& out) const;
+	// 視錐台と重なるもの
+	void QueryFrustum(const Culling::Planes& planes, std::vector<uint32_t>& out) const;
+
+	// 木に含まれている要素数
+	size_t GetItemCount() const { return items_.size() - freeItems_.size() + unboundedItems_.size(); }
+	// ノード数
+	size_t GetNodeCount() const { return nodes_.size() - freeNodes_.size(); }
+	// 根から最も深い葉までの辺の数（要素がなければ-1）
+	int32_t GetHeight() const { return root_ < 0 ? -1 : nodes_[root_].height; }
+
+private:
+	struct Node {
+		AABB bounds;
+		// 内部ノードの子
+		int32_t left;
+		int32_t right;
+		// 葉ならitems_[first, first + count)を持つ（countが0なら内部ノード）
+		int32_t first;
+		int32_t count;
+		int32_t parent;
+		// 葉は0、内部ノードは子の高さの大きい方 + 1
+		int32_t height;
+	};
+
+	// 木の葉が持つ要素
+	struct Item {
+		AABB bounds;
+		uint32_t userData;
+		int32_t proxy;
+	};
+
+	struct Proxy {
+		AABB bounds;
+		uint32_t userData;
+		// items_内の位置（木に入っていなければ-1）
+		int32_t itemIndex;
+		// unboundedItems_内の位置（無限大を含まなければ-1）
+		int32_t unboundedIndex;
+		// 所属する葉ノード
+		int32_t leafNode;
+		bool isAlive;
+	};
+
+	// items_[first, first + count)を部分木にしてnodes_に追加し、そのノード番号を返す
+	int32_t BuildRecursive(int32_t first, int32_t count, int32_t parent, std::vector<Float3>& centroids);
+	// 葉ノードの範囲を要素から作り直す
+	void RefitLeaf(Node& node);
+
+	// 空いているノード・要素の位置を使うか、末尾に追加して返す
+	int32_t AllocateNode();
+	int32_t AllocateItem();
+	// 葉を木に加える / 木から外す（葉のノード自体は解放しない）
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	// nodeIndexから根まで、回転しながら範囲と高さを直す
+	void FixUpwards(int32_t nodeIndex);
+	// nodeIndexを根とする部分木の左右の高さの差が2以上なら回転し、その位置の新しいノードを返す
+	int32_t Balance(int32_t nodeIndex);
+
+	std::vector<Node> nodes_;
+	int32_t root_ = -1;
+	std::vector<int32_t> freeNodes_;
+	// 葉ごとに並べた要素（Removeで空いた位置はfreeItems_に入れ、Insertで使い回す）
+	std::vector<Item> items_;
+	std::vector<int32_t> freeItems_;
+	// 木に入れない、無限大を含む要素
+	std::vector<Item> unboundedItems_;
+	std::vector<Proxy> proxies_;
+	std::vector<int32_t> freeProxies_;
+};
@@ -0,0 +1,203 @@
+#include "Culling.h"
+#include <math.h>
+#include "SimdMath.h"
+
+namespace {
+	// 4要素それぞれについて、いずれかの平面の完全に外側にあるかを求める
+	// 球はradius、AABBはextentX～Z（中心からの半分の大きさ）を渡し、使わない方は0にする
+	Simd::Mask4 OutsideAnyPlane(const Culling::Planes& planes,
+		Simd::Vec4 centerX, Simd::Vec4 centerY, Simd::Vec4 centerZ,
+		Simd::Vec4 radius, Simd::Vec4 extentX, Simd::Vec4 extentY, Simd::Vec4 extentZ)
+	{
+		using namespace Simd;
+
+		Mask4 outside = CmpGt(Zero(), Zero());
+		for (size_t i = 0; i < Frustum::kPlaneCount; ++i) {
+			// 中心から平面までの符号付き距離
+			Vec4 distance = Add(Add(Add(
+				Mul(centerX, Set1(planes.normalX[i])),
+				Mul(centerY, Set1(planes.normalY[i]))),
+				Mul(centerZ, Set1(planes.normalZ[i]))),
+				Set1(planes.distance[i]));
+			// 法線方向への広がり（球なら半径、AABBなら|n|・extent）
+			Vec4 reach = Add(radius, Add(Add(
+				Mul(extentX, Set1(planes.absNormalX[i])),
+				Mul(extentY, Set1(planes.absNormalY[i]))),
+				Mul(extentZ, Set1(planes.absNormalZ[i]))));
+			outside = Or(outside, CmpLt(Add(distance, reach), Zero()));
+		}
+		return outside;
+	}
+
+	// 4要素分の判定結果を書き込み、見える個数を返す
+	size_t WriteVisible(Simd::Mask4 outside, uint8_t* outVisible, size_t numWrite)
+	{
+		uint32_t bits = Simd::MoveMask(outside);
+		size_t numVisible = 0;
+		for (size_t lane = 0; lane < numWrite; ++lane) {
+			uint8_t visible = (bits >> lane) & 1u ? 0 : 1;
+			outVisible[lane] = visible;
+			numVisible += visible;
+		}
+		return numVisible;
+	}
+}
+
+Culling::Planes Culling::MakePlanes(const Frustum& frustum)
+{
+	Planes result;
+	for (size_t i = 0; i < Planes::kCount; ++i) {
+		if (i < Frustum::kPlaneCount) {
+			const Plane& plane = frustum.planes[i];
+			result.normalX[i] = plane.normal.x;
+			result.normalY[i] = plane.normal.y;
+			result.normalZ[i] = plane.normal.z;
+			result.distance[i] = plane.distance;
+		} else {
+			// 余りは法線0・距離が非常に大きい平面にして、常に内側と判定させる
+			result.normalX[i] = 0.0f;
+			result.normalY[i] = 0.0f;
+			result.normalZ[i] = 0.0f;
+			result.distance[i] = 3.0e38f;
+		}
+		result.absNormalX[i] = fabsf(result.normalX[i]);
+		result.absNormalY[i] = fabsf(result.normalY[i]);
+		result.absNormalZ[i] = fabsf(result.normalZ[i]);
+	}
+	return result;
+}
+
+bool Culling::IsVisible(const Planes& planes, const AABB& aabb)
+{
+	using namespace Simd;
+
+	Vec4 centerX = Set1((aabb.min.x + aabb.max.x) * 0.5f);
+	Vec4 centerY = Set1((aabb.min.y + aabb.max.y) * 0.5f);
+	Vec4 centerZ = Set1((aabb.min.z + aabb.max.z) * 0.5f);
+	Vec4 extentX = Set1((aabb.max.x - aabb.min.x) * 0.5f);
+	Vec4 extentY = Set1((aabb.max.y - aabb.min.y) * 0.5f);
+	Vec4 extentZ = Set1((aabb.max.z - aabb.min.z) * 0.5f);
+
+	// 平面を4枚ずつ判定する
+	Mask4 outside = CmpGt(Zero(), Zero());
+	for (size_t i = 0; i < Planes::kCount; i += 4) {
+		Vec4 distance = Add(Add(Add(
+			Mul(centerX, Load(planes.normalX + i)),
+			Mul(centerY, Load(planes.normalY + i))),
+			Mul(centerZ, Load(planes.normalZ + i))),
+			Load(planes.distance + i));
+		Vec4 reach = Add(Add(
+			Mul(extentX, Load(planes.absNormalX + i)),
+			Mul(extentY, Load(planes.absNormalY + i))),
+			Mul(extentZ, Load(planes.absNormalZ + i)));
+		outside = Or(outside, CmpLt(Add(distance, reach), Zero()));
+	}
+	return MoveMask(outside) == 0;
+}
+
+bool Culling::IsVisible(const Planes& planes, const Float3& center, float radius)
+{
+	using namespace Simd;
+
+	Vec4 centerX = Set1(center.x);
+	Vec4 centerY = Set1(center.y);
+	Vec4 centerZ = Set1(center.z);
+	Vec4 reach = Set1(radius);
+
+	Mask4 outside = CmpGt(Zero(), Zero());
+	for (size_t i = 0; i < Planes::kCount; i += 4) {
+		Vec4 distance = Add(Add(Add(
+			Mul(centerX, Load(planes.normalX + i)),
+			Mul(centerY, Load(planes.normalY + i))),
+			Mul(centerZ, Load(planes.normalZ + i))),
+			Load(planes.distance + i));
+		outside = Or(outside, CmpLt(Add(distance, reach), Zero()));
+	}
+	return MoveMask(outside) == 0;
+}
+
+size_t Culling::CullSpheres(const Planes& planes,
+	const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+	size_t count, uint8_t* outVisible)
+{
+	using namespace Simd;
+
+	size_t numVisible = 0;
+	size_t index = 0;
+
+	// 4要素ずつ処理
+	for (; index + 4 <= count; index += 4) {
+		Mask4 outside = OutsideAnyPlane(planes,
+			Load(centerX + index), Load(centerY + index), Load(centerZ + index),
+			Load(radius + index), Zero(), Zero(), Zero());
+		numVisible += WriteVisible(outside, outVisible + index, 4);
+	}
+
+	// 端数は一時配列に詰めて同じ計算で処理する
+	if (index < count) {
+		float tail[4][4] = {};
+		size_t rest = count - index;
+		for (size_t lane = 0; lane < rest; ++lane) {
+			tail[0][lane] = centerX[index + lane];
+			tail[1][lane] = centerY[index + lane];
+			tail[2][lane] = centerZ[index + lane];
+			tail[3][lane] = radius[index + lane];
+		}
+		Mask4 outside = OutsideAnyPlane(planes,
+			Load(tail[0]), Load(tail[1]), Load(tail[2]),
+			Load(tail[3]), Zero(), Zero(), Zero());
+		numVisible += WriteVisible(outside, outVisible + index, rest);
+	}
+
+	return numVisible;
+}
+
+size_t Culling::CullAABBs(const Planes& planes, const AABB* aabbs, size_t count, uint8_t* outVisible)
+{
+	using namespace Simd;
+
+	size_t numVisible = 0;
+	for (size_t index = 0; index < count; index += 4) {
+		// 4つ分の中心と広がりを要素ごとの配列に詰め替える
+		float center[3][4] = {};
+		float extent[3][4] = {};
+		size_t numWrite = count - index < 4 ? count - index : 4;
+		for (size_t lane = 0; lane < numWrite; ++lane) {
+			const AABB& aabb = aabbs[index + lane];
+			center[0][lane] = (aabb.min.x + aabb.max.x) * 0.5f;
+			center[1][lane] = (aabb.min.y + aabb.max.y) * 0.5f;
+			center[2][lane] = (aabb.min.z + aabb.max.z) * 0.5f;
+			extent[0][lane] = (aabb.max.x - aabb.min.x) * 0.5f;
+			extent[1][lane] = (aabb.max.y - aabb.min.y) * 0.5f;
+			extent[2][lane] = (aabb.max.z - aabb.min.z) * 0.5f;
+		}
+		Mask4 outside = OutsideAnyPlane(planes,
+			Load(center[0]), Load(center[1]), Load(center[2]),
+			Zero(), Load(extent[0]), Load(extent[1]), Load(extent[2]));
+		numVisible += WriteVisible(outside, outVisible + index, numWrite);
+	}
+	return numVisible;
+}
+
+AABB Culling::TransformAABB(const AABB& aabb, const Matrix& matrix)
+{
+	// 平行移動から始め、各軸について行列の要素ごとに小さい方・大きい方を足していく
+	AABB result = {
+		{ matrix.r[3][0], matrix.r[3][1], matrix.r[3][2] },
+		{ matrix.r[3][0], matrix.r[3][1], matrix.r[3][2] },
+	};
+	const float sourceMin[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+	const float sourceMax[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+	float* resultMin[3] = { &result.min.x, &result.min.y, &result.min.z };
+	float* resultMax[3] = { &result.max.x, &result.max.y, &result.max.z };
+
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			float a = sourceMin[row] * matrix.r[row][column];
+			float b = sourceMax[row] * matrix.r[row][column];
+			*resultMin[column] += a < b ? a : b;
+			*resultMax[column] += a < b ? b : a;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+#include "Frustum.h"
+
+// 視錐台カリング
+// 平面を要素ごとの配列に並べ替えておき、SIMDで判定する
+// ・1つの物体に対しては、6平面を4つずつまとめて判定
+// ・大量の物体に対しては、物体を4つずつまとめて平面ごとに判定
+class Culling
+{
+public:
+	// 判定用に並べ替えた平面。7, 8枚目は常に内側と判定されるダミー
+	struct Planes {
+		static constexpr size_t kCount = 8;
+
+		float normalX[kCount];
+		float normalY[kCount];
+		float normalZ[kCount];
+		float distance[kCount];
+		// AABBの判定用に法線の絶対値を持っておく
+		float absNormalX[kCount];
+		float absNormalY[kCount];
+		float absNormalZ[kCount];
+	};
+
+	// Frustumから判定用の平面を作る
+	static Planes MakePlanes(const Frustum& frustum);
+
+	// 1つのAABBが見えるか（一部でも視錐台に入っていればtrue）
+	static bool IsVisible(const Planes& planes, const AABB& aabb);
+	// 1つの球が見えるか
+	static bool IsVisible(const Planes& planes, const Float3& center, float radius);
+
+	// count個の球を判定し、outVisible[i]に1（見える）か0（見えない）を書き込む
+	// 戻り値は見える個数
+	static size_t CullSpheres(const Planes& planes,
+		const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+		size_t count, uint8_t* outVisible);
+
+	// count個のAABBを判定し、outVisible[i]に1（見える）か0（見えない）を書き込む
+	// 戻り値は見える個数
+	static size_t CullAABBs(const Planes& planes, const AABB* aabbs, size_t count, uint8_t* outVisible);
+
+	// AABBを行列で変換し、それを囲むAABBを求める
+	static AABB TransformAABB(const AABB& aabb, const Matrix& matrix);
+};
@@ -34,6 +34,20 @@ struct Float3
         return { vec.x * scalar, vec.y * scalar, vec.z * scalar };
     }
 
+    ///
+    /// 比較演算子のオーバーロード
+    /// 
+
+    bool operator==(const Float3& other) const
+    {
+        return x == other.x && y == other.y && z == other.z;
+    }
+
+    bool operator!=(const Float3& other) const
+    {
+        return !(*this == other);
+    }
+
     ///
     /// 複合代入演算子のオーバーロード
     /// 
@@ -0,0 +1,36 @@
+#include "Frustum.h"
+#include <math.h>
+
+namespace {
+	// 行列の列どうしを足し引きした係数から平面を作り、法線を正規化する
+	Plane MakePlane(float a, float b, float c, float d)
+	{
+		float length = sqrtf(a * a + b * b + c * c);
+		float inv = length > 0.0f ? 1.0f / length : 0.0f;
+		return Plane{ { a * inv, b * inv, c * inv }, d * inv };
+	}
+}
+
+Frustum Frustum::FromViewProjection(const Matrix& m)
+{
+	// 行ベクトル（v * M）なので、クリップ座標の各成分は行列の列との内積になる
+	// D3Dのクリップ空間（-w <= x,y <= w, 0 <= z <= w）の各不等式がそれぞれの平面になる
+	Frustum frustum;
+	frustum.planes[kLeft] = MakePlane(m.r[0][3] + m.r[0][0], m.r[1][3] + m.r[1][0], m.r[2][3] + m.r[2][0], m.r[3][3] + m.r[3][0]);
+	frustum.planes[kRight] = MakePlane(m.r[0][3] - m.r[0][0], m.r[1][3] - m.r[1][0], m.r[2][3] - m.r[2][0], m.r[3][3] - m.r[3][0]);
+	frustum.planes[kBottom] = MakePlane(m.r[0][3] + m.r[0][1], m.r[1][3] + m.r[1][1], m.r[2][3] + m.r[2][1], m.r[3][3] + m.r[3][1]);
+	frustum.planes[kTop] = MakePlane(m.r[0][3] - m.r[0][1], m.r[1][3] - m.r[1][1], m.r[2][3] - m.r[2][1], m.r[3][3] - m.r[3][1]);
+	frustum.planes[kNear] = MakePlane(m.r[0][2], m.r[1][2], m.r[2][2], m.r[3][2]);
+	frustum.planes[kFar] = MakePlane(m.r[0][3] - m.r[0][2], m.r[1][3] - m.r[1][2], m.r[2][3] - m.r[2][2], m.r[3][3] - m.r[3][2]);
+	return frustum;
+}
+
+bool Frustum::Contains(const Float3& point) const
+{
+	for (const Plane& plane : planes) {
+		if (plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z + plane.distance < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
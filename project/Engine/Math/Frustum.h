@@ -0,0 +1,30 @@
+#pragma once
+#include "Float3.h"
+#include "Matrix.h"
+
+// 平面（dot(normal, p) + distance = 0）
+struct Plane {
+	Float3 normal;
+	float distance;
+};
+
+// 視錐台。各平面の法線は内側を向いている
+struct Frustum {
+	enum {
+		kLeft,
+		kRight,
+		kBottom,
+		kTop,
+		kNear,
+		kFar,
+		kPlaneCount
+	};
+
+	Plane planes[kPlaneCount];
+
+	// ビュープロジェクション行列から6平面を取り出す（法線は正規化済み）
+	static Frustum FromViewProjection(const Matrix& viewProjection);
+
+	// 点が視錐台の内側にあるか
+	bool Contains(const Float3& point) const;
+};
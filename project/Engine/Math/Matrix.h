@@ -24,6 +24,12 @@ public:
 	///
 	/// Operators
 	/// 
+	/// 逆行列（単項マイナス）は SimdMath.h で選択されたバックエンドで計算する。
+	/// 加減算・乗算はスカラーの式の方が速かったため、バックエンドによらずスカラーで計算する（Matrix.cpp を参照）。
+	/// SIMD版はスカラー版と同じ演算順序で計算しているため、FMAを使わない限り結果はビット単位で一致する。
+	/// コンパイラがFMAに縮約した場合でも、誤差は各要素あたり数ULP（相対誤差 1e-6 程度）に収まる。
+	/// MATH_NO_SIMD を定義するとスカラー実装に切り替わる
+	/// 
 
 	Matrix operator - () const;
 
@@ -43,6 +49,14 @@ public:
 
 	static Matrix Inverse(Matrix m);
 
+	// アフィン変換行列（4列目が(0,0,0,1)）の逆行列
+	// 左上3x3だけを余因子で反転し、平行移動は反転した3x3で打ち消す
+	static Matrix InverseAffine(const Matrix& m);
+
+	// 回転と平行移動だけで構成された行列の逆行列
+	// 回転部分を転置し、平行移動を打ち消すだけで求まる
+	static Matrix InverseRigid(const Matrix& m);
+
 	static Matrix PerspectiveFovLH(float fov, float aspectRatio, float nearZ, float farZ);
 
 	static Matrix Orthographic(float width, float height, float nearClip, float farClip);
@@ -60,5 +74,9 @@ public:
 	static Matrix Roll(float rad);
 
 	static Matrix RotationRollPitchYaw(float roll, float pitch, float yaw);
+
+	// Scaling(scale) * RotationRollPitchYaw(rotate.z, rotate.x, rotate.y) * Translation(translate)
+	// 行列の積を使わず、展開した式で直接生成する
+	static Matrix Affine(Float3 scale, Float3 rotate, Float3 translate);
 };
 
@@ -4,6 +4,7 @@
 #include "Float4.h"
 #include "Matrix3x3.h"
 #include "Matrix.h"
+#include "Quaternion.h"
 #include "Transform.h"
 
 static constexpr double PI = 3.14159265359;
@@ -27,4 +28,12 @@ static bool IsCollision(const AABB& aabb, const Float3& point)
     }
 
     return false;
+}
+
+// AABB同士の衝突判定（境界を含む）
+static bool IsCollision(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+        a.min.y <= b.max.y && b.min.y <= a.max.y &&
+        a.min.z <= b.max.z && b.min.z <= a.max.z;
 }
\ No newline at end of file
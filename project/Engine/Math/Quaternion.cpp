@@ -0,0 +1,146 @@
+#include "Quaternion.h"
+#include <math.h>
+
+Quaternion Quaternion::operator*(const Quaternion& q) const
+{
+	// ハミルトン積 q * this（thisで回転してからqで回転）
+	return Quaternion{
+		q.w * x + q.x * w + q.y * z - q.z * y,
+		q.w * y - q.x * z + q.y * w + q.z * x,
+		q.w * z + q.x * y - q.y * x + q.z * w,
+		q.w * w - q.x * x - q.y * y - q.z * z,
+	};
+}
+
+Quaternion& Quaternion::operator*=(const Quaternion& q)
+{
+	*this = *this * q;
+	return *this;
+}
+
+Quaternion Quaternion::Identity()
+{
+	return Quaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Quaternion Quaternion::MakeRotateAxisAngle(const Float3& axis, float angle)
+{
+	float s = sinf(angle * 0.5f);
+	return Quaternion{ axis.x * s, axis.y * s, axis.z * s, cosf(angle * 0.5f) };
+}
+
+Quaternion Quaternion::RotationRollPitchYaw(float roll, float pitch, float yaw)
+{
+	float sr = sinf(roll * 0.5f), cr = cosf(roll * 0.5f);
+	float sp = sinf(pitch * 0.5f), cp = cosf(pitch * 0.5f);
+	float sy = sinf(yaw * 0.5f), cy = cosf(yaw * 0.5f);
+
+	// Roll(z) * Pitch(x) * Yaw(y) の順にかけた結果を展開した式
+	return Quaternion{
+		cy * sp * cr + sy * cp * sr,
+		sy * cp * cr - cy * sp * sr,
+		cy * cp * sr - sy * sp * cr,
+		cy * cp * cr + sy * sp * sr,
+	};
+}
+
+float Quaternion::Dot(const Quaternion& q0, const Quaternion& q1)
+{
+	return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+}
+
+float Quaternion::Length(const Quaternion& q)
+{
+	return sqrtf(Dot(q, q));
+}
+
+Quaternion Quaternion::Normalize(const Quaternion& q)
+{
+	float length = Length(q);
+	if (length == 0.0f) {
+		return Identity();
+	}
+	float inv = 1.0f / length;
+	return Quaternion{ q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+Quaternion Quaternion::Conjugate(const Quaternion& q)
+{
+	return Quaternion{ -q.x, -q.y, -q.z, q.w };
+}
+
+Quaternion Quaternion::Inverse(const Quaternion& q)
+{
+	float lengthSq = Dot(q, q);
+	if (lengthSq == 0.0f) {
+		return Identity();
+	}
+	float inv = 1.0f / lengthSq;
+	return Quaternion{ -q.x * inv, -q.y * inv, -q.z * inv, q.w * inv };
+}
+
+Quaternion Quaternion::Slerp(const Quaternion& q0, const Quaternion& q1, float t)
+{
+	// 最短経路で補間するため、内積が負ならq1を反転する
+	float dot = Dot(q0, q1);
+	Quaternion end = q1;
+	if (dot < 0.0f) {
+		end = Quaternion{ -q1.x, -q1.y, -q1.z, -q1.w };
+		dot = -dot;
+	}
+
+	// ほぼ同じ向きならsinθが0に近く不安定になるのでNlerpで代用
+	if (dot > 0.9995f) {
+		return Nlerp(q0, end, t);
+	}
+
+	float theta = acosf(dot);
+	float invSin = 1.0f / sinf(theta);
+	float scale0 = sinf((1.0f - t) * theta) * invSin;
+	float scale1 = sinf(t * theta) * invSin;
+
+	return Quaternion{
+		scale0 * q0.x + scale1 * end.x,
+		scale0 * q0.y + scale1 * end.y,
+		scale0 * q0.z + scale1 * end.z,
+		scale0 * q0.w + scale1 * end.w,
+	};
+}
+
+Quaternion Quaternion::Nlerp(const Quaternion& q0, const Quaternion& q1, float t)
+{
+	// 最短経路で補間するため、内積が負ならq1を反転する
+	float sign = Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+	float scale0 = 1.0f - t;
+	float scale1 = t * sign;
+
+	return Normalize(Quaternion{
+		scale0 * q0.x + scale1 * q1.x,
+		scale0 * q0.y + scale1 * q1.y,
+		scale0 * q0.z + scale1 * q1.z,
+		scale0 * q0.w + scale1 * q1.w,
+	});
+}
+
+Float3 Quaternion::RotateVector(const Float3& vector, const Quaternion& q)
+{
+	// v' = v + 2w(u×v) + 2u×(u×v)
+	Float3 u = { q.x, q.y, q.z };
+	Float3 uv = { u.y * vector.z - u.z * vector.y, u.z * vector.x - u.x * vector.z, u.x * vector.y - u.y * vector.x };
+	Float3 uuv = { u.y * uv.z - u.z * uv.y, u.z * uv.x - u.x * uv.z, u.x * uv.y - u.y * uv.x };
+	return vector + uv * (2.0f * q.w) + uuv * 2.0f;
+}
+
+Matrix Quaternion::MakeRotateMatrix() const
+{
+	float xx = x * x, yy = y * y, zz = z * z;
+	float xy = x * y, xz = x * z, yz = y * z;
+	float wx = w * x, wy = w * y, wz = w * z;
+
+	return Matrix(
+		1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f,
+		2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f,
+		2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
+}
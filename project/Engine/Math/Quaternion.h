@@ -0,0 +1,50 @@
+#pragma once
+#include "Float3.h"
+#include "Matrix.h"
+
+// 回転を表すクォータニオン
+// 乗算の順序はMatrixと揃えてあり、a * b は「aで回転してからbで回転」を表す
+// （MakeRotateMatrix(a * b) == MakeRotateMatrix(a) * MakeRotateMatrix(b)）
+struct Quaternion
+{
+	float x;
+	float y;
+	float z;
+	float w;
+
+	///
+	/// Operators
+	///
+
+	Quaternion operator*(const Quaternion& q) const;
+	Quaternion& operator*=(const Quaternion& q);
+
+	///
+	/// Functions
+	///
+
+	static Quaternion Identity();
+
+	// 任意軸回転（axisは正規化済みであること）
+	static Quaternion MakeRotateAxisAngle(const Float3& axis, float angle);
+
+	// Matrix::RotationRollPitchYaw と同じ回転を表すクォータニオン
+	static Quaternion RotationRollPitchYaw(float roll, float pitch, float yaw);
+
+	static float Dot(const Quaternion& q0, const Quaternion& q1);
+	static float Length(const Quaternion& q);
+	static Quaternion Normalize(const Quaternion& q);
+	static Quaternion Conjugate(const Quaternion& q);
+	static Quaternion Inverse(const Quaternion& q);
+
+	// 球面線形補間（最短経路）。角度が小さい場合はNlerpに切り替える
+	static Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+	// 正規化線形補間（最短経路）。Slerpより安価で、アニメーションのブレンドに向く
+	static Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+	// ベクトルを回転させる
+	static Float3 RotateVector(const Float3& vector, const Quaternion& q);
+
+	// 回転行列を生成する（正規化済みであること）
+	Matrix MakeRotateMatrix() const;
+};
@@ -0,0 +1,212 @@
+#include "Random.h"
+#include <atomic>
+#include <random>
+#include "SimdMath.h"
+
+namespace {
+	// シードを状態に広げるためのsplitmix64
+	uint64_t SplitMix64(uint64_t& x)
+	{
+		uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	// 上位24bitを [0, 1) のfloatにする係数
+	constexpr float kToUnitFloat = 1.0f / 16777216.0f;
+
+	///
+	/// 4系列分のxoshiro128+（32bit整数4つ）の演算
+	///
+
+#if defined(MATH_SIMD_SSE)
+	using UInt4 = __m128i;
+
+	inline UInt4 LoadUInt4(const uint32_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+	inline void StoreUInt4(uint32_t* p, UInt4 a) { _mm_store_si128(reinterpret_cast<__m128i*>(p), a); }
+	inline UInt4 AddUInt4(UInt4 a, UInt4 b) { return _mm_add_epi32(a, b); }
+	inline UInt4 XorUInt4(UInt4 a, UInt4 b) { return _mm_xor_si128(a, b); }
+	template<int kShift> inline UInt4 ShiftLeftUInt4(UInt4 a) { return _mm_slli_epi32(a, kShift); }
+	template<int kShift> inline UInt4 RotateLeftUInt4(UInt4 a) { return _mm_or_si128(_mm_slli_epi32(a, kShift), _mm_srli_epi32(a, 32 - kShift)); }
+	// 上位24bitを [0, 1) のfloatにする
+	inline Simd::Vec4 ToUnitFloat4(UInt4 a) { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), _mm_set1_ps(kToUnitFloat)); }
+#elif defined(MATH_SIMD_NEON)
+	using UInt4 = uint32x4_t;
+
+	inline UInt4 LoadUInt4(const uint32_t* p) { return vld1q_u32(p); }
+	inline void StoreUInt4(uint32_t* p, UInt4 a) { vst1q_u32(p, a); }
+	inline UInt4 AddUInt4(UInt4 a, UInt4 b) { return vaddq_u32(a, b); }
+	inline UInt4 XorUInt4(UInt4 a, UInt4 b) { return veorq_u32(a, b); }
+	template<int kShift> inline UInt4 ShiftLeftUInt4(UInt4 a) { return vshlq_n_u32(a, kShift); }
+	template<int kShift> inline UInt4 RotateLeftUInt4(UInt4 a) { return vorrq_u32(vshlq_n_u32(a, kShift), vshrq_n_u32(a, 32 - kShift)); }
+	inline Simd::Vec4 ToUnitFloat4(UInt4 a) { return vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(a, 8)), vdupq_n_f32(kToUnitFloat)); }
+#else
+	struct UInt4 {
+		uint32_t v[4];
+	};
+
+	inline UInt4 LoadUInt4(const uint32_t* p) { return { { p[0], p[1], p[2], p[3] } }; }
+	inline void StoreUInt4(uint32_t* p, UInt4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+	inline UInt4 AddUInt4(UInt4 a, UInt4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	inline UInt4 XorUInt4(UInt4 a, UInt4 b) { return { { a.v[0] ^ b.v[0], a.v[1] ^ b.v[1], a.v[2] ^ b.v[2], a.v[3] ^ b.v[3] } }; }
+	template<int kShift> inline UInt4 ShiftLeftUInt4(UInt4 a)
+	{
+		return { { a.v[0] << kShift, a.v[1] << kShift, a.v[2] << kShift, a.v[3] << kShift } };
+	}
+	template<int kShift> inline UInt4 RotateLeftUInt4(UInt4 a)
+	{
+		UInt4 result;
+		for (int32_t i = 0; i < 4; ++i) {
+			result.v[i] = (a.v[i] << kShift) | (a.v[i] >> (32 - kShift));
+		}
+		return result;
+	}
+	inline Simd::Vec4 ToUnitFloat4(UInt4 a)
+	{
+		Simd::Vec4 result;
+		for (int32_t i = 0; i < 4; ++i) {
+			result.v[i] = static_cast<float>(a.v[i] >> 8) * kToUnitFloat;
+		}
+		return result;
+	}
+#endif
+
+	// xoshiro128+ を1回進め、進める前の状態から出力を返す
+	inline UInt4 Step(UInt4& s0, UInt4& s1, UInt4& s2, UInt4& s3)
+	{
+		UInt4 result = AddUInt4(s0, s3);
+		UInt4 t = ShiftLeftUInt4<9>(s1);
+		s2 = XorUInt4(s2, s0);
+		s3 = XorUInt4(s3, s1);
+		s1 = XorUInt4(s1, s2);
+		s0 = XorUInt4(s0, s3);
+		s2 = XorUInt4(s2, t);
+		s3 = RotateLeftUInt4<11>(s3);
+		return result;
+	}
+}
+
+Random::Random(uint64_t seed)
+{
+	Seed(seed);
+}
+
+void Random::Seed(uint64_t seed)
+{
+	// 系列ごとに128bitずつsplitmix64で埋める（全て0の状態にはならない）
+	uint64_t x = seed;
+	for (size_t lane = 0; lane < kLaneCount; ++lane) {
+		uint64_t a = SplitMix64(x);
+		uint64_t b = SplitMix64(x);
+		state_[0][lane] = static_cast<uint32_t>(a);
+		state_[1][lane] = static_cast<uint32_t>(a >> 32);
+		state_[2][lane] = static_cast<uint32_t>(b);
+		state_[3][lane] = static_cast<uint32_t>(b >> 32);
+	}
+	bufferIndex_ = kLaneCount;
+}
+
+void Random::Jump()
+{
+	// xoshiro128+ の2^64回分のジャンプ多項式
+	static constexpr uint32_t kJump[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+	UInt4 s0 = LoadUInt4(state_[0]), s1 = LoadUInt4(state_[1]), s2 = LoadUInt4(state_[2]), s3 = LoadUInt4(state_[3]);
+	alignas(16) const uint32_t zero[kLaneCount] = {};
+	UInt4 j0 = LoadUInt4(zero), j1 = j0, j2 = j0, j3 = j0;
+	for (uint32_t jump : kJump) {
+		for (uint32_t bit = 0; bit < 32; ++bit) {
+			if (jump & (1u << bit)) {
+				j0 = XorUInt4(j0, s0);
+				j1 = XorUInt4(j1, s1);
+				j2 = XorUInt4(j2, s2);
+				j3 = XorUInt4(j3, s3);
+			}
+			Step(s0, s1, s2, s3);
+		}
+	}
+	StoreUInt4(state_[0], j0);
+	StoreUInt4(state_[1], j1);
+	StoreUInt4(state_[2], j2);
+	StoreUInt4(state_[3], j3);
+	bufferIndex_ = kLaneCount;
+}
+
+void Random::Next4(uint32_t* out)
+{
+	UInt4 s0 = LoadUInt4(state_[0]), s1 = LoadUInt4(state_[1]), s2 = LoadUInt4(state_[2]), s3 = LoadUInt4(state_[3]);
+	alignas(16) uint32_t result[kLaneCount];
+	StoreUInt4(result, Step(s0, s1, s2, s3));
+	StoreUInt4(state_[0], s0);
+	StoreUInt4(state_[1], s1);
+	StoreUInt4(state_[2], s2);
+	StoreUInt4(state_[3], s3);
+	for (size_t lane = 0; lane < kLaneCount; ++lane) {
+		out[lane] = result[lane];
+	}
+}
+
+uint32_t Random::NextUInt()
+{
+	// 4系列分をまとめて作り、1つずつ取り出す
+	if (bufferIndex_ == kLaneCount) {
+		Next4(buffer_);
+		bufferIndex_ = 0;
+	}
+	return buffer_[bufferIndex_++];
+}
+
+float Random::NextFloat()
+{
+	return static_cast<float>(NextUInt() >> 8) * kToUnitFloat;
+}
+
+float Random::Range(float min, float max)
+{
+	return min + NextFloat() * (max - min);
+}
+
+void Random::FillUniform(float* out, size_t count, float min, float max)
+{
+	UInt4 s0 = LoadUInt4(state_[0]), s1 = LoadUInt4(state_[1]), s2 = LoadUInt4(state_[2]), s3 = LoadUInt4(state_[3]);
+	Simd::Vec4 offset = Simd::Set1(min);
+	Simd::Vec4 width = Simd::Set1(max - min);
+
+	// 4つずつ、状態をレジスタに置いたまま進める
+	size_t i = 0;
+	for (; i + kLaneCount <= count; i += kLaneCount) {
+		Simd::Store(out + i, Simd::MulAdd(ToUnitFloat4(Step(s0, s1, s2, s3)), width, offset));
+	}
+	// 端数は一時配列に書き込んでから必要な分だけ写す
+	if (i < count) {
+		float tail[kLaneCount];
+		Simd::Store(tail, Simd::MulAdd(ToUnitFloat4(Step(s0, s1, s2, s3)), width, offset));
+		for (size_t lane = 0; i < count; ++i, ++lane) {
+			out[i] = tail[lane];
+		}
+	}
+
+	StoreUInt4(state_[0], s0);
+	StoreUInt4(state_[1], s1);
+	StoreUInt4(state_[2], s2);
+	StoreUInt4(state_[3], s3);
+}
+
+Random Random::MakeStream(uint64_t seed, uint32_t streamIndex)
+{
+	Random random(seed);
+	for (uint32_t i = 0; i < streamIndex; ++i) {
+		random.Jump();
+	}
+	return random;
+}
+
+Random& Random::ThreadLocal()
+{
+	// 全スレッドで共通のシードから、作られた順に別の系列を割り当てる
+	static const uint64_t seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+	static std::atomic<uint32_t> nextStream = 0;
+	thread_local Random random = MakeStream(seed, nextStream.fetch_add(1));
+	return random;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 高速な乱数生成器（xoshiro128+ を4系列並べたもの）
+// ・FillUniformは4系列をSIMDで同時に進め、配列をまとめて埋める
+// ・NextFloatなどの1つずつ取り出す関数も同じ4系列から順に取り出す
+// ・スレッドごとに別の系列を使う場合は MakeStream か ThreadLocal を使う（Randomはスレッドセーフではない）
+class Random
+{
+public:
+	// 系列の数（SIMDの幅）
+	static constexpr size_t kLaneCount = 4;
+
+	explicit Random(uint64_t seed = 0);
+
+	// シードから状態を作り直す
+	void Seed(uint64_t seed);
+
+	// 全ての系列を2^64回分進める（重ならない系列を作る用）
+	void Jump();
+
+	// 32bitの一様乱数
+	uint32_t NextUInt();
+	// [0, 1) の一様乱数
+	float NextFloat();
+	// [min, max) の一様乱数
+	float Range(float min, float max);
+
+	// out[0]～out[count - 1] を [min, max) の一様乱数で埋める
+	void FillUniform(float* out, size_t count, float min, float max);
+
+	// seedの系列からstreamIndex回Jumpした系列を作る
+	// 同じseedでstreamIndexが異なる系列同士は、2^64回分は重ならない
+	static Random MakeStream(uint64_t seed, uint32_t streamIndex);
+
+	// 呼び出したスレッド専用の乱数（初めて呼んだときに、スレッドごとに別の系列で作られる）
+	static Random& ThreadLocal();
+
+private:
+	// 4系列分の状態を1回進め、それぞれの出力をoutに書き込む
+	void Next4(uint32_t* out);
+
+	// state_[i][lane] が lane番目の系列の i番目の状態
+	alignas(16) uint32_t state_[4][kLaneCount];
+
+	// NextUIntで取り出す前の出力
+	uint32_t buffer_[kLaneCount];
+	size_t bufferIndex_ = kLaneCount;
+};
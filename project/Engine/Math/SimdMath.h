@@ -0,0 +1,368 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+///
+/// SIMDバックエンドの選択（コンパイル時）
+///
+/// MATH_SIMD_SSE    : x64 / SSE2以上（MSVCのx64では常に有効）
+/// MATH_SIMD_AVX    : /arch:AVX 以上でビルドした場合に追加で有効
+/// MATH_SIMD_NEON   : ARM64 / NEON
+/// MATH_SIMD_SCALAR : 上記以外、または MATH_NO_SIMD を定義した場合のフォールバック
+///
+/// どのバックエンドでも Simd::Vec4 と同じ関数群を提供するので、
+/// 呼び出し側はバックエンドを意識せずに4要素単位の演算を書ける
+///
+
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SIMD_SSE 1
+#include <immintrin.h>
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#endif
+#elif !defined(MATH_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define MATH_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define MATH_SIMD_SCALAR 1
+#endif
+
+namespace Simd
+{
+#if defined(MATH_SIMD_SSE)
+	using Vec4 = __m128;
+	using Mask4 = __m128;
+#elif defined(MATH_SIMD_NEON)
+	using Vec4 = float32x4_t;
+	using Mask4 = uint32x4_t;
+#else
+	struct Vec4 {
+		float v[4];
+	};
+	struct Mask4 {
+		bool v[4];
+	};
+#endif
+
+	// 非アラインのfloat4つを読み込む
+	inline Vec4 Load(const float* p)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_loadu_ps(p);
+#elif defined(MATH_SIMD_NEON)
+		return vld1q_f32(p);
+#else
+		return { { p[0], p[1], p[2], p[3] } };
+#endif
+	}
+
+	// 非アラインのfloat4つに書き込む
+	inline void Store(float* p, Vec4 a)
+	{
+#if defined(MATH_SIMD_SSE)
+		_mm_storeu_ps(p, a);
+#elif defined(MATH_SIMD_NEON)
+		vst1q_f32(p, a);
+#else
+		p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+#endif
+	}
+
+	// 全要素に同じ値を設定
+	inline Vec4 Set1(float s)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_set1_ps(s);
+#elif defined(MATH_SIMD_NEON)
+		return vdupq_n_f32(s);
+#else
+		return { { s, s, s, s } };
+#endif
+	}
+
+	inline Vec4 Zero()
+	{
+		return Set1(0.0f);
+	}
+
+	inline Vec4 Add(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_add_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vaddq_f32(a, b);
+#else
+		return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+#endif
+	}
+
+	inline Vec4 Sub(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_sub_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vsubq_f32(a, b);
+#else
+		return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+#endif
+	}
+
+	inline Vec4 Mul(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_mul_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vmulq_f32(a, b);
+#else
+		return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+#endif
+	}
+
+	inline Vec4 Div(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_div_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vdivq_f32(a, b);
+#else
+		return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+#endif
+	}
+
+	inline Vec4 Sqrt(Vec4 a)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_sqrt_ps(a);
+#elif defined(MATH_SIMD_NEON)
+		return vsqrtq_f32(a);
+#else
+		return { { sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) } };
+#endif
+	}
+
+	// a * b + c
+	// スカラー版と結果を揃えるため、FMAは使わずに乗算と加算を分けて行う
+	inline Vec4 MulAdd(Vec4 a, Vec4 b, Vec4 c)
+	{
+		return Add(Mul(a, b), c);
+	}
+
+	inline Vec4 Min(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_min_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vminq_f32(a, b);
+#else
+		return { { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] } };
+#endif
+	}
+
+	inline Vec4 Max(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_max_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vmaxq_f32(a, b);
+#else
+		return { { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] } };
+#endif
+	}
+
+	// 最も近い整数に丸める（|a| < 2^31 の範囲を想定）
+	inline Vec4 Round(Vec4 a)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_cvtepi32_ps(_mm_cvtps_epi32(a));
+#elif defined(MATH_SIMD_NEON)
+		return vrndnq_f32(a);
+#else
+		return { { nearbyintf(a.v[0]), nearbyintf(a.v[1]), nearbyintf(a.v[2]), nearbyintf(a.v[3]) } };
+#endif
+	}
+
+	// a > b の要素ごとの比較
+	inline Mask4 CmpGt(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_cmpgt_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vcgtq_f32(a, b);
+#else
+		return { { a.v[0] > b.v[0], a.v[1] > b.v[1], a.v[2] > b.v[2], a.v[3] > b.v[3] } };
+#endif
+	}
+
+	// a < b の要素ごとの比較
+	inline Mask4 CmpLt(Vec4 a, Vec4 b)
+	{
+		return CmpGt(b, a);
+	}
+
+	// a >= b の要素ごとの比較
+	inline Mask4 CmpGe(Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_cmpge_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vcgeq_f32(a, b);
+#else
+		return { { a.v[0] >= b.v[0], a.v[1] >= b.v[1], a.v[2] >= b.v[2], a.v[3] >= b.v[3] } };
+#endif
+	}
+
+	// a <= b の要素ごとの比較
+	inline Mask4 CmpLe(Vec4 a, Vec4 b)
+	{
+		return CmpGe(b, a);
+	}
+
+	// maskが立っている要素はa、それ以外はbを選ぶ
+	inline Vec4 Select(Mask4 mask, Vec4 a, Vec4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#elif defined(MATH_SIMD_NEON)
+		return vbslq_f32(mask, a, b);
+#else
+		return { { mask.v[0] ? a.v[0] : b.v[0], mask.v[1] ? a.v[1] : b.v[1],
+			mask.v[2] ? a.v[2] : b.v[2], mask.v[3] ? a.v[3] : b.v[3] } };
+#endif
+	}
+
+	// マスクの論理和
+	inline Mask4 Or(Mask4 a, Mask4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_or_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vorrq_u32(a, b);
+#else
+		return { { a.v[0] || b.v[0], a.v[1] || b.v[1], a.v[2] || b.v[2], a.v[3] || b.v[3] } };
+#endif
+	}
+
+	// マスクの論理積
+	inline Mask4 And(Mask4 a, Mask4 b)
+	{
+#if defined(MATH_SIMD_SSE)
+		return _mm_and_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+		return vandq_u32(a, b);
+#else
+		return { { a.v[0] && b.v[0], a.v[1] && b.v[1], a.v[2] && b.v[2], a.v[3] && b.v[3] } };
+#endif
+	}
+
+	// マスクの各要素を1ビットにまとめる（要素iがビットiになる）
+	inline uint32_t MoveMask(Mask4 mask)
+	{
+#if defined(MATH_SIMD_SSE)
+		return static_cast<uint32_t>(_mm_movemask_ps(mask));
+#elif defined(MATH_SIMD_NEON)
+		static const int32_t kShifts[4] = { 0, 1, 2, 3 };
+		return vaddvq_u32(vshlq_u32(vshrq_n_u32(mask, 31), vld1q_s32(kShifts)));
+#else
+		return (mask.v[0] ? 1u : 0u) | (mask.v[1] ? 2u : 0u) | (mask.v[2] ? 4u : 0u) | (mask.v[3] ? 8u : 0u);
+#endif
+	}
+
+	// 4x4の転置（r0～r3を列として並べ替える）
+	inline void Transpose4(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3)
+	{
+#if defined(MATH_SIMD_SSE)
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#elif defined(MATH_SIMD_NEON)
+		float32x4x2_t t01 = vtrnq_f32(r0, r1);
+		float32x4x2_t t23 = vtrnq_f32(r2, r3);
+		r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#else
+		Vec4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+		r0 = { { t0.v[0], t1.v[0], t2.v[0], t3.v[0] } };
+		r1 = { { t0.v[1], t1.v[1], t2.v[1], t3.v[1] } };
+		r2 = { { t0.v[2], t1.v[2], t2.v[2], t3.v[2] } };
+		r3 = { { t0.v[3], t1.v[3], t2.v[3], t3.v[3] } };
+#endif
+	}
+
+	// 4要素分のr, g, b, a（0～1）を8bitずつに量子化し、下位からR, G, B, Aの順に詰めてout[0]～out[3]に書き込む
+	// 範囲外は0～1に収め、x * 255 + 0.5 を切り捨てて四捨五入する（スカラーで同じ式を書けば結果は一致する）
+	inline void PackUnorm8(Vec4 r, Vec4 g, Vec4 b, Vec4 a, uint32_t* out)
+	{
+		const Vec4 kZero = Zero();
+		const Vec4 kOne = Set1(1.0f);
+		const Vec4 kScale = Set1(255.0f);
+		const Vec4 kHalf = Set1(0.5f);
+		r = Add(Mul(Min(Max(r, kZero), kOne), kScale), kHalf);
+		g = Add(Mul(Min(Max(g, kZero), kOne), kScale), kHalf);
+		b = Add(Mul(Min(Max(b, kZero), kOne), kScale), kHalf);
+		a = Add(Mul(Min(Max(a, kZero), kOne), kScale), kHalf);
+#if defined(MATH_SIMD_SSE)
+		__m128i packed = _mm_or_si128(
+			_mm_or_si128(_mm_cvttps_epi32(r), _mm_slli_epi32(_mm_cvttps_epi32(g), 8)),
+			_mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(b), 16), _mm_slli_epi32(_mm_cvttps_epi32(a), 24)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+#elif defined(MATH_SIMD_NEON)
+		uint32x4_t packed = vorrq_u32(
+			vorrq_u32(vcvtq_u32_f32(r), vshlq_n_u32(vcvtq_u32_f32(g), 8)),
+			vorrq_u32(vshlq_n_u32(vcvtq_u32_f32(b), 16), vshlq_n_u32(vcvtq_u32_f32(a), 24)));
+		vst1q_u32(out, packed);
+#else
+		for (int32_t i = 0; i < 4; ++i) {
+			out[i] = static_cast<uint32_t>(r.v[i]) | (static_cast<uint32_t>(g.v[i]) << 8) |
+				(static_cast<uint32_t>(b.v[i]) << 16) | (static_cast<uint32_t>(a.v[i]) << 24);
+		}
+#endif
+	}
+
+	// sinとcosを同時に求める
+	// [-π, π]に折り返した後、sin(π - x) = sin(x) を使って[-π/2, π/2]に縮め、
+	// テイラー多項式で近似する。std::sin/std::cosとの差は |x| < 1000 の範囲で 1e-6 程度
+	inline void SinCos(Vec4 x, Vec4* outSin, Vec4* outCos)
+	{
+		// 2πは上位と下位に分けて引き、折り返しでの桁落ちを抑える
+		const Vec4 kTwoPiHi = Set1(6.28125f);
+		const Vec4 kTwoPiLo = Set1(1.9353071795864769e-3f);
+		const Vec4 kInvTwoPi = Set1(0.159154943092f);
+		const Vec4 kPi = Set1(3.14159265359f);
+		const Vec4 kHalfPi = Set1(1.57079632679f);
+
+		// [-π, π]に折り返す
+		Vec4 turns = Round(Mul(x, kInvTwoPi));
+		x = Sub(x, Mul(turns, kTwoPiHi));
+		x = Sub(x, Mul(turns, kTwoPiLo));
+
+		// [-π/2, π/2]の外側は反対側に折り返し、cosの符号を反転する
+		Mask4 over = CmpGt(x, kHalfPi);
+		Mask4 under = CmpLt(x, Sub(Zero(), kHalfPi));
+		x = Select(over, Sub(kPi, x), x);
+		x = Select(under, Sub(Sub(Zero(), kPi), x), x);
+		Vec4 cosSign = Select(over, Set1(-1.0f), Select(under, Set1(-1.0f), Set1(1.0f)));
+
+		Vec4 x2 = Mul(x, x);
+
+		// sin(x) = x - x^3/3! + x^5/5! - ... + x^11/11!
+		Vec4 s = Set1(-2.5052108e-8f);
+		s = MulAdd(s, x2, Set1(2.7557319e-6f));
+		s = MulAdd(s, x2, Set1(-1.9841270e-4f));
+		s = MulAdd(s, x2, Set1(8.3333333e-3f));
+		s = MulAdd(s, x2, Set1(-1.6666667e-1f));
+		s = MulAdd(s, x2, Set1(1.0f));
+		*outSin = Mul(s, x);
+
+		// cos(x) = 1 - x^2/2! + x^4/4! - ... + x^12/12!
+		Vec4 c = Set1(2.0876757e-9f);
+		c = MulAdd(c, x2, Set1(-2.7557319e-7f));
+		c = MulAdd(c, x2, Set1(2.4801587e-5f));
+		c = MulAdd(c, x2, Set1(-1.3888889e-3f));
+		c = MulAdd(c, x2, Set1(4.1666667e-2f));
+		c = MulAdd(c, x2, Set1(-0.5f));
+		c = MulAdd(c, x2, Set1(1.0f));
+		*outCos = Mul(c, cosSign);
+	}
+}
@@ -2,12 +2,54 @@
 
 Matrix Transform::MakeAffineMatrix()
 {
-    Matrix result = Matrix::Identity();
+    // SRTの順番でかけた結果を展開した式で直接生成する
+    return Matrix::Affine(scale, rotate, translate);
+}
 
-    // SRTの順番で行列を生成してかける
-    result *= Matrix::Scaling({ scale.x, scale.y, scale.z });
-    result *= Matrix::RotationRollPitchYaw(rotate.z, rotate.x, rotate.y);
-    result *= Matrix::Translation({ translate.x, translate.y, translate.z });
+Matrix Transform::MakeInverseAffineMatrix()
+{
+    Matrix affine = MakeAffineMatrix();
+
+    // スケールがかかっていなければ回転の転置だけで済む
+    if (scale.x == 1.0f && scale.y == 1.0f && scale.z == 1.0f) {
+        return Matrix::InverseRigid(affine);
+    }
+
+    return Matrix::InverseAffine(affine);
+}
+
+Matrix QuaternionTransform::MakeAffineMatrix() const
+{
+    float xx = rotate.x * rotate.x, yy = rotate.y * rotate.y, zz = rotate.z * rotate.z;
+    float xy = rotate.x * rotate.y, xz = rotate.x * rotate.z, yz = rotate.y * rotate.z;
+    float wx = rotate.w * rotate.x, wy = rotate.w * rotate.y, wz = rotate.w * rotate.z;
+
+    // 回転行列の各行にスケールをかけ、平行移動を並べる
+    return Matrix(
+        (1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f,
+        2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f,
+        2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f,
+        translate.x, translate.y, translate.z, 1.0f
+    );
+}
 
-    return result;
+Matrix QuaternionTransform::MakeInverseAffineMatrix() const
+{
+    Matrix affine = MakeAffineMatrix();
+
+    // スケールがかかっていなければ回転の転置だけで済む
+    if (scale.x == 1.0f && scale.y == 1.0f && scale.z == 1.0f) {
+        return Matrix::InverseRigid(affine);
+    }
+
+    return Matrix::InverseAffine(affine);
+}
+
+QuaternionTransform QuaternionTransform::FromTransform(const Transform& transform)
+{
+    return QuaternionTransform{
+        transform.scale,
+        Quaternion::RotationRollPitchYaw(transform.rotate.z, transform.rotate.x, transform.rotate.y),
+        transform.translate,
+    };
 }
\ No newline at end of file
@@ -9,5 +9,27 @@ public:
 	Float3 translate;
 
 	Matrix MakeAffineMatrix();
+
+	// MakeAffineMatrixの逆行列
+	// スケールが1なら剛体変換として、それ以外はアフィン変換として閉じた式で求める
+	Matrix MakeInverseAffineMatrix();
 };
 
+// 回転をクォータニオンで保持するTransform
+// 行列生成時に三角関数を使わないため、毎フレーム行列を作る用途やアニメーションのブレンドに向く
+class QuaternionTransform
+{
+public:
+	Float3 scale;
+	Quaternion rotate;
+	Float3 translate;
+
+	Matrix MakeAffineMatrix() const;
+
+	// MakeAffineMatrixの逆行列
+	// スケールが1なら剛体変換として、それ以外はアフィン変換として閉じた式で求める
+	Matrix MakeInverseAffineMatrix() const;
+
+	// Euler角のTransformから変換する
+	static QuaternionTransform FromTransform(const Transform& transform);
+};
@@ -0,0 +1,135 @@
+#include "TransformBatch.h"
+#include "SimdMath.h"
+#include "Transform.h"
+
+namespace {
+	// 4要素分のSRTをまとめて行列に変換し、out[0]～out[numWrite - 1]に書き込む
+	void MakeAffineMatrices4(
+		Simd::Vec4 scaleX, Simd::Vec4 scaleY, Simd::Vec4 scaleZ,
+		Simd::Vec4 rotateX, Simd::Vec4 rotateY, Simd::Vec4 rotateZ,
+		Simd::Vec4 translateX, Simd::Vec4 translateY, Simd::Vec4 translateZ,
+		Matrix* out, size_t numWrite)
+	{
+		using namespace Simd;
+
+		Vec4 sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos(rotateX, &sinX, &cosX);
+		SinCos(rotateY, &sinY, &cosY);
+		SinCos(rotateZ, &sinZ, &cosZ);
+
+		// Roll(z) * Pitch(x) * Yaw(y) を展開した式
+		Vec4 sinXsinY = Mul(sinX, sinY);
+		Vec4 sinXcosY = Mul(sinX, cosY);
+
+		Vec4 m00 = Mul(Add(Mul(cosZ, cosY), Mul(sinZ, sinXsinY)), scaleX);
+		Vec4 m01 = Mul(Mul(sinZ, cosX), scaleX);
+		Vec4 m02 = Mul(Sub(Mul(sinZ, sinXcosY), Mul(cosZ, sinY)), scaleX);
+
+		Vec4 m10 = Mul(Sub(Mul(cosZ, sinXsinY), Mul(sinZ, cosY)), scaleY);
+		Vec4 m11 = Mul(Mul(cosZ, cosX), scaleY);
+		Vec4 m12 = Mul(Add(Mul(sinZ, sinY), Mul(cosZ, sinXcosY)), scaleY);
+
+		Vec4 m20 = Mul(Mul(cosX, sinY), scaleZ);
+		Vec4 m21 = Mul(Sub(Zero(), sinX), scaleZ);
+		Vec4 m22 = Mul(Mul(cosX, cosY), scaleZ);
+
+		Vec4 zero0 = Zero();
+		Vec4 zero1 = Zero();
+		Vec4 zero2 = Zero();
+		Vec4 one = Set1(1.0f);
+
+		// 要素ごとの列を行に並べ替える（転置後のmX0が要素0のX行目になる）
+		Transpose4(m00, m01, m02, zero0);
+		Transpose4(m10, m11, m12, zero1);
+		Transpose4(m20, m21, m22, zero2);
+		Transpose4(translateX, translateY, translateZ, one);
+
+		Vec4 row0[4] = { m00, m01, m02, zero0 };
+		Vec4 row1[4] = { m10, m11, m12, zero1 };
+		Vec4 row2[4] = { m20, m21, m22, zero2 };
+		Vec4 row3[4] = { translateX, translateY, translateZ, one };
+
+		for (size_t lane = 0; lane < numWrite; ++lane) {
+			Store(out[lane].r[0], row0[lane]);
+			Store(out[lane].r[1], row1[lane]);
+			Store(out[lane].r[2], row2[lane]);
+			Store(out[lane].r[3], row3[lane]);
+		}
+	}
+}
+
+void TransformBatch::MakeAffineMatrices(const Streams& streams, Matrix* out, size_t count)
+{
+	size_t index = 0;
+
+	// 4要素ずつ処理
+	for (; index + 4 <= count; index += 4) {
+		MakeAffineMatrices4(
+			Simd::Load(streams.scaleX + index), Simd::Load(streams.scaleY + index), Simd::Load(streams.scaleZ + index),
+			Simd::Load(streams.rotateX + index), Simd::Load(streams.rotateY + index), Simd::Load(streams.rotateZ + index),
+			Simd::Load(streams.translateX + index), Simd::Load(streams.translateY + index), Simd::Load(streams.translateZ + index),
+			out + index, 4);
+	}
+
+	// 端数は一時配列に詰めて同じ計算で処理する（要素ごとに結果が変わらないように）
+	if (index < count) {
+		const float* sources[9] = {
+			streams.scaleX, streams.scaleY, streams.scaleZ,
+			streams.rotateX, streams.rotateY, streams.rotateZ,
+			streams.translateX, streams.translateY, streams.translateZ,
+		};
+		float tail[9][4] = {};
+		size_t rest = count - index;
+		for (size_t stream = 0; stream < 9; ++stream) {
+			for (size_t lane = 0; lane < rest; ++lane) {
+				tail[stream][lane] = sources[stream][index + lane];
+			}
+		}
+		MakeAffineMatrices4(
+			Simd::Load(tail[0]), Simd::Load(tail[1]), Simd::Load(tail[2]),
+			Simd::Load(tail[3]), Simd::Load(tail[4]), Simd::Load(tail[5]),
+			Simd::Load(tail[6]), Simd::Load(tail[7]), Simd::Load(tail[8]),
+			out + index, rest);
+	}
+}
+
+void TransformBatch::Clear()
+{
+	for (std::vector<float>* stream : { &scaleX, &scaleY, &scaleZ, &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		stream->clear();
+	}
+}
+
+void TransformBatch::Reserve(size_t capacity)
+{
+	for (std::vector<float>* stream : { &scaleX, &scaleY, &scaleZ, &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		stream->reserve(capacity);
+	}
+}
+
+void TransformBatch::Add(const Transform& transform)
+{
+	scaleX.push_back(transform.scale.x);
+	scaleY.push_back(transform.scale.y);
+	scaleZ.push_back(transform.scale.z);
+	rotateX.push_back(transform.rotate.x);
+	rotateY.push_back(transform.rotate.y);
+	rotateZ.push_back(transform.rotate.z);
+	translateX.push_back(transform.translate.x);
+	translateY.push_back(transform.translate.y);
+	translateZ.push_back(transform.translate.z);
+}
+
+TransformBatch::Streams TransformBatch::GetStreams() const
+{
+	return Streams{
+		scaleX.data(), scaleY.data(), scaleZ.data(),
+		rotateX.data(), rotateY.data(), rotateZ.data(),
+		translateX.data(), translateY.data(), translateZ.data(),
+	};
+}
+
+void TransformBatch::MakeAffineMatrices(Matrix* out) const
+{
+	MakeAffineMatrices(GetStreams(), out, Size());
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Matrix.h"
+
+class Transform;
+
+// 大量のTransformからワールド行列をまとめて生成する
+// scale / rotate / translate を要素ごとの配列（SoA）で保持し、
+// 4つずつSIMDでsin/cosとSRTの合成を行う。途中でMatrixの一時オブジェクトは作らない
+class TransformBatch
+{
+public:
+	// 各要素の配列の先頭ポインタ。すべてcount要素以上あること
+	// 一様スケールなど同じ値を使う成分は、同じ配列を指してもよい
+	struct Streams {
+		const float* scaleX;
+		const float* scaleY;
+		const float* scaleZ;
+		const float* rotateX;
+		const float* rotateY;
+		const float* rotateZ;
+		const float* translateX;
+		const float* translateY;
+		const float* translateZ;
+	};
+
+	// SoAの配列からcount個のワールド行列をoutに書き込む
+	// 要素ごとの結果はMatrix::Affineと同じ式（sin/cosの近似による誤差を除く）
+	static void MakeAffineMatrices(const Streams& streams, Matrix* out, size_t count);
+
+	///
+	/// 配列の管理
+	///
+
+	// 要素を空にする（確保済みの容量はそのまま）
+	void Clear();
+	// 容量を確保する
+	void Reserve(size_t capacity);
+	// 末尾にTransformを追加する
+	void Add(const Transform& transform);
+	// 要素数
+	size_t Size() const { return translateX.size(); }
+
+	// 保持している配列のStreamsを取得
+	Streams GetStreams() const;
+
+	// 保持している全要素のワールド行列をoutに書き込む
+	void MakeAffineMatrices(Matrix* out) const;
+
+	std::vector<float> scaleX, scaleY, scaleZ;
+	std::vector<float> rotateX, rotateY, rotateZ;
+	std::vector<float> translateX, translateY, translateZ;
+};
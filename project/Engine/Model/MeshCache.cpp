@@ -0,0 +1,347 @@
+#include "MeshCache.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MeshCache::Header) == 128, "MeshCache::Header のレイアウトが変わった場合はkVersionを上げること");
+static_assert(sizeof(MeshCache::NodeRecord) == 80, "MeshCache::NodeRecord のレイアウトが変わった場合はkVersionを上げること");
+
+namespace {
+	// 区間の境界
+	constexpr uint64_t kSectionAlignment = 8;
+
+	uint64_t AlignSection(uint64_t offset)
+	{
+		return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+	}
+
+	uint32_t Fnv1a(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	// 読み取り専用でメモリにマップしたファイル
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { Close(); }
+
+		bool Open(const std::string& path)
+		{
+#ifdef _WIN32
+			file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+				return false;
+			}
+			mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping_) {
+				return false;
+			}
+			data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+			size_ = static_cast<size_t>(size.QuadPart);
+#else
+			file_ = open(path.c_str(), O_RDONLY);
+			if (file_ < 0) {
+				return false;
+			}
+			struct stat status;
+			if (fstat(file_, &status) != 0 || status.st_size == 0) {
+				return false;
+			}
+			void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+			data_ = data == MAP_FAILED ? nullptr : data;
+			size_ = static_cast<size_t>(status.st_size);
+#endif
+			return data_ != nullptr;
+		}
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (data_) {
+				UnmapViewOfFile(data_);
+			}
+			if (mapping_) {
+				CloseHandle(mapping_);
+			}
+			if (file_ != INVALID_HANDLE_VALUE) {
+				CloseHandle(file_);
+			}
+			mapping_ = nullptr;
+			file_ = INVALID_HANDLE_VALUE;
+#else
+			if (data_) {
+				munmap(data_, size_);
+			}
+			if (file_ >= 0) {
+				close(file_);
+			}
+			file_ = -1;
+#endif
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		const uint8_t* GetData() const { return static_cast<const uint8_t*>(data_); }
+		size_t GetSize() const { return size_; }
+
+	private:
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#else
+		int file_ = -1;
+#endif
+		void* data_ = nullptr;
+		size_t size_ = 0;
+	};
+
+	// 元のファイルのサイズと更新時刻
+	bool GetSourceStamp(const std::string& sourcePath, uint64_t* outSize, int64_t* outWriteTime)
+	{
+		std::error_code error;
+		uint64_t size = std::filesystem::file_size(sourcePath, error);
+		if (error) {
+			return false;
+		}
+		auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+		if (error) {
+			return false;
+		}
+		*outSize = size;
+		*outWriteTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+		return true;
+	}
+
+	// 区間がファイルに収まっているか
+	bool IsSectionInFile(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize)
+	{
+		if (offset > fileSize || (stride != 0 && count > (fileSize - offset) / stride)) {
+			return false;
+		}
+		return offset % kSectionAlignment == 0;
+	}
+
+	// ノードを行きがけ順に並べる
+	void FlattenNode(const ModelNode& node, std::vector<MeshCache::NodeRecord>& records, std::string& strings)
+	{
+		MeshCache::NodeRecord record{};
+		record.localMatrix = node.localMatrix;
+		record.nameOffset = static_cast<uint32_t>(strings.size());
+		record.nameLength = static_cast<uint32_t>(node.name.size());
+		record.childCount = static_cast<uint32_t>(node.children.size());
+		strings += node.name;
+		records.push_back(record);
+		for (const ModelNode& child : node.children) {
+			FlattenNode(child, records, strings);
+		}
+	}
+
+	// 行きがけ順のノードから階層を組み立てる（cursorは次に読むノード）
+	bool BuildNode(const MeshCache::NodeRecord* records, uint32_t count, const char* strings, uint32_t stringSize,
+		uint32_t* cursor, ModelNode* out)
+	{
+		if (*cursor >= count) {
+			return false;
+		}
+		const MeshCache::NodeRecord& record = records[(*cursor)++];
+		if (record.nameOffset > stringSize || record.nameLength > stringSize - record.nameOffset || record.childCount > count - *cursor) {
+			return false;
+		}
+		out->localMatrix = record.localMatrix;
+		out->name.assign(strings + record.nameOffset, record.nameLength);
+		out->children.resize(record.childCount);
+		for (ModelNode& child : out->children) {
+			if (!BuildNode(records, count, strings, stringSize, cursor, &child)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+std::string MeshCache::GetCachePath(const std::string& sourcePath)
+{
+	return sourcePath + ".meshcache";
+}
+
+uint32_t MeshCache::ComputeHeaderChecksum(const Header& header)
+{
+	return Fnv1a(&header, offsetof(Header, headerChecksum));
+}
+
+bool MeshCache::Load(const std::string& directoryPath, const std::string& sourcePath, ModelMesh* out)
+{
+	uint64_t sourceSize;
+	int64_t sourceWriteTime;
+	if (!GetSourceStamp(sourcePath, &sourceSize, &sourceWriteTime)) {
+		return false;
+	}
+
+	MappedFile file;
+	if (!file.Open(GetCachePath(sourcePath)) || file.GetSize() < sizeof(Header)) {
+		return false;
+	}
+
+	// ヘッダを確かめる（形式・元のファイル・各区間の範囲）
+	Header header;
+	std::memcpy(&header, file.GetData(), sizeof(Header));
+	if (header.magic != kMagic || header.version != kVersion || header.headerChecksum != ComputeHeaderChecksum(header)) {
+		return false;
+	}
+	if (header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime) {
+		return false;
+	}
+	if (header.fileSize != file.GetSize() || header.vertexStride != sizeof(ModelVertex)) {
+		return false;
+	}
+	if (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t)) {
+		return false;
+	}
+	if (!IsSectionInFile(header.vertexOffset, header.vertexCount, header.vertexStride, header.fileSize) ||
+		!IsSectionInFile(header.indexOffset, header.indexCount, header.indexSize, header.fileSize) ||
+		!IsSectionInFile(header.nodeOffset, header.nodeCount, sizeof(NodeRecord), header.fileSize) ||
+		!IsSectionInFile(header.stringOffset, header.stringSize, 1, header.fileSize)) {
+		return false;
+	}
+	if (header.nodeCount == 0 || header.texturePathOffset > header.stringSize ||
+		header.texturePathLength > header.stringSize - header.texturePathOffset) {
+		return false;
+	}
+
+	// 各区間をそのまま写す
+	const uint8_t* data = file.GetData();
+	ModelMesh modelData;
+	modelData.vertices.resize(header.vertexCount);
+	std::memcpy(modelData.vertices.data(), data + header.vertexOffset, sizeof(ModelVertex) * header.vertexCount);
+
+	// インデックスは32bitに広げて持つ（範囲外を指すものがあれば使わない）
+	if (header.indexCount % 3 != 0) {
+		return false;
+	}
+	modelData.indices.resize(header.indexCount);
+	uint32_t maxIndex = 0;
+	if (header.indexSize == sizeof(uint16_t)) {
+		const uint16_t* indices = reinterpret_cast<const uint16_t*>(data + header.indexOffset);
+		for (uint32_t i = 0; i < header.indexCount; ++i) {
+			modelData.indices[i] = indices[i];
+			maxIndex = (std::max)(maxIndex, uint32_t(indices[i]));
+		}
+	} else if (header.indexCount != 0) {
+		std::memcpy(modelData.indices.data(), data + header.indexOffset, sizeof(uint32_t) * header.indexCount);
+		maxIndex = *std::max_element(modelData.indices.begin(), modelData.indices.end());
+	}
+	if (header.indexCount != 0 && maxIndex >= header.vertexCount) {
+		return false;
+	}
+
+	std::vector<NodeRecord> records(header.nodeCount);
+	std::memcpy(records.data(), data + header.nodeOffset, sizeof(NodeRecord) * header.nodeCount);
+	const char* strings = reinterpret_cast<const char*>(data + header.stringOffset);
+	uint32_t cursor = 0;
+	if (!BuildNode(records.data(), header.nodeCount, strings, header.stringSize, &cursor, &modelData.rootNode) || cursor != header.nodeCount) {
+		return false;
+	}
+
+	if (header.texturePathLength != 0) {
+		modelData.material.textureFilePath = directoryPath + "/" + std::string(strings + header.texturePathOffset, header.texturePathLength);
+	}
+	modelData.bounds = header.bounds;
+
+	*out = std::move(modelData);
+	return true;
+}
+
+bool MeshCache::Save(const std::string& directoryPath, const std::string& sourcePath, const ModelMesh& model)
+{
+	Header header;
+	std::memset(&header, 0, sizeof(Header));
+	if (!GetSourceStamp(sourcePath, &header.sourceSize, &header.sourceWriteTime)) {
+		return false;
+	}
+
+	// ノード名とテクスチャのパスを1つの文字列区間にまとめる
+	std::vector<NodeRecord> records;
+	std::string strings;
+	FlattenNode(model.rootNode, records, strings);
+
+	std::string texturePath = model.material.textureFilePath;
+	std::string prefix = directoryPath + "/";
+	if (texturePath.compare(0, prefix.size(), prefix) == 0) {
+		texturePath.erase(0, prefix.size());
+	}
+	header.texturePathOffset = static_cast<uint32_t>(strings.size());
+	header.texturePathLength = static_cast<uint32_t>(texturePath.size());
+	strings += texturePath;
+
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.vertexStride = sizeof(ModelVertex);
+	header.vertexCount = static_cast<uint32_t>(model.vertices.size());
+	header.indexSize = ModelMesh::CanUse16BitIndices(model.vertices.size()) ? sizeof(uint16_t) : sizeof(uint32_t);
+	header.indexCount = static_cast<uint32_t>(model.indices.size());
+	header.nodeCount = static_cast<uint32_t>(records.size());
+	header.stringSize = static_cast<uint32_t>(strings.size());
+	header.bounds = model.bounds;
+	header.vertexOffset = AlignSection(sizeof(Header));
+	header.indexOffset = AlignSection(header.vertexOffset + uint64_t(header.vertexStride) * header.vertexCount);
+	header.nodeOffset = AlignSection(header.indexOffset + uint64_t(header.indexSize) * header.indexCount);
+	header.stringOffset = AlignSection(header.nodeOffset + sizeof(NodeRecord) * records.size());
+	header.fileSize = header.stringOffset + header.stringSize;
+	header.headerChecksum = ComputeHeaderChecksum(header);
+
+	// 1つのバッファに組み立ててから書き出す
+	std::vector<uint8_t> bytes(header.fileSize, 0);
+	std::memcpy(bytes.data(), &header, sizeof(Header));
+	std::memcpy(bytes.data() + header.vertexOffset, model.vertices.data(), uint64_t(header.vertexStride) * header.vertexCount);
+	if (header.indexSize == sizeof(uint16_t)) {
+		uint16_t* indices = reinterpret_cast<uint16_t*>(bytes.data() + header.indexOffset);
+		for (uint32_t i = 0; i < header.indexCount; ++i) {
+			indices[i] = static_cast<uint16_t>(model.indices[i]);
+		}
+	} else {
+		std::memcpy(bytes.data() + header.indexOffset, model.indices.data(), sizeof(uint32_t) * header.indexCount);
+	}
+	std::memcpy(bytes.data() + header.nodeOffset, records.data(), sizeof(NodeRecord) * records.size());
+	std::memcpy(bytes.data() + header.stringOffset, strings.data(), strings.size());
+
+	std::string cachePath = GetCachePath(sourcePath);
+	std::string temporaryPath = cachePath + ".tmp";
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "ModelMesh.h"
+
+// モデルを読み込んだ結果をそのまま並べたバイナリのキャッシュ
+// ・元のファイルの隣に「<元のファイル名>.meshcache」として書き出す
+// ・読み込みはファイルをメモリにマップし、ヘッダを確かめてから各区間を写すだけ（テキストの解析をしない）
+// ・ヘッダには元のファイルのサイズと更新時刻を持ち、どちらかが変わっていれば使わない
+// ・形式を変えたらkVersionを上げる（古いキャッシュは読まずに作り直す）
+// ・効果はModelManager::ReadModelFileのログ「LoadModelFile <パス> (cache / import): <時間>ms」で比べる
+//   （.meshcacheを消して起動すればimport、もう1度起動すればcacheの時間になる）
+//   resources/Models の全ファイルでまとめて比べるには benchmarks/MeshCacheBenchmark を使う
+//
+// ファイルの並び（オフセットはいずれも先頭から、8バイト境界に揃える）
+//   Header
+//   ModelVertex x vertexCount
+//   インデックス x indexCount（頂点数が収まれば16bit、収まらなければ32bit）
+//   NodeRecord  x nodeCount（行きがけ順）
+//   文字列（ノード名とテクスチャのパス、終端の'\0'なし）
+class MeshCache
+{
+public:
+	static constexpr uint32_t kMagic = 0x4348534D; // "MSHC"
+	static constexpr uint32_t kVersion = 3;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		// 元のファイル（キャッシュが古くなったかの判定用）
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		// 各区間の要素数
+		uint32_t vertexStride;
+		uint32_t vertexCount;
+		uint32_t indexSize;
+		uint32_t indexCount;
+		uint32_t nodeCount;
+		uint32_t stringSize;
+		// テクスチャのパス（モデルのディレクトリからの相対、文字列区間の中の位置）
+		uint32_t texturePathOffset;
+		uint32_t texturePathLength;
+		AABB bounds;
+		// 各区間の位置
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint64_t nodeOffset;
+		uint64_t stringOffset;
+		uint64_t fileSize;
+		// ここまでのFNV-1a（最後に置く）
+		uint32_t headerChecksum;
+		uint32_t padding;
+	};
+
+	struct NodeRecord {
+		Matrix localMatrix;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+		uint32_t childCount;
+		uint32_t padding;
+	};
+
+	// sourcePathに対応するキャッシュのパス
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	// キャッシュが元のファイルと一致していれば、頂点・インデックス・ノード・マテリアルのパス・範囲をoutに読み込んでtrueを返す
+	// GPUのリソースは作らない
+	static bool Load(const std::string& directoryPath, const std::string& sourcePath, ModelMesh* out);
+
+	// modelのキャッシュを書き出す（一時ファイルに書いてから置き換えるので、途中で止まっても壊れたキャッシュは残らない）
+	static bool Save(const std::string& directoryPath, const std::string& sourcePath, const ModelMesh& model);
+
+	// ヘッダのチェックサム（headerChecksumより前のバイト）
+	static uint32_t ComputeHeaderChecksum(const Header& header);
+};
@@ -0,0 +1,397 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+namespace {
+	// FIFOの頂点キャッシュを真似る
+	// 頂点を変換した時刻を覚えておき、その後の変換がcacheSize回未満なら残っているとみなす
+	class VertexCacheSimulator
+	{
+	public:
+		VertexCacheSimulator(size_t numVertices, uint32_t cacheSize)
+			: cacheTime_(numVertices, 0), cacheSize_(cacheSize), timestamp_(cacheSize + 1) {}
+
+		// 頂点を参照し、変換し直したら1を返す
+		uint32_t Access(uint32_t vertex)
+		{
+			if (timestamp_ - cacheTime_[vertex] > cacheSize_) {
+				cacheTime_[vertex] = timestamp_++;
+				return 1;
+			}
+			return 0;
+		}
+
+		// キャッシュを空にする
+		void Flush() { timestamp_ += cacheSize_ + 1; }
+
+	private:
+		std::vector<uint32_t> cacheTime_;
+		uint32_t cacheSize_;
+		uint32_t timestamp_;
+	};
+
+	Float3 Cross(const Float3& a, const Float3& b)
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	float Dot(const Float3& a, const Float3& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	Float3 ToFloat3(const Float4& a)
+	{
+		return { a.x, a.y, a.z };
+	}
+
+	// 頂点を比べるためのビット列（-0と+0は同じものとして扱う）
+	ModelVertex CanonicalizeVertex(const ModelVertex& vertex)
+	{
+		ModelVertex result = vertex;
+		float* values = reinterpret_cast<float*>(&result);
+		for (size_t i = 0; i < sizeof(ModelVertex) / sizeof(float); ++i) {
+			values[i] += 0.0f;
+		}
+		return result;
+	}
+
+	uint32_t HashVertex(const ModelVertex& vertex)
+	{
+		uint32_t words[sizeof(ModelVertex) / sizeof(uint32_t)];
+		std::memcpy(words, &vertex, sizeof(words));
+		uint32_t hash = 2166136261u;
+		for (uint32_t word : words) {
+			hash = (hash ^ word) * 16777619u;
+		}
+		// 下位bitで表を引くので、上位bitを混ぜておく
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6Bu;
+		hash ^= hash >> 13;
+		return hash;
+	}
+}
+
+void MeshOptimizer::WeldVertices(const std::vector<ModelVertex>& triangleList, std::vector<ModelVertex>* outVertices, std::vector<uint32_t>* outIndices)
+{
+	outVertices->clear();
+	outIndices->clear();
+	outIndices->reserve(triangleList.size());
+
+	// 開番地法のハッシュ表（要素数の2倍以上の2のべき乗、空きはUINT32_MAX）
+	size_t tableSize = 1;
+	while (tableSize < triangleList.size() * 2) {
+		tableSize <<= 1;
+	}
+	std::vector<uint32_t> table(tableSize, UINT32_MAX);
+	size_t mask = tableSize - 1;
+
+	for (const ModelVertex& source : triangleList) {
+		ModelVertex vertex = CanonicalizeVertex(source);
+		size_t slot = HashVertex(vertex) & mask;
+		while (true) {
+			uint32_t index = table[slot];
+			if (index == UINT32_MAX) {
+				// 初めて現れた頂点
+				index = static_cast<uint32_t>(outVertices->size());
+				table[slot] = index;
+				outVertices->push_back(vertex);
+				outIndices->push_back(index);
+				break;
+			}
+			if (std::memcmp(&(*outVertices)[index], &vertex, sizeof(ModelVertex)) == 0) {
+				outIndices->push_back(index);
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+	}
+}
+
+void MeshOptimizer::Optimize(std::vector<ModelVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	OptimizeVertexCache(indices, vertices.size());
+	OptimizeOverdraw(indices, vertices);
+	OptimizeVertexFetch(vertices, indices);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles == 0) {
+		return;
+	}
+
+	// 頂点ごとに、それを使う三角形の一覧を作る
+	std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+	for (uint32_t index : indices) {
+		++adjacencyOffsets[index + 1];
+	}
+	for (size_t v = 0; v < numVertices; ++v) {
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	}
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); ++i) {
+			adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// まだ出力していない三角形の数（live）と、最後に変換した時刻
+	std::vector<uint32_t> liveCount(numVertices);
+	for (size_t v = 0; v < numVertices; ++v) {
+		liveCount[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+	}
+	std::vector<uint32_t> cacheTime(numVertices, 0);
+	std::vector<uint8_t> emitted(numTriangles, 0);
+	uint32_t timestamp = cacheSize + 1;
+
+	// 行き止まりになったときに戻る候補（最近出力した頂点）
+	std::vector<uint32_t> deadEndStack;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	size_t cursor = 1;
+	int64_t fanning = 0;
+	while (fanning >= 0) {
+		// fanningを使う三角形を全て出力する
+		candidates.clear();
+		uint32_t vertex = static_cast<uint32_t>(fanning);
+		for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a) {
+			uint32_t triangle = adjacency[a];
+			if (emitted[triangle]) {
+				continue;
+			}
+			emitted[triangle] = 1;
+			for (uint32_t k = 0; k < 3; ++k) {
+				uint32_t v = indices[triangle * 3 + k];
+				result.push_back(v);
+				deadEndStack.push_back(v);
+				candidates.push_back(v);
+				--liveCount[v];
+				if (timestamp - cacheTime[v] > cacheSize) {
+					cacheTime[v] = timestamp++;
+				}
+			}
+		}
+
+		// 次の頂点は、三角形が残っていて、それを全て出力してもキャッシュに残るもののうち最も古いもの
+		fanning = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t v : candidates) {
+			if (liveCount[v] == 0) {
+				continue;
+			}
+			int64_t priority = 0;
+			if (timestamp - cacheTime[v] + 2 * liveCount[v] <= cacheSize) {
+				priority = timestamp - cacheTime[v];
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				fanning = v;
+			}
+		}
+		if (fanning >= 0) {
+			continue;
+		}
+
+		// 行き止まりなら、最近出力した頂点から三角形が残っているものを探し、なければ頂点の番号順に探す
+		while (!deadEndStack.empty()) {
+			uint32_t v = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (liveCount[v] > 0) {
+				fanning = v;
+				break;
+			}
+		}
+		while (fanning < 0 && cursor < numVertices) {
+			if (liveCount[cursor] > 0) {
+				fanning = static_cast<int64_t>(cursor);
+			}
+			++cursor;
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<ModelVertex>& vertices,
+	float threshold, uint32_t cacheSize)
+{
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles == 0) {
+		return;
+	}
+
+	// 1. 三角形の並びを塊に区切る
+	//    まず3頂点とも変換し直す三角形（前の三角形とつながっていない）の前で大きく区切る
+	VertexCacheSimulator cache(vertices.size(), cacheSize);
+	std::vector<uint32_t> hardBegins;
+	for (size_t triangle = 0; triangle < numTriangles; ++triangle) {
+		const uint32_t* triangleIndices = &indices[triangle * 3];
+		uint32_t misses = cache.Access(triangleIndices[0]) + cache.Access(triangleIndices[1]) + cache.Access(triangleIndices[2]);
+		if (triangle == 0 || misses == 3) {
+			hardBegins.push_back(static_cast<uint32_t>(triangle));
+		}
+	}
+	hardBegins.push_back(static_cast<uint32_t>(numTriangles));
+
+	//    それぞれを、単独で描いたときのACMRのthreshold倍以下になったところで細かく区切る
+	//    （並べ替えた後は塊の境目でキャッシュが空になるので、塊ごとに空のキャッシュから数える）
+	std::vector<uint32_t> clusterBegins;
+	for (size_t h = 0; h + 1 < hardBegins.size(); ++h) {
+		uint32_t hardBegin = hardBegins[h];
+		uint32_t hardEnd = hardBegins[h + 1];
+
+		cache.Flush();
+		uint32_t hardMisses = 0;
+		for (uint32_t i = hardBegin * 3; i < hardEnd * 3; ++i) {
+			hardMisses += cache.Access(indices[i]);
+		}
+		float clusterThreshold = threshold * float(hardMisses) / float(hardEnd - hardBegin);
+
+		size_t firstCluster = clusterBegins.size();
+		clusterBegins.push_back(hardBegin);
+		cache.Flush();
+		uint32_t clusterMisses = 0;
+		uint32_t clusterTriangles = 0;
+		for (uint32_t triangle = hardBegin; triangle < hardEnd; ++triangle) {
+			const uint32_t* triangleIndices = &indices[triangle * 3];
+			clusterMisses += cache.Access(triangleIndices[0]) + cache.Access(triangleIndices[1]) + cache.Access(triangleIndices[2]);
+			++clusterTriangles;
+			if (float(clusterMisses) <= clusterThreshold * float(clusterTriangles)) {
+				clusterBegins.push_back(triangle + 1);
+				cache.Flush();
+				clusterMisses = 0;
+				clusterTriangles = 0;
+			}
+		}
+		// 最後の塊は目標に届かなかった残りなので、1つ前の塊とまとめる
+		if (clusterBegins.back() == hardEnd || clusterBegins.size() - firstCluster > 1) {
+			clusterBegins.pop_back();
+		}
+	}
+	clusterBegins.push_back(static_cast<uint32_t>(numTriangles));
+
+	// 2. 塊ごとに面積で重み付けした中心と法線を求める
+	struct Cluster {
+		uint32_t begin;
+		uint32_t end;
+		Float3 centroid;
+		Float3 normal;
+		float area;
+	};
+	std::vector<Cluster> clusters(clusterBegins.size() - 1);
+	Float3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusters.size(); ++c) {
+		Cluster& cluster = clusters[c];
+		cluster = { clusterBegins[c], clusterBegins[c + 1], { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f };
+		for (uint32_t triangle = cluster.begin; triangle < cluster.end; ++triangle) {
+			const ModelVertex& a = vertices[indices[triangle * 3 + 0]];
+			const ModelVertex& b = vertices[indices[triangle * 3 + 1]];
+			const ModelVertex& c2 = vertices[indices[triangle * 3 + 2]];
+			Float3 pa = ToFloat3(a.position), pb = ToFloat3(b.position), pc = ToFloat3(c2.position);
+			Float3 cross = Cross(pb - pa, pc - pa);
+			float area = sqrtf(Dot(cross, cross)) * 0.5f;
+			// 表の向きは頂点の法線で決める（巻き順の規約によらないように）
+			cluster.normal += (a.normal + b.normal + c2.normal) * area;
+			cluster.centroid += (pa + pb + pc) * (area / 3.0f);
+			cluster.area += area;
+		}
+		meshCentroid += cluster.centroid;
+		meshArea += cluster.area;
+		if (cluster.area > 0.0f) {
+			cluster.centroid = cluster.centroid * (1.0f / cluster.area);
+		}
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid = meshCentroid * (1.0f / meshArea);
+	}
+
+	// 3. メッシュの中心から外を向いている塊ほど手前で他を隠しやすいので先に描く
+	std::vector<float> sortKeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); ++c) {
+		const Cluster& cluster = clusters[c];
+		float normalLength = sqrtf(Dot(cluster.normal, cluster.normal));
+		sortKeys[c] = normalLength > 0.0f ? Dot(cluster.centroid - meshCentroid, cluster.normal) / normalLength : 0.0f;
+	}
+	std::vector<uint32_t> order(clusters.size());
+	for (uint32_t c = 0; c < order.size(); ++c) {
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t c : order) {
+		result.insert(result.end(), indices.begin() + clusters[c].begin * 3, indices.begin() + clusters[c].end * 3);
+	}
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<ModelVertex>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+	std::vector<ModelVertex> result;
+	result.reserve(vertices.size());
+	for (uint32_t& index : indices) {
+		if (remap[index] == UINT32_MAX) {
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(result);
+}
+
+MeshOptimizer::VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+	VertexCacheStatistics statistics;
+	if (indices.empty()) {
+		return statistics;
+	}
+
+	VertexCacheSimulator cache(numVertices, cacheSize);
+	std::vector<uint8_t> referenced(numVertices, 0);
+	size_t numReferenced = 0;
+	for (uint32_t index : indices) {
+		statistics.vertexTransforms += cache.Access(index);
+		if (!referenced[index]) {
+			referenced[index] = 1;
+			++numReferenced;
+		}
+	}
+	statistics.acmr = float(statistics.vertexTransforms) / float(indices.size() / 3);
+	statistics.atvr = float(statistics.vertexTransforms) / float(numReferenced);
+	return statistics;
+}
+
+MeshOptimizer::VertexFetchStatistics MeshOptimizer::AnalyzeVertexFetch(const std::vector<uint32_t>& indices, size_t numVertices, size_t vertexStride)
+{
+	constexpr size_t kLineSize = 64;
+	constexpr size_t kNumLines = 256;
+
+	VertexFetchStatistics statistics;
+	if (indices.empty() || numVertices == 0) {
+		return statistics;
+	}
+
+	std::vector<size_t> lineTags(kNumLines, SIZE_MAX);
+	for (uint32_t index : indices) {
+		size_t firstLine = index * vertexStride / kLineSize;
+		size_t lastLine = ((index + 1) * vertexStride - 1) / kLineSize;
+		for (size_t line = firstLine; line <= lastLine; ++line) {
+			size_t& tag = lineTags[line % kNumLines];
+			if (tag != line) {
+				tag = line;
+				statistics.bytesFetched += static_cast<uint32_t>(kLineSize);
+			}
+		}
+	}
+	statistics.overfetch = float(statistics.bytesFetched) / float(numVertices * vertexStride);
+	return statistics;
+}
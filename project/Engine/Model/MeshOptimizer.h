@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ModelVertex.h"
+
+// インデックス付きメッシュの並べ替え（読み込み時にModelManagerから1度だけ行い、結果はMeshCacheに入る）
+// ・頂点キャッシュ：Tipsifyで、キャッシュに残っている頂点を使う三角形が続くように三角形を並べ替える
+// ・オーバードロー：頂点キャッシュの並びを塊に区切り、外側を向いた塊ほど先に描かれるように塊を並べ替える
+// ・頂点フェッチ：インデックスから初めて参照される順に頂点を並べ替える
+// いずれも三角形の頂点の順（表裏）は変えない
+// 効果はGPUなしで、FIFOキャッシュを真似てACMR・ATVRなどで測る
+class MeshOptimizer
+{
+public:
+	// 頂点キャッシュの大きさ（頂点数）
+	static constexpr uint32_t kCacheSize = 16;
+	// オーバードローの並べ替えで、頂点キャッシュの効率をどこまで落としてよいか（ACMRの倍率）
+	static constexpr float kOverdrawThreshold = 1.05f;
+
+	struct VertexCacheStatistics {
+		uint32_t vertexTransforms = 0; //!< キャッシュに無く変換し直した頂点の数
+		float acmr = 0.0f; //!< 三角形あたりの変換数（0.5～3、小さいほどよい）
+		float atvr = 0.0f; //!< 参照される頂点あたりの変換数（1が最小）
+	};
+
+	struct VertexFetchStatistics {
+		uint32_t bytesFetched = 0; //!< キャッシュラインの単位で読んだバイト数
+		float overfetch = 0.0f; //!< 頂点データの大きさに対する読んだ量（1が最小）
+	};
+
+	// 三角形リストの頂点から、位置・UV・法線が全て一致する頂点をまとめてインデックスを作る
+	// 同じ頂点は最初に現れた順に並ぶ（-0と+0は同じものとして扱う）
+	static void WeldVertices(const std::vector<ModelVertex>& triangleList, std::vector<ModelVertex>* outVertices, std::vector<uint32_t>* outIndices);
+
+	// 頂点キャッシュ・オーバードロー・頂点フェッチの順に並べ替える
+	static void Optimize(std::vector<ModelVertex>& vertices, std::vector<uint32_t>& indices);
+
+	///
+	/// 並べ替え
+	///
+
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize = kCacheSize);
+	// OptimizeVertexCacheの後に呼ぶ
+	static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<ModelVertex>& vertices,
+		float threshold = kOverdrawThreshold, uint32_t cacheSize = kCacheSize);
+	// 参照されない頂点は取り除かれる
+	static void OptimizeVertexFetch(std::vector<ModelVertex>& vertices, std::vector<uint32_t>& indices);
+
+	///
+	/// 統計
+	///
+
+	static VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize = kCacheSize);
+	// 64バイトのラインが256本の直接マップのキャッシュを真似る
+	static VertexFetchStatistics AnalyzeVertexFetch(const std::vector<uint32_t>& indices, size_t numVertices, size_t vertexStride);
+};
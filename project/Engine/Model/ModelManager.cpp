@@ -1,21 +1,271 @@
 #include "ModelManager.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 #include <DirectXUtil.h>
 #include <DirectXBase.h>
+#include <chrono>
+#include <cassert>
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantization.h"
+#include "Logger.h"
 
-ModelManager::ModelData ModelManager::LoadModelFile(const std::string& directoryPath, const std::string& filename, ID3D12Device* device)
+namespace {
+    // 管理するモデルのキー（同じファイルでも形式が違えば別のモデル）
+    std::string MakeModelKey(const std::string& filePath, ModelManager::VertexFormat vertexFormat)
+    {
+        return vertexFormat == ModelManager::VertexFormat::Quantized ? filePath + "|quantized" : filePath;
+    }
+
+    // バッチで新しく読むファイル（同じファイルを複数の形式で読むときも、ファイルは1度だけ読む）
+    struct PendingModel {
+        ModelManager::VertexFormat vertexFormat;
+        std::promise<ModelManager::ModelHandle> promise;
+    };
+    struct PendingFile {
+        std::string directoryPath;
+        std::string filePath;
+        std::vector<PendingModel> models;
+    };
+}
+
+ModelManager& ModelManager::GetInstance()
+{
+    static ModelManager instance;
+    return instance;
+}
+
+void ModelManager::Initialize(uint32_t numLoaders)
+{
+    ModelManager& instance = GetInstance();
+    assert(instance.loaders_.empty());
+
+    if (numLoaders == 0) {
+        numLoaders = (std::max)(std::thread::hardware_concurrency() / 2, 1u);
+    }
+    instance.isQuit_ = false;
+    for (uint32_t i = 0; i < numLoaders; ++i) {
+        instance.loaders_.emplace_back([&instance] { instance.LoaderMain(); });
+    }
+    Log(std::format("ModelManager::Initialize: {} loader threads\n", numLoaders));
+}
+
+void ModelManager::LoaderMain()
+{
+    for (;;) {
+        std::function<void()> load;
+        {
+            std::unique_lock<std::mutex> lock(loadMutex_);
+            loadCondition_.wait(lock, [this] { return isQuit_ || !loadQueue_.empty(); });
+            // 終了するときも、依頼済みのものは読み終える（futureを待っている側がいるため）
+            if (loadQueue_.empty()) {
+                return;
+            }
+            load = std::move(loadQueue_.front());
+            loadQueue_.pop_front();
+        }
+        load();
+    }
+}
+
+std::vector<std::shared_future<ModelManager::ModelHandle>> ModelManager::LoadModelFiles(const std::vector<LoadRequest>& requests)
+{
+    ModelManager& instance = GetInstance();
+    std::vector<std::shared_future<ModelHandle>> results;
+    results.reserve(requests.size());
+    std::vector<PendingFile> pendingFiles;
+    size_t numResident = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(instance.mutex_);
+
+        for (const LoadRequest& request : requests) {
+            std::string filePath = request.directoryPath + "/" + request.filename;
+            std::string key = MakeModelKey(filePath, request.vertexFormat);
+
+            // 読み込み済み・読み込み中ならそれを返す
+            auto it = instance.models_.find(key);
+            if (it != instance.models_.end()) {
+                results.push_back(it->second);
+                ++numResident;
+                continue;
+            }
+
+            // 新しく読むものは先に登録しておき、同じバッチや後のバッチで重複して読まないようにする
+            PendingModel pendingModel{ request.vertexFormat, std::promise<ModelHandle>() };
+            std::shared_future<ModelHandle> future = pendingModel.promise.get_future().share();
+            instance.models_.emplace(key, future);
+            results.push_back(future);
+
+            auto file = std::find_if(pendingFiles.begin(), pendingFiles.end(), [&](const PendingFile& pendingFile) {
+                return pendingFile.filePath == filePath;
+            });
+            if (file == pendingFiles.end()) {
+                pendingFiles.push_back({ request.directoryPath, filePath, {} });
+                file = pendingFiles.end() - 1;
+            }
+            file->models.push_back(std::move(pendingModel));
+        }
+    }
+
+    // ファイルごとに読み込み用のスレッドに渡し、読めたものから順にfutureを完了させる
+    if (!pendingFiles.empty()) {
+        // Initializeで読み込み用のスレッドを起動しておくこと
+        assert(!instance.loaders_.empty());
+        std::lock_guard<std::mutex> lock(instance.loadMutex_);
+        for (PendingFile& pendingFile : pendingFiles) {
+            std::shared_ptr<std::mutex>& fileMutex = instance.fileMutexes_[pendingFile.filePath];
+            if (!fileMutex) {
+                fileMutex = std::make_shared<std::mutex>();
+            }
+            auto file = std::make_shared<PendingFile>(std::move(pendingFile));
+            instance.loadQueue_.push_back([file, fileMutex = fileMutex] {
+                // 同じファイルを別の形式で読んでいる途中なら、それが書き出したMeshCacheを読む
+                std::lock_guard<std::mutex> fileLock(*fileMutex);
+                ModelData modelData = ReadModelFile(file->directoryPath, file->filePath);
+                for (size_t j = 0; j < file->models.size(); ++j) {
+                    // 最後の形式にはCPU側のデータをそのまま渡し、それ以外はコピーする
+                    ModelHandle model = j + 1 < file->models.size()
+                        ? std::make_shared<ModelData>(modelData)
+                        : std::make_shared<ModelData>(std::move(modelData));
+                    CreateBuffers(model.get(), file->models[j].vertexFormat);
+                    file->models[j].promise.set_value(std::move(model));
+                }
+            });
+        }
+        instance.loadCondition_.notify_all();
+    }
+
+    Log(std::format("LoadModelFiles: {} requests, {} resident or loading\n", requests.size(), numResident));
+    return results;
+}
+
+ModelManager::ModelHandle ModelManager::Load(const std::string& directoryPath, const std::string& filename, VertexFormat vertexFormat)
+{
+    return LoadModelFiles({ { directoryPath, filename, vertexFormat } })[0].get();
+}
+
+size_t ModelManager::ReleaseUnused()
+{
+    ModelManager& instance = GetInstance();
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+
+    // 読み込みが終わっていて、管理側の1つしか参照が残っていないものを外す
+    size_t numReleased = std::erase_if(instance.models_, [](const auto& model) {
+        return model.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+            model.second.get().use_count() == 1;
+    });
+
+    Log(std::format("ModelManager::ReleaseUnused: released {}, {} resident\n", numReleased, instance.models_.size()));
+    return numReleased;
+}
+
+void ModelManager::Finalize()
+{
+    ModelManager& instance = GetInstance();
+    {
+        std::lock_guard<std::mutex> lock(instance.loadMutex_);
+        instance.isQuit_ = true;
+    }
+    instance.loadCondition_.notify_all();
+    for (std::thread& loader : instance.loaders_) {
+        loader.join();
+    }
+    instance.loaders_.clear();
+    instance.fileMutexes_.clear();
+
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    instance.models_.clear();
+}
+
+ModelManager::ModelData ModelManager::LoadModelFile(const std::string& directoryPath, const std::string& filename, VertexFormat vertexFormat)
+{
+    ModelData modelData = ReadModelFile(directoryPath, directoryPath + "/" + filename);
+    CreateBuffers(&modelData, vertexFormat);
+    return modelData;
+}
+
+ModelManager::ModelData ModelManager::ReadModelFile(const std::string& directoryPath, const std::string& filePath)
+{
+    auto loadStart = std::chrono::steady_clock::now();
+
+    // キャッシュが元のファイルと一致していればそれを使い、なければassimpで読んでキャッシュを書き出す
+    ModelData modelData;
+    bool fromCache = MeshCache::Load(directoryPath, filePath, &modelData);
+    if (!fromCache) {
+        modelData = ImportModelFile(directoryPath, filePath);
+        MeshCache::Save(directoryPath, filePath, modelData);
+    }
+
+    std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - loadStart;
+    Log(std::format("LoadModelFile {} ({}): {:.3f}ms\n", filePath, fromCache ? "cache" : "import", loadTime.count()));
+    return modelData;
+}
+
+void ModelManager::CreateBuffers(ModelData* modelData, VertexFormat vertexFormat)
+{
+    // vertexResourceの作成（圧縮する場合は16バイト、しない場合は36バイトの頂点）
+    modelData->vertexFormat = vertexFormat;
+    size_t vertexStride = vertexFormat == VertexFormat::Quantized ? sizeof(QuantizedVertexData) : sizeof(VertexData);
+    modelData->vertexResource = CreateBufferResource(DirectXBase::GetInstance()->GetDevice(), vertexStride * modelData->vertices.size());
+
+    // 頂点バッファビューを作成する
+    modelData->vertexBufferView;
+    // リソースの先頭のアドレスから使う
+    modelData->vertexBufferView.BufferLocation = modelData->vertexResource->GetGPUVirtualAddress();
+    // 使用するリソースのサイズは頂点のサイズ
+    modelData->vertexBufferView.SizeInBytes = UINT(vertexStride * modelData->vertices.size());
+    // 1頂点あたりのサイズ
+    modelData->vertexBufferView.StrideInBytes = UINT(vertexStride);
+
+
+    // 頂点リソースにデータを書き込む
+    void* vertexData = nullptr;
+    // 書き込むためのアドレスを取得
+    modelData->vertexResource->Map(0, nullptr, &vertexData);
+    // 頂点データをリソースにコピー
+    if (vertexFormat == VertexFormat::Quantized) {
+        std::vector<QuantizedVertexData> quantizedVertices;
+        VertexQuantization::Quantize(modelData->vertices, modelData->bounds, &quantizedVertices);
+        std::memcpy(vertexData, quantizedVertices.data(), sizeof(QuantizedVertexData) * quantizedVertices.size());
+        Log(std::format("CreateBuffers: quantized vertices {} -> {} bytes\n",
+            sizeof(VertexData) * modelData->vertices.size(), sizeof(QuantizedVertexData) * quantizedVertices.size()));
+    } else {
+        std::memcpy(vertexData, modelData->vertices.data(), sizeof(VertexData) * modelData->vertices.size());
+    }
+
+    // indexResourceの作成（頂点数が収まれば16bitにする）
+    bool use16BitIndices = ModelMesh::CanUse16BitIndices(modelData->vertices.size());
+    size_t indexSize = use16BitIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+    modelData->indexResource = CreateBufferResource(DirectXBase::GetInstance()->GetDevice(), indexSize * modelData->indices.size());
+
+    // インデックスバッファビューを作成する
+    modelData->indexBufferView.BufferLocation = modelData->indexResource->GetGPUVirtualAddress();
+    modelData->indexBufferView.SizeInBytes = UINT(indexSize * modelData->indices.size());
+    modelData->indexBufferView.Format = use16BitIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+    // インデックスリソースにデータを書き込む
+    void* indexData = nullptr;
+    modelData->indexResource->Map(0, nullptr, &indexData);
+    if (use16BitIndices) {
+        uint16_t* indexData16 = static_cast<uint16_t*>(indexData);
+        for (size_t i = 0; i < modelData->indices.size(); ++i) {
+            indexData16[i] = static_cast<uint16_t>(modelData->indices[i]);
+        }
+    } else {
+        std::memcpy(indexData, modelData->indices.data(), sizeof(uint32_t) * modelData->indices.size());
+    }
+}
+
+ModelManager::ModelData ModelManager::ImportModelFile(const std::string& directoryPath, const std::string& filePath)
 {
     // 1. 中で必要となる変数の宣言
     ModelData modelData; // 構築するModelData
-    std::vector<Float4> positions; // 位置
-    std::vector<Float3> normals; // 法線
-    std::vector<Float2> texcoords; // テクスチャ座標
-    std::string line; // ファイルから読んだ1行を格納するもの
+    std::vector<VertexData> triangleList; // 面ごとに展開した頂点
 
     // 2. ファイルを開く
     Assimp::Importer importer;
-    std::string filePath = directoryPath + "/" + filename;
     const aiScene* scene = importer.ReadFile(filePath.c_str(), aiProcess_FlipWindingOrder | aiProcess_FlipUVs);
     assert(scene->HasMeshes()); // メッシュがないのは対応しない
 
@@ -44,11 +294,42 @@ ModelManager::ModelData ModelManager::LoadModelFile(const std::string& directory
                 // aiProcess_MakeLeftHandedはz*=-1で、右手->左手に変換するので手動で対処
                 vertexData.position.x *= -1.0f;
                 vertexData.normal.x *= -1.0f;
-                modelData.vertices.push_back(vertexData);
+                triangleList.push_back(vertexData);
             }
         }
     }
 
+    // 面の間で共有される頂点をまとめてインデックスにする
+    MeshOptimizer::WeldVertices(triangleList, &modelData.vertices, &modelData.indices);
+    size_t indexSize = ModelMesh::CanUse16BitIndices(modelData.vertices.size()) ? sizeof(uint16_t) : sizeof(uint32_t);
+    Log(std::format("ImportModelFile {}: {} -> {} vertices, {} -> {} bytes (with {}bit indices)\n", filePath,
+        triangleList.size(), modelData.vertices.size(), sizeof(VertexData) * triangleList.size(),
+        sizeof(VertexData) * modelData.vertices.size() + indexSize * modelData.indices.size(), indexSize * 8));
+
+    // 頂点キャッシュ・オーバードロー・頂点フェッチのために並べ替える
+    MeshOptimizer::VertexCacheStatistics cacheBefore = MeshOptimizer::AnalyzeVertexCache(modelData.indices, modelData.vertices.size());
+    MeshOptimizer::VertexFetchStatistics fetchBefore = MeshOptimizer::AnalyzeVertexFetch(modelData.indices, modelData.vertices.size(), sizeof(VertexData));
+    MeshOptimizer::Optimize(modelData.vertices, modelData.indices);
+    MeshOptimizer::VertexCacheStatistics cacheAfter = MeshOptimizer::AnalyzeVertexCache(modelData.indices, modelData.vertices.size());
+    MeshOptimizer::VertexFetchStatistics fetchAfter = MeshOptimizer::AnalyzeVertexFetch(modelData.indices, modelData.vertices.size(), sizeof(VertexData));
+    Log(std::format("ImportModelFile {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overfetch {:.3f} -> {:.3f}\n", filePath,
+        cacheBefore.acmr, cacheAfter.acmr, cacheBefore.atvr, cacheAfter.atvr, fetchBefore.overfetch, fetchAfter.overfetch));
+
+    // 頂点の範囲を求めておく（カリング用）
+    modelData.bounds = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+    if (!modelData.vertices.empty()) {
+        const Float4& first = modelData.vertices.front().position;
+        modelData.bounds = { { first.x, first.y, first.z }, { first.x, first.y, first.z } };
+        for (const VertexData& vertex : modelData.vertices) {
+            modelData.bounds.min.x = (std::min)(modelData.bounds.min.x, vertex.position.x);
+            modelData.bounds.min.y = (std::min)(modelData.bounds.min.y, vertex.position.y);
+            modelData.bounds.min.z = (std::min)(modelData.bounds.min.z, vertex.position.z);
+            modelData.bounds.max.x = (std::max)(modelData.bounds.max.x, vertex.position.x);
+            modelData.bounds.max.y = (std::max)(modelData.bounds.max.y, vertex.position.y);
+            modelData.bounds.max.z = (std::max)(modelData.bounds.max.z, vertex.position.z);
+        }
+    }
+
     for (uint32_t materialIndex = 0; materialIndex < scene->mNumMaterials; ++materialIndex) {
         aiMaterial* material = scene->mMaterials[materialIndex];
         if (material->GetTextureCount(aiTextureType_DIFFUSE) != 0) {
@@ -58,26 +339,6 @@ ModelManager::ModelData ModelManager::LoadModelFile(const std::string& directory
         }
     }
 
-    // vertexResourceの作成
-    modelData.vertexResource = CreateBufferResource(DirectXBase::GetInstance()->GetDevice(), sizeof(VertexData) * modelData.vertices.size());
-
-    // 頂点バッファビューを作成する
-    modelData.vertexBufferView;
-    // リソースの先頭のアドレスから使う
-    modelData.vertexBufferView.BufferLocation = modelData.vertexResource->GetGPUVirtualAddress();
-    // 使用するリソースのサイズは頂点のサイズ
-    modelData.vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * modelData.vertices.size());
-    // 1頂点あたりのサイズ
-    modelData.vertexBufferView.StrideInBytes = sizeof(VertexData);
-
-
-    // 頂点リソースにデータを書き込む
-    VertexData* vertexData = nullptr;
-    // 書き込むためのアドレスを取得
-    modelData.vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-    // 頂点データをリソースにコピー
-    std::memcpy(vertexData, modelData.vertices.data(), sizeof(VertexData) * modelData.vertices.size());
-
     // 4. ModelDataを返す
     return modelData;
 }
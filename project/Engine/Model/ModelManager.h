@@ -1,6 +1,14 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <unordered_map>
 #include <d3d12.h>
 
 #include <assimp/Importer.hpp>
@@ -9,41 +17,100 @@
 
 // MyClass
 #include "MyMath.h"
+#include "ModelVertex.h"
+#include "ModelMesh.h"
 #include "TextureManager.h"
 
 class ModelManager
 {
 public:
-	struct VertexData {
-		Float4 position;
-		Float2 texcoord;
-		Float3 normal;
-	};
-
-	struct MaterialData {
-		std::string textureFilePath;
-		uint32_t textureHandle;
-	};
+	// 頂点の型（ModelVertex.h）
+	using VertexData = ModelVertex;
+	using QuantizedVertexData = QuantizedModelVertex;
+	using VertexFormat = ModelVertexFormat;
 
-	struct Node {
-		Matrix localMatrix;
-		std::string name;
-		std::vector<Node> children;
-	};
+	// CPU側のデータの型（ModelMesh.h）
+	using MaterialData = ModelMaterial;
+	using Node = ModelNode;
 
-	struct ModelData {
-		std::vector<VertexData> vertices;
-		MaterialData material;
+	// 読み込んだデータ（ModelMesh）と、それを置いたGPUのリソース
+	struct ModelData : ModelMesh {
+		VertexFormat vertexFormat = VertexFormat::Float;
 		Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource;
 		D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
-		Node rootNode;
+		// GPUのインデックスは頂点数が収まれば16bit、収まらなければ32bit
+		Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
+		D3D12_INDEX_BUFFER_VIEW indexBufferView;
+	};
+
+	// 読み込み済みのモデル（コピーしている間はモデルが解放されない）
+	// 同じファイル・形式を読んだもの同士で共有されるので、中身は書き換えないこと
+	using ModelHandle = std::shared_ptr<ModelData>;
+
+	struct LoadRequest {
+		std::string directoryPath;
+		std::string filename;
+		VertexFormat vertexFormat = VertexFormat::Float;
 	};
 
+	///
+	/// 読み込み済みモデルの管理（ファイルのパスと形式ごとに1つだけ持つ）
+	///
+
+	// 読み込み用のスレッドを起動する（0ならハードウェアのスレッド数の半分、最低1つ）
+	// JobSystemとは別のスレッドなので、読み込み中もParallelForは待たされない
+	static void Initialize(uint32_t numLoaders = 0);
+	// まとめて読み込みを依頼し、requestsと同じ順にfutureを返す
+	// 読み込み済み・読み込み中のものはそれを返し、新しいものは読み込み用のスレッドでファイルごとに並列に読む
+	static std::vector<std::shared_future<ModelHandle>> LoadModelFiles(const std::vector<LoadRequest>& requests);
+	// 1つ読み込み、終わるまで待って返す
+	static ModelHandle Load(const std::string& directoryPath, const std::string& filename, VertexFormat vertexFormat = VertexFormat::Float);
+	// どこからも参照されていないモデルを解放し、解放した数を返す
+	// GPUが使い終わっていること（シーン切り替えの時点では前のフレームの完了を待っている）
+	static size_t ReleaseUnused();
+	// 依頼済みの読み込みを全て終えてから読み込み用のスレッドを終了し、全てのモデルを管理から外す
+	static void Finalize();
+
+	///
+	/// 読み込み処理（管理はしない）
+	///
+
 	// Objファイルの読み込みを行う
-	static ModelData LoadModelFile(const std::string& directoryPath, const std::string& filename, ID3D12Device* device);
+	// 2回目以降は隣に書き出したキャッシュ（MeshCache）から読み、assimpを通さない
+	static ModelData LoadModelFile(const std::string& directoryPath, const std::string& filename, VertexFormat vertexFormat = VertexFormat::Float);
+	// キャッシュかassimpでモデルファイルを読む（GPUのリソースは作らない）
+	static ModelData ReadModelFile(const std::string& directoryPath, const std::string& filePath);
+	// 頂点・インデックスバッファを作って書き込む
+	static void CreateBuffers(ModelData* modelData, VertexFormat vertexFormat);
+	// assimpでモデルファイルを読み、頂点・ノード・マテリアルのパス・範囲を構築する（GPUのリソースは作らない）
+	// 頂点はMeshOptimizer::WeldVerticesでまとめてインデックスにし、MeshOptimizerで並べ替える
+	static ModelData ImportModelFile(const std::string& directoryPath, const std::string& filePath);
 	// mtlファイルの読み込みを行う
 	static MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename, ID3D12Device* device);
 	// assimpのNodeから、Node構造体に変換
 	static Node ReadNode(aiNode* node);
+
+private:
+	static ModelManager& GetInstance();
+
+	// models_を守る
+	std::mutex mutex_;
+	// ファイルのパスと形式をキーにした、読み込み済み・読み込み中のモデル
+	std::unordered_map<std::string, std::shared_future<ModelHandle>> models_;
+
+	// 読み込み用のスレッドの処理
+	void LoaderMain();
+
+	// 読み込み用のスレッド
+	std::vector<std::thread> loaders_;
+	// 以下を守る
+	std::mutex loadMutex_;
+	// 読み込み用のスレッドに新しいファイルか終了を知らせる
+	std::condition_variable loadCondition_;
+	// ファイルごとの読み込み
+	std::deque<std::function<void()>> loadQueue_;
+	// ファイルのパスごとのmutex（同じファイルを同時に読んで、MeshCacheを同時に書き出さないため）
+	std::unordered_map<std::string, std::shared_ptr<std::mutex>> fileMutexes_;
+	bool isQuit_ = false;
 };
 
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MyMath.h"
+#include "ModelVertex.h"
+
+// モデルを読み込んだCPU側のデータ（d3d12やassimpに依存しないので、キャッシュや頂点の処理はこのヘッダーだけで使える）
+// ModelManagerからは MaterialData / Node の名前で使い、ModelDataはこれにGPUのリソースを加えたもの
+
+// マテリアル
+struct ModelMaterial {
+	std::string textureFilePath;
+	uint32_t textureHandle;
+};
+
+// ノードの階層
+struct ModelNode {
+	Matrix localMatrix;
+	std::string name;
+	std::vector<ModelNode> children;
+};
+
+// 頂点・インデックス・ノード・マテリアル・範囲
+struct ModelMesh {
+	// 重複を除いた頂点と、それを3つずつ指して三角形にするインデックス
+	// verticesは形式によらず常に圧縮していないもの（GPUに置く頂点だけがModelVertexFormatに従う）
+	std::vector<ModelVertex> vertices;
+	std::vector<uint32_t> indices;
+	ModelMaterial material;
+	ModelNode rootNode;
+	// ローカル座標での頂点の範囲（カリング用）
+	AABB bounds;
+
+	// インデックスを16bitで持てるか
+	static bool CanUse16BitIndices(size_t numVertices) { return numVertices <= 0x10000; }
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include "MyMath.h"
+
+// モデルの頂点の型（d3d12やassimpに依存しないので、頂点だけを扱う処理はこのヘッダーだけで使える）
+// ModelManagerからは VertexData / QuantizedVertexData / VertexFormat の名前で使う
+
+// 圧縮していない頂点（36バイト）
+struct ModelVertex {
+	Float4 position;
+	Float2 texcoord;
+	Float3 normal;
+};
+
+// 圧縮した頂点（16バイト）
+struct QuantizedModelVertex {
+	uint16_t position[4]; // モデルの範囲を0～1とした位置（R16G16B16A16_UNORM、wは使わない）
+	uint16_t texcoord[2]; // half（R16G16_FLOAT）
+	int16_t normal[2]; // 八面体に写した法線（R16G16_SNORM）
+};
+static_assert(sizeof(QuantizedModelVertex) == 16, "QuantizedModelVertex must match the input layout in Object3dQuantized.VS.hlsl");
+
+// GPUに置く頂点の形式
+enum class ModelVertexFormat {
+	Float, // ModelVertex（36バイト）
+	Quantized, // QuantizedModelVertex（16バイト）。位置はObject3DがWVPに戻す行列を掛けて渡す
+};
@@ -0,0 +1,158 @@
+#include "VertexQuantization.h"
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+namespace {
+	constexpr float kUnorm16Max = 65535.0f;
+	constexpr float kSnorm16Max = 32767.0f;
+
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	uint16_t EncodeUnorm16(float value, float min, float extent)
+	{
+		float t = extent > 0.0f ? (value - min) / extent : 0.0f;
+		return static_cast<uint16_t>(lrintf(std::clamp(t, 0.0f, 1.0f) * kUnorm16Max));
+	}
+
+	float DecodeSnorm16(int16_t value)
+	{
+		return (std::max)(float(value) / kSnorm16Max, -1.0f);
+	}
+}
+
+void VertexQuantization::Quantize(const std::vector<ModelVertex>& vertices, const AABB& bounds,
+	std::vector<QuantizedModelVertex>* outVertices)
+{
+	outVertices->resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		(*outVertices)[i] = Quantize(vertices[i], bounds);
+	}
+}
+
+QuantizedModelVertex VertexQuantization::Quantize(const ModelVertex& vertex, const AABB& bounds)
+{
+	QuantizedModelVertex result;
+	result.position[0] = EncodeUnorm16(vertex.position.x, bounds.min.x, bounds.max.x - bounds.min.x);
+	result.position[1] = EncodeUnorm16(vertex.position.y, bounds.min.y, bounds.max.y - bounds.min.y);
+	result.position[2] = EncodeUnorm16(vertex.position.z, bounds.min.z, bounds.max.z - bounds.min.z);
+	result.position[3] = 0;
+	result.texcoord[0] = FloatToHalf(vertex.texcoord.x);
+	result.texcoord[1] = FloatToHalf(vertex.texcoord.y);
+	EncodeOctahedral(vertex.normal, &result.normal[0], &result.normal[1]);
+	return result;
+}
+
+ModelVertex VertexQuantization::Dequantize(const QuantizedModelVertex& vertex, const AABB& bounds)
+{
+	ModelVertex result;
+	result.position.x = bounds.min.x + float(vertex.position[0]) / kUnorm16Max * (bounds.max.x - bounds.min.x);
+	result.position.y = bounds.min.y + float(vertex.position[1]) / kUnorm16Max * (bounds.max.y - bounds.min.y);
+	result.position.z = bounds.min.z + float(vertex.position[2]) / kUnorm16Max * (bounds.max.z - bounds.min.z);
+	result.position.w = 1.0f;
+	result.texcoord.x = HalfToFloat(vertex.texcoord[0]);
+	result.texcoord.y = HalfToFloat(vertex.texcoord[1]);
+	result.normal = DecodeOctahedral(vertex.normal[0], vertex.normal[1]);
+	return result;
+}
+
+Matrix VertexQuantization::MakeDequantizeMatrix(const AABB& bounds)
+{
+	Matrix result = Matrix::Identity();
+	result.r[0][0] = bounds.max.x - bounds.min.x;
+	result.r[1][1] = bounds.max.y - bounds.min.y;
+	result.r[2][2] = bounds.max.z - bounds.min.z;
+	result.r[3][0] = bounds.min.x;
+	result.r[3][1] = bounds.min.y;
+	result.r[3][2] = bounds.min.z;
+	return result;
+}
+
+uint16_t VertexQuantization::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+	uint32_t absolute = bits & 0x7FFFFFFFu;
+
+	// 無限大とNaN
+	if (absolute >= 0x7F800000u) {
+		return static_cast<uint16_t>(sign | 0x7C00u | (absolute > 0x7F800000u ? 0x0200u : 0u));
+	}
+	// 2^-14未満は非正規化数（2^-24単位）に丸める
+	if (absolute < 0x38800000u) {
+		float magnitude;
+		std::memcpy(&magnitude, &absolute, sizeof(magnitude));
+		return static_cast<uint16_t>(sign | lrintf(magnitude * 16777216.0f));
+	}
+	// 指数の偏りを付け替え、落とす13bitを最近接偶数に丸める（桁上がりで65520以上は無限大になる）
+	uint32_t rebiased = absolute - 0x38000000u;
+	rebiased += 0x0FFFu + ((rebiased >> 13) & 1u);
+	if (rebiased >= 0x0F800000u) {
+		return static_cast<uint16_t>(sign | 0x7C00u);
+	}
+	return static_cast<uint16_t>(sign | (rebiased >> 13));
+}
+
+float VertexQuantization::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = uint32_t(value & 0x8000u) << 16;
+	uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x3FFu;
+
+	if (exponent == 0) {
+		float magnitude = float(mantissa) / 16777216.0f;
+		return sign ? -magnitude : magnitude;
+	}
+	uint32_t bits = exponent == 0x1Fu
+		? sign | 0x7F800000u | (mantissa << 13)
+		: sign | ((exponent + 112u) << 23) | (mantissa << 13);
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void VertexQuantization::EncodeOctahedral(const Float3& normal, int16_t* outX, int16_t* outY)
+{
+	// |x|+|y|+|z|=1の八面体に写し、下半分は外側の三角形に折り返す
+	float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+	float u = length > 0.0f ? normal.x / length : 0.0f;
+	float v = length > 0.0f ? normal.y / length : 0.0f;
+	if (normal.z < 0.0f) {
+		float foldedU = (1.0f - fabsf(v)) * SignNotZero(u);
+		float foldedV = (1.0f - fabsf(u)) * SignNotZero(v);
+		u = foldedU;
+		v = foldedV;
+	}
+
+	// 切り捨てと切り上げの4通りから、戻したときに最も元の向きに近いものを選ぶ
+	float scaledU = std::clamp(u, -1.0f, 1.0f) * kSnorm16Max;
+	float scaledV = std::clamp(v, -1.0f, 1.0f) * kSnorm16Max;
+	float bestDot = -2.0f;
+	for (int i = 0; i < 4; ++i) {
+		int16_t x = static_cast<int16_t>((i & 1) ? ceilf(scaledU) : floorf(scaledU));
+		int16_t y = static_cast<int16_t>((i & 2) ? ceilf(scaledV) : floorf(scaledV));
+		Float3 decoded = DecodeOctahedral(x, y);
+		float dot = decoded.x * normal.x + decoded.y * normal.y + decoded.z * normal.z;
+		if (dot > bestDot) {
+			bestDot = dot;
+			*outX = x;
+			*outY = y;
+		}
+	}
+}
+
+Float3 VertexQuantization::DecodeOctahedral(int16_t x, int16_t y)
+{
+	Float3 result = { DecodeSnorm16(x), DecodeSnorm16(y), 0.0f };
+	result.z = 1.0f - fabsf(result.x) - fabsf(result.y);
+	// 折り返した部分を戻す
+	float fold = (std::max)(-result.z, 0.0f);
+	result.x += result.x >= 0.0f ? -fold : fold;
+	result.y += result.y >= 0.0f ? -fold : fold;
+	float length = sqrtf(result.x * result.x + result.y * result.y + result.z * result.z);
+	return result * (1.0f / length);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "MyMath.h"
+#include "ModelVertex.h"
+
+// ModelVertexとQuantizedModelVertexの変換
+// ・位置はモデルの範囲（AABB）を0～1として16bitのUNORMにする（誤差は軸ごとに範囲の1/131070以下）
+// ・UVはhalfにする（0～1では誤差2^-12以下）
+// ・法線は八面体に写して2つの16bitのSNORMにする（向きの誤差は0.04度以下）
+// 戻す処理はObject3dQuantized.VS.hlslと同じ式で、CPU側では誤差の確認に使う
+class VertexQuantization
+{
+public:
+	// 頂点を圧縮する（boundsは全ての頂点を含むこと）
+	static void Quantize(const std::vector<ModelVertex>& vertices, const AABB& bounds,
+		std::vector<QuantizedModelVertex>* outVertices);
+	static QuantizedModelVertex Quantize(const ModelVertex& vertex, const AABB& bounds);
+	static ModelVertex Dequantize(const QuantizedModelVertex& vertex, const AABB& bounds);
+
+	// 0～1の位置をモデルの座標に戻す行列（WVPの前に掛ける）
+	static Matrix MakeDequantizeMatrix(const AABB& bounds);
+
+	///
+	/// 要素ごとの変換
+	///
+
+	// 最も近い値に丸める（範囲外は無限大、小さすぎる値は非正規化数か0）
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t value);
+
+	// 正規化した法線を八面体に写す
+	static void EncodeOctahedral(const Float3& normal, int16_t* outX, int16_t* outY);
+	static Float3 DecodeOctahedral(int16_t x, int16_t y);
+};
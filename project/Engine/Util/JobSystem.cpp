@@ -0,0 +1,140 @@
+#include "JobSystem.h"
+#include <cassert>
+
+namespace {
+	// ジョブを実行中のスレッドか（ジョブ内からのParallelForを入れ子にしないため）
+	thread_local bool tIsInJob = false;
+}
+
+JobSystem* JobSystem::GetInstance()
+{
+	static JobSystem instance;
+	return &instance;
+}
+
+JobSystem::~JobSystem()
+{
+	Finalize();
+}
+
+void JobSystem::Initialize(uint32_t numWorkers)
+{
+	assert(workers_.empty()); // 二重に初期化しない
+
+	if (numWorkers == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	isQuit_ = false;
+	for (uint32_t i = 0; i < numWorkers; ++i) {
+		workers_.emplace_back(&JobSystem::WorkerMain, this);
+	}
+}
+
+void JobSystem::Finalize()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isQuit_ = true;
+	}
+	jobCondition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, const ChunkFunction& function)
+{
+	assert(chunkSize > 0);
+	size_t numChunks = GetChunkCount(count, chunkSize);
+	if (numChunks == 0) {
+		return;
+	}
+
+	// ワーカーがいない、チャンクが1つだけ、ジョブの中から呼ばれた場合はその場で処理する
+	if (workers_.empty() || numChunks == 1 || tIsInJob) {
+		for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+			size_t begin = chunk * chunkSize;
+			size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+			function(begin, end, chunk);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+
+	// ジョブを登録してワーカーを起こす
+	Job job = { &function, count, chunkSize, numChunks };
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job_ = job;
+		nextChunk_ = 0;
+		numDoneChunks_ = 0;
+		++generation_;
+	}
+	jobCondition_.notify_all();
+
+	// 呼び出し元のスレッドも処理に参加する
+	ProcessChunks(job);
+
+	// 全チャンクが終わり、参加したワーカーが全員ジョブから抜けるまで待つ
+	// 抜ける前に次のジョブを登録すると、ワーカーが古いジョブの続きとして新しいチャンクを取ってしまう
+	std::unique_lock<std::mutex> lock(mutex_);
+	doneCondition_.wait(lock, [&] { return numDoneChunks_.load() == numChunks && numActiveWorkers_ == 0; });
+	// これ以降に起きたワーカーは参加しない（functionは呼び出し元のものなので、ここで手放す）
+	job_.function = nullptr;
+}
+
+void JobSystem::WorkerMain()
+{
+	uint64_t lastGeneration = 0;
+	while (true) {
+		// ジョブの内容は登録したときのものを写して使う（ロックの外で共有の値を読まない）
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobCondition_.wait(lock, [&] { return isQuit_ || generation_ != lastGeneration; });
+			if (isQuit_) {
+				return;
+			}
+			lastGeneration = generation_;
+			// 起きるのが遅れ、既に終わったジョブには参加しない
+			if (job_.function == nullptr) {
+				continue;
+			}
+			job = job_;
+			++numActiveWorkers_;
+		}
+
+		ProcessChunks(job);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--numActiveWorkers_;
+		}
+		doneCondition_.notify_all();
+	}
+}
+
+void JobSystem::ProcessChunks(const Job& job)
+{
+	tIsInJob = true;
+
+	size_t numProcessed = 0;
+	while (true) {
+		size_t chunk = nextChunk_.fetch_add(1);
+		if (chunk >= job.numChunks) {
+			break;
+		}
+		size_t begin = chunk * job.chunkSize;
+		size_t end = begin + job.chunkSize < job.count ? begin + job.chunkSize : job.count;
+		(*job.function)(begin, end, chunk);
+		++numProcessed;
+	}
+
+	tIsInJob = false;
+
+	numDoneChunks_.fetch_add(numProcessed);
+}
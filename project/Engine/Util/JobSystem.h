@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// ワーカースレッドのプール
+// ParallelForで範囲を固定サイズのチャンクに分け、ワーカーと呼び出し元のスレッドで分担して処理する
+// チャンクの分け方はスレッド数によらないので、チャンクごとに結果を書き分ければ結果も決定的になる
+class JobSystem
+{
+public:
+	// チャンクを処理する関数（[begin, end)とチャンク番号を受け取る）
+	using ChunkFunction = std::function<void(size_t begin, size_t end, size_t chunkIndex)>;
+
+	static JobSystem* GetInstance();
+
+	// ワーカースレッドを起動する（0ならハードウェアのスレッド数 - 1）
+	void Initialize(uint32_t numWorkers = 0);
+	// ワーカースレッドを終了させる
+	void Finalize();
+
+	// 呼び出し元を含めた、処理に参加するスレッド数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+	// [0, count)をchunkSizeずつに分けて並列に処理し、全て終わるまで待つ
+	// ジョブの中から呼んだ場合や、ワーカーがいない場合はその場で順番に処理する
+	void ParallelFor(size_t count, size_t chunkSize, const ChunkFunction& function);
+
+	// チャンク数
+	static size_t GetChunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+
+private:
+	JobSystem() = default;
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// ParallelFor1回分のジョブ
+	struct Job {
+		const ChunkFunction* function = nullptr; // 終わったジョブはnullptr
+		size_t count = 0;
+		size_t chunkSize = 0;
+		size_t numChunks = 0;
+	};
+
+	// ワーカースレッドの処理
+	void WorkerMain();
+	// ジョブのチャンクを取れるだけ取って処理する
+	void ProcessChunks(const Job& job);
+
+	std::vector<std::thread> workers_;
+
+	std::mutex mutex_;
+	// ワーカーに新しいジョブを知らせる
+	std::condition_variable jobCondition_;
+	// 呼び出し元にジョブの完了を知らせる
+	std::condition_variable doneCondition_;
+	// ParallelForを同時に1つだけにする
+	std::mutex dispatchMutex_;
+
+	// 現在のジョブ（mutex_の中で読み書きする）
+	Job job_;
+	// 現在のジョブに参加しているワーカーの数（mutex_の中で読み書きする）
+	uint32_t numActiveWorkers_ = 0;
+	std::atomic<size_t> nextChunk_ = 0;
+	std::atomic<size_t> numDoneChunks_ = 0;
+	// ジョブが発行されるたびに増える（ワーカーが新しいジョブかを判定する）
+	uint64_t generation_ = 0;
+	bool isQuit_ = false;
+};
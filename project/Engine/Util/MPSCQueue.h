@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// 複数のスレッドから積み、1つのスレッドだけが取り出す固定長のロックフリーキュー
+// ・要素ごとに番号（sequence）を持たせ、積む側は書き込み位置をCASで取り合う（ロックを取らない）
+// ・番号が書き込み済みを示すまで取り出されないので、書き込み途中の要素を読むことはない
+// ・容量は2の累乗で固定。満杯のときTryPushはfalseを返す（確保し直さない）
+template<class Type>
+class MPSCQueue
+{
+public:
+	explicit MPSCQueue(size_t capacity) : capacity_(capacity), mask_(capacity - 1), cells_(new Cell[capacity])
+	{
+		assert(capacity >= 2 && (capacity & (capacity - 1)) == 0); // 2の累乗
+		for (size_t i = 0; i < capacity; ++i) {
+			cells_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// 積む（どのスレッドから呼んでもよい）。満杯ならfalse
+	bool TryPush(const Type& value)
+	{
+		size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;) {
+			cell = &cells_[position & mask_];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+			if (difference == 0) {
+				// 空いている。他のスレッドより先に位置を取れたら書き込む
+				if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (difference < 0) {
+				// 1周前の要素がまだ取り出されていない
+				return false;
+			} else {
+				// 他のスレッドに先を越された
+				position = enqueuePosition_.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = value;
+		// 書き込み済みにする（取り出す側はこの番号を見てから読む）
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 取り出す（1つのスレッドからだけ呼ぶこと）。空ならfalse
+	bool TryPop(Type& out)
+	{
+		Cell& cell = cells_[dequeuePosition_ & mask_];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		if (sequence != dequeuePosition_ + 1) {
+			return false;
+		}
+		out = cell.value;
+		// 次の周で書き込めるようにする
+		cell.sequence.store(dequeuePosition_ + capacity_, std::memory_order_release);
+		++dequeuePosition_;
+		return true;
+	}
+
+	size_t GetCapacity() const { return capacity_; }
+
+	// コピー不可にする
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		Type value;
+	};
+
+	// 積む側と取り出す側が同じキャッシュラインを取り合わないように分ける
+	static constexpr size_t kCacheLineSize = 64;
+
+	const size_t capacity_;
+	const size_t mask_;
+	std::unique_ptr<Cell[]> cells_;
+
+	alignas(kCacheLineSize) std::atomic<size_t> enqueuePosition_ = 0;
+	alignas(kCacheLineSize) size_t dequeuePosition_ = 0;
+};
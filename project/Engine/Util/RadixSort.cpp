@@ -0,0 +1,147 @@
+#include "RadixSort.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "JobSystem.h"
+
+uint32_t RadixSort::FloatToKey(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	// 正の値は符号bitを立て、負の値は全bitを反転する（負の値は絶対値が大きいほど小さくなる）
+	uint32_t mask = (bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+	return bits ^ mask;
+}
+
+void RadixSort::Sort(uint32_t* keys, uint32_t* values, size_t count, uint32_t* tempKeys, uint32_t* tempValues)
+{
+	if (count < 2) {
+		return;
+	}
+
+	// 1回読むだけで全パス分の桁ごとの数を数える
+	uint32_t histograms[kNumPasses][kRadixSize] = {};
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t key = keys[i];
+		for (uint32_t pass = 0; pass < kNumPasses; ++pass) {
+			++histograms[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)];
+		}
+	}
+
+	uint32_t* sourceKeys = keys;
+	uint32_t* sourceValues = values;
+	uint32_t* destKeys = tempKeys;
+	uint32_t* destValues = tempValues;
+
+	for (uint32_t pass = 0; pass < kNumPasses; ++pass) {
+		uint32_t shift = pass * kRadixBits;
+		uint32_t* histogram = histograms[pass];
+
+		// 全てのキーがこの桁で同じなら並びは変わらない
+		if (histogram[(sourceKeys[0] >> shift) & (kRadixSize - 1)] == count) {
+			continue;
+		}
+
+		// 桁ごとの書き込み開始位置（数の累積和）
+		uint32_t offset = 0;
+		for (uint32_t digit = 0; digit < kRadixSize; ++digit) {
+			uint32_t numDigit = histogram[digit];
+			histogram[digit] = offset;
+			offset += numDigit;
+		}
+
+		for (size_t i = 0; i < count; ++i) {
+			uint32_t key = sourceKeys[i];
+			uint32_t position = histogram[(key >> shift) & (kRadixSize - 1)]++;
+			destKeys[position] = key;
+			destValues[position] = sourceValues[i];
+		}
+
+		std::swap(sourceKeys, destKeys);
+		std::swap(sourceValues, destValues);
+	}
+
+	// 奇数回並べ替えた場合は作業領域に結果があるので戻す
+	if (sourceKeys != keys) {
+		std::copy_n(sourceKeys, count, keys);
+		std::copy_n(sourceValues, count, values);
+	}
+}
+
+void RadixSort::SortParallel(uint32_t* keys, uint32_t* values, size_t count, uint32_t* tempKeys, uint32_t* tempValues, size_t blockSize)
+{
+	size_t numBlocks = JobSystem::GetChunkCount(count, blockSize);
+	if (numBlocks <= 1) {
+		Sort(keys, values, count, tempKeys, tempValues);
+		return;
+	}
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+
+	// ブロックごと・桁ごとの数と書き込み位置（毎回確保しないように使い回す）
+	// thread_localなので、ジョブの中からは呼び出し元の配列をポインタで参照する
+	thread_local std::vector<uint32_t> blockOffsetStorage;
+	blockOffsetStorage.resize(numBlocks * kRadixSize);
+	uint32_t* blockOffsets = blockOffsetStorage.data();
+
+	uint32_t* sourceKeys = keys;
+	uint32_t* sourceValues = values;
+	uint32_t* destKeys = tempKeys;
+	uint32_t* destValues = tempValues;
+
+	for (uint32_t pass = 0; pass < kNumPasses; ++pass) {
+		uint32_t shift = pass * kRadixBits;
+
+		// ブロックごとに桁の数を数える
+		jobSystem->ParallelFor(count, blockSize, [&](size_t begin, size_t end, size_t block) {
+			uint32_t* histogram = blockOffsets + block * kRadixSize;
+			std::fill_n(histogram, kRadixSize, 0u);
+			for (size_t i = begin; i < end; ++i) {
+				++histogram[(sourceKeys[i] >> shift) & (kRadixSize - 1)];
+			}
+		});
+
+		// 全てのキーがこの桁で同じなら並びは変わらない
+		uint32_t firstDigit = (sourceKeys[0] >> shift) & (kRadixSize - 1);
+		size_t numFirstDigit = 0;
+		for (size_t block = 0; block < numBlocks; ++block) {
+			numFirstDigit += blockOffsets[block * kRadixSize + firstDigit];
+		}
+		if (numFirstDigit == count) {
+			continue;
+		}
+
+		// 桁の小さい順、同じ桁ではブロックの順に書き込み位置を割り当てる（安定になる）
+		uint32_t offset = 0;
+		for (uint32_t digit = 0; digit < kRadixSize; ++digit) {
+			for (size_t block = 0; block < numBlocks; ++block) {
+				uint32_t& entry = blockOffsets[block * kRadixSize + digit];
+				uint32_t numDigit = entry;
+				entry = offset;
+				offset += numDigit;
+			}
+		}
+
+		// ブロックごとに割り当てられた位置へ書き込む
+		jobSystem->ParallelFor(count, blockSize, [&](size_t begin, size_t end, size_t block) {
+			uint32_t* positions = blockOffsets + block * kRadixSize;
+			for (size_t i = begin; i < end; ++i) {
+				uint32_t key = sourceKeys[i];
+				uint32_t position = positions[(key >> shift) & (kRadixSize - 1)]++;
+				destKeys[position] = key;
+				destValues[position] = sourceValues[i];
+			}
+		});
+
+		std::swap(sourceKeys, destKeys);
+		std::swap(sourceValues, destValues);
+	}
+
+	// 奇数回並べ替えた場合は作業領域に結果があるので戻す
+	if (sourceKeys != keys) {
+		jobSystem->ParallelFor(count, blockSize, [&](size_t begin, size_t end, size_t) {
+			std::copy(sourceKeys + begin, sourceKeys + end, keys + begin);
+			std::copy(sourceValues + begin, sourceValues + end, values + begin);
+		});
+	}
+}
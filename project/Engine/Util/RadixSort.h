@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 32bitのキーと値の組を、キーの昇順に並べる基数ソート（LSD、8bitずつ4パス）
+// ・安定ソートなので、同じキー同士は元の順番のまま
+// ・全てのキーで同じ桁のパスは省略する
+// ・floatはFloatToKeyで大小関係を保った整数にしてから渡す
+class RadixSort
+{
+public:
+	// floatを大小関係が同じになる32bitの整数にする（負の値やinfも含めて正しく並ぶ）
+	static uint32_t FloatToKey(float value);
+	// 降順に並べたい場合は、キーをこれで反転してから昇順に並べる
+	static uint32_t InvertKey(uint32_t key) { return ~key; }
+
+	// keys, valuesを並べ替える
+	// tempKeys, tempValuesはcount個分の作業領域（内容は壊れる）
+	static void Sort(uint32_t* keys, uint32_t* values, size_t count, uint32_t* tempKeys, uint32_t* tempValues);
+
+	// Sortと同じ結果を、blockSizeずつのブロックに分けてJobSystemで並列に求める
+	// ブロックの分け方はスレッド数によらない
+	static void SortParallel(uint32_t* keys, uint32_t* values, size_t count, uint32_t* tempKeys, uint32_t* tempValues,
+		size_t blockSize = kDefaultBlockSize);
+
+	// SortParallelで1つのジョブが受け持つ要素数の既定値
+	static constexpr size_t kDefaultBlockSize = 16384;
+
+private:
+	// 1パスで見るbit数と桁の種類
+	static constexpr uint32_t kRadixBits = 8;
+	static constexpr uint32_t kRadixSize = 1u << kRadixBits;
+	static constexpr uint32_t kNumPasses = 32 / kRadixBits;
+};
@@ -0,0 +1,234 @@
+#include "ForceFieldSystem.h"
+#include <cassert>
+#include <algorithm>
+#include <math.h>
+#include "ParticleStorage.h"
+#include "SimdMath.h"
+
+namespace {
+	// Attractorの中心付近で加速度が発散しないように足す値
+	constexpr float kAttractorSoftening = 0.01f;
+
+	// 4つ分の位置と速度から、速度の変化量（加速度 * deltaTime）を求める
+	// 範囲外の要素も計算するが、呼び出し側でマスクして捨てる
+	struct FieldBatch {
+		Simd::Vec4 px, py, pz;
+		Simd::Vec4 vx, vy, vz;
+	};
+
+	void ComputeVelocityDelta(const ForceFieldSystem::Field& field, const FieldBatch& b, float deltaTime,
+		Simd::Vec4* outX, Simd::Vec4* outY, Simd::Vec4* outZ)
+	{
+		using namespace Simd;
+		using Type = ForceFieldSystem::Type;
+
+		switch (field.type) {
+		case Type::Gravity:
+			*outX = Set1(field.vector.x * deltaTime);
+			*outY = Set1(field.vector.y * deltaTime);
+			*outZ = Set1(field.vector.z * deltaTime);
+			break;
+		case Type::Attractor: {
+			// 中心への向き * strength / 距離^2
+			Vec4 dx = Sub(Set1(field.center.x), b.px);
+			Vec4 dy = Sub(Set1(field.center.y), b.py);
+			Vec4 dz = Sub(Set1(field.center.z), b.pz);
+			Vec4 distanceSq = Add(MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz))), Set1(kAttractorSoftening));
+			Vec4 scale = Div(Set1(field.strength * deltaTime), Mul(distanceSq, Sqrt(distanceSq)));
+			*outX = Mul(dx, scale);
+			*outY = Mul(dy, scale);
+			*outZ = Mul(dz, scale);
+			break;
+		}
+		case Type::Vortex: {
+			// axis × (p - center) の向きに回す
+			Vec4 rx = Sub(b.px, Set1(field.center.x));
+			Vec4 ry = Sub(b.py, Set1(field.center.y));
+			Vec4 rz = Sub(b.pz, Set1(field.center.z));
+			Vec4 ax = Set1(field.vector.x * field.strength * deltaTime);
+			Vec4 ay = Set1(field.vector.y * field.strength * deltaTime);
+			Vec4 az = Set1(field.vector.z * field.strength * deltaTime);
+			*outX = Sub(Mul(ay, rz), Mul(az, ry));
+			*outY = Sub(Mul(az, rx), Mul(ax, rz));
+			*outZ = Sub(Mul(ax, ry), Mul(ay, rx));
+			break;
+		}
+		case Type::Drag: {
+			// 1フレームで速度が反転しないように、減らす割合は1までにする
+			Vec4 k = Set1(-(std::min)(field.strength * deltaTime, 1.0f));
+			*outX = Mul(b.vx, k);
+			*outY = Mul(b.vy, k);
+			*outZ = Mul(b.vz, k);
+			break;
+		}
+		case Type::Turbulence: {
+			// 各軸を別の軸のsin/cosで回す、発散の少ない簡易な乱流
+			Vec4 frequency = Set1(field.frequency);
+			Vec4 sinX, cosX, sinY, cosY, sinZ, cosZ;
+			SinCos(Mul(b.px, frequency), &sinX, &cosX);
+			SinCos(Mul(b.py, frequency), &sinY, &cosY);
+			SinCos(Mul(b.pz, frequency), &sinZ, &cosZ);
+			Vec4 scale = Set1(field.strength * deltaTime);
+			*outX = Mul(Mul(sinY, cosZ), scale);
+			*outY = Mul(Mul(sinZ, cosX), scale);
+			*outZ = Mul(Mul(sinX, cosY), scale);
+			break;
+		}
+		}
+	}
+}
+
+ForceFieldSystem::Handle ForceFieldSystem::Add(const Field& field)
+{
+	needsBuild_ = true;
+	// 削除済みの番号があれば使い回す
+	if (!freeHandles_.empty()) {
+		Handle handle = freeHandles_.back();
+		freeHandles_.pop_back();
+		fields_[handle] = field;
+		alive_[handle] = 1;
+		return handle;
+	}
+	fields_.push_back(field);
+	alive_.push_back(1);
+	return static_cast<Handle>(fields_.size() - 1);
+}
+
+void ForceFieldSystem::Remove(Handle handle)
+{
+	assert(handle < fields_.size() && alive_[handle]);
+	alive_[handle] = 0;
+	freeHandles_.push_back(handle);
+	needsBuild_ = true;
+}
+
+void ForceFieldSystem::Set(Handle handle, const Field& field)
+{
+	assert(handle < fields_.size() && alive_[handle]);
+	fields_[handle] = field;
+	needsBuild_ = true;
+}
+
+const ForceFieldSystem::Field& ForceFieldSystem::Get(Handle handle) const
+{
+	assert(handle < fields_.size() && alive_[handle]);
+	return fields_[handle];
+}
+
+void ForceFieldSystem::Clear()
+{
+	fields_.clear();
+	alive_.clear();
+	freeHandles_.clear();
+	needsBuild_ = true;
+}
+
+void ForceFieldSystem::Build()
+{
+	if (!needsBuild_) {
+		return;
+	}
+	needsBuild_ = false;
+
+	// Fieldの範囲を木に登録し直す（削除済みの番号は登録しない）
+	tree_.Clear();
+	for (size_t index = 0; index < fields_.size(); ++index) {
+		if (alive_[index]) {
+			tree_.Insert(fields_[index].bounds, static_cast<uint32_t>(index));
+		}
+	}
+	tree_.Build();
+}
+
+void ForceFieldSystem::Query(const AABB& bounds, std::vector<uint32_t>& out) const
+{
+	assert(!needsBuild_);
+	out.clear();
+	tree_.QueryAABB(bounds, out);
+	// 登録順に並べる（適用する順番が木の形によらないように）
+	std::sort(out.begin(), out.end());
+}
+
+void ForceFieldSystem::Apply(ParticleStorage& particles, size_t begin, size_t end, float deltaTime) const
+{
+	if (begin >= end) {
+		return;
+	}
+
+	// 区間のパーティクルを囲む範囲と重なるFieldだけを評価する
+	thread_local std::vector<uint32_t> candidates;
+	Query(particles.ComputeBounds(begin, end), candidates);
+
+	for (uint32_t index : candidates) {
+		ApplyField(fields_[index], particles, begin, end, deltaTime);
+	}
+}
+
+void ForceFieldSystem::ApplyField(const Field& field, ParticleStorage& particles, size_t begin, size_t end, float deltaTime)
+{
+	using namespace Simd;
+
+	const Vec4 minX = Set1(field.bounds.min.x), minY = Set1(field.bounds.min.y), minZ = Set1(field.bounds.min.z);
+	const Vec4 maxX = Set1(field.bounds.max.x), maxY = Set1(field.bounds.max.y), maxZ = Set1(field.bounds.max.z);
+
+	// 4つ分の位置と速度を読み、範囲内の要素の速度を書き換える
+	// sourceは位置XYZ・速度XYZの順、velocityは書き込み先の速度XYZ
+	auto applyBatch = [&](const float* const* source, float* const* velocity) {
+		FieldBatch batch = {
+			Load(source[0]), Load(source[1]), Load(source[2]),
+			Load(source[3]), Load(source[4]), Load(source[5]),
+		};
+
+		// 範囲内の要素だけ立ったマスク（1つも入っていなければ何もしない）
+		Mask4 inside = And(
+			And(
+				And(CmpGe(batch.px, minX), CmpLe(batch.px, maxX)),
+				And(CmpGe(batch.py, minY), CmpLe(batch.py, maxY))),
+			And(CmpGe(batch.pz, minZ), CmpLe(batch.pz, maxZ)));
+		if (MoveMask(inside) == 0) {
+			return;
+		}
+
+		Vec4 deltaX = Zero(), deltaY = Zero(), deltaZ = Zero();
+		ComputeVelocityDelta(field, batch, deltaTime, &deltaX, &deltaY, &deltaZ);
+
+		// 範囲外の要素は0を足す
+		Vec4 zero = Zero();
+		Store(velocity[0], Simd::Add(batch.vx, Select(inside, deltaX, zero)));
+		Store(velocity[1], Simd::Add(batch.vy, Select(inside, deltaY, zero)));
+		Store(velocity[2], Simd::Add(batch.vz, Select(inside, deltaZ, zero)));
+	};
+
+	float* streams[6] = {
+		particles.positionX.data(), particles.positionY.data(), particles.positionZ.data(),
+		particles.velocityX.data(), particles.velocityY.data(), particles.velocityZ.data(),
+	};
+
+	// 4つずつ処理
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		const float* source[6] = { streams[0] + i, streams[1] + i, streams[2] + i, streams[3] + i, streams[4] + i, streams[5] + i };
+		float* velocity[3] = { streams[3] + i, streams[4] + i, streams[5] + i };
+		applyBatch(source, velocity);
+	}
+
+	// 端数は一時配列に詰めて同じ計算で処理する
+	// 空きの要素は範囲外の位置にしておき、マスクで除外されるようにする
+	if (i < end) {
+		size_t rest = end - i;
+		float tail[6][4];
+		for (size_t stream = 0; stream < 6; ++stream) {
+			for (size_t lane = 0; lane < 4; ++lane) {
+				tail[stream][lane] = lane < rest ? streams[stream][i + lane] : (stream < 3 ? NAN : 0.0f);
+			}
+		}
+		const float* source[6] = { tail[0], tail[1], tail[2], tail[3], tail[4], tail[5] };
+		float* velocity[3] = { tail[3], tail[4], tail[5] };
+		applyBatch(source, velocity);
+		for (size_t axis = 0; axis < 3; ++axis) {
+			for (size_t lane = 0; lane < rest; ++lane) {
+				streams[3 + axis][i + lane] = tail[3 + axis][lane];
+			}
+		}
+	}
+}
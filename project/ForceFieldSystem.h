@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+#include "AABBTree.h"
+
+class ParticleStorage;
+
+// パーティクルの速度を変える場（Field）の一覧
+// ・Fieldは範囲（AABB）を持ち、範囲内のパーティクルにだけ作用する
+// ・範囲をAABBTree（ParticleCollisionSystemと同じ）に登録しておき、パーティクルの区間の範囲と重なるFieldだけを評価する
+//   問い合わせは毎フレーム区間の数だけ行い、作り直しは登録内容が変わったときだけなので、
+//   作り直しの速い一様グリッドより、問い合わせの速さがセルの大きさに左右されない木を使う
+//   （範囲が無限のFieldは木の外に置かれ、常に候補になる）
+// ・評価は要素ごとの配列に対して4つずつSIMDで行い、範囲の判定はマスクで行う
+class ForceFieldSystem
+{
+public:
+	enum class Type {
+		Gravity,	// 一様な加速度 vector
+		Attractor,	// centerへ引き寄せる（距離の2乗に反比例、strengthが負なら反発）
+		Vortex,		// centerを通るaxis周りに回す（centerからの距離に比例）
+		Drag,		// 速度に比例して減速する（strengthが減衰係数）
+		Turbulence,	// 位置に応じて向きが変わる乱流（frequencyが細かさ）
+	};
+
+	struct Field {
+		Type type = Type::Gravity;
+		AABB bounds; //!< 範囲
+		Float3 vector = { 0.0f, 0.0f, 0.0f }; //!< Gravity: 加速度 / Vortex: 回転軸（正規化済み）
+		Float3 center = { 0.0f, 0.0f, 0.0f }; //!< Attractor, Vortex: 中心
+		float strength = 0.0f; //!< Attractor, Vortex, Drag, Turbulence: 強さ
+		float frequency = 1.0f; //!< Turbulence: 空間的な細かさ
+	};
+
+	// Fieldを指す番号（Removeするまで変わらない）
+	using Handle = uint32_t;
+
+	///
+	/// 登録
+	///
+
+	Handle Add(const Field& field);
+	void Remove(Handle handle);
+	// 登録済みのFieldを書き換える
+	void Set(Handle handle, const Field& field);
+	const Field& Get(Handle handle) const;
+	void Clear();
+	// 登録されているFieldの数
+	size_t Size() const { return fields_.size() - freeHandles_.size(); }
+
+	// 登録内容が変わっていれば木を作り直す
+	// Applyを並列に呼ぶ前に、1つのスレッドから呼ぶこと
+	void Build();
+
+	///
+	/// 評価
+	///
+
+	// [begin, end) のパーティクルの範囲と重なるFieldを集め、速度をdeltaTime分だけ変える
+	// Build後であれば複数のスレッドから同時に呼んでよい
+	void Apply(ParticleStorage& particles, size_t begin, size_t end, float deltaTime) const;
+
+	// boundsと重なるFieldの番号を小さい順にoutへ集める（outは先にクリアされる）
+	void Query(const AABB& bounds, std::vector<uint32_t>& out) const;
+
+private:
+	// 1つのFieldを区間に適用する
+	static void ApplyField(const Field& field, ParticleStorage& particles, size_t begin, size_t end, float deltaTime);
+
+	std::vector<Field> fields_;
+	std::vector<uint8_t> alive_;
+	std::vector<Handle> freeHandles_;
+
+	// Fieldの範囲を登録した木
+	AABBTree tree_;
+	bool needsBuild_ = false;
+};
@@ -32,6 +32,12 @@ void Framework::Initialize()
     // ImGuiの初期化
     ImguiWrapper::Initialize(dxBase->GetDevice(), dxBase->GetSwapChainDesc().BufferCount, dxBase->GetRtvDesc().Format, srvManager->descriptorHeap.heap_.Get());
 
+    // ジョブシステムの初期化（ワーカースレッドの起動）
+    JobSystem::GetInstance()->Initialize();
+
+    // モデルの読み込み用スレッドの起動（JobSystemのワーカーとは別）
+    ModelManager::Initialize();
+
     // ParticleManagerの生成と初期化
     particleManager = new ParticleManager;
     particleManager->Initialize(dxBase, srvManager);
@@ -52,6 +58,11 @@ void Framework::Finalize()
     // SoundManager開放
     delete soundManager;
 
+    // モデルの読み込みを待ち、読み込み用スレッドを終了して管理から外す
+    ModelManager::Finalize();
+    // ジョブシステムの終了処理
+    JobSystem::GetInstance()->Finalize();
+
     // ImGuiの終了処理
     ImguiWrapper::Finalize();
     // COMの終了処理
@@ -66,6 +77,9 @@ void Framework::Update()
         return;
     }
 
+    // フレーム統計のリセット
+    FrameStats::GetInstance()->BeginFrame();
+
     // 入力の更新
     Input::GetInstance()->Update();
     // フレーム開始処理
@@ -8,6 +8,8 @@
 // MyClass 
 #include "MyWindow.h"
 #include "Logger.h"
+#include "FrameStats.h"
+#include "JobSystem.h"
 #include "StringUtil.h"
 #include "DirectXBase.h"
 #include "DirectXUtil.h"
@@ -1,5 +1,6 @@
 #include "GamePlayScene.h"
 #include "ImguiWrapper.h"
+#include "FrameStats.h"
 #include "DirectXBase.h"
 #include "SRVManager.h"
 #include "SpriteCommon.h"
@@ -28,15 +29,16 @@ void GamePlayScene::Initialize()
 	///	
 	
 	// Texture読み込み
-	uint32_t uvCheckerGH = TextureManager::Load("resources/Images/uvChecker.png", dxBase->GetDevice());
+	uvCheckerGH_ = TextureManager::Load("resources/Images/uvChecker.png", dxBase->GetDevice());
 	
 	// モデル読み込み
-	model_ = ModelManager::LoadModelFile("resources/Models", "plane.gltf", dxBase->GetDevice());
-	model_.material.textureHandle = uvCheckerGH;
+	model_ = ModelManager::Load("resources/Models", "plane.gltf");
 
 	// 3Dオブジェクトの生成とモデル指定
 	object_ = new Object3D();
-	object_->model_ = &model_;
+	object_->model_ = model_.get();
+	// RootのMatrixを適用
+	object_->SetLocalMatrix(model_->rootNode.localMatrix);
 	object_->transform_.rotate = { 0.0f, 3.14f, 0.0f };
 
 	// 音声読み込み
@@ -86,16 +88,8 @@ void GamePlayScene::Draw()
 	///	↓ ここから3Dオブジェクトの描画コマンド
 	/// 
 
-	// オブジェクトの行列
-	Matrix worldMatrix = object_->transform_.MakeAffineMatrix();
-	Matrix viewMatrix = Camera::GetCurrent()->MakeViewMatrix();
-	Matrix projectionMatrix = Camera::GetCurrent()->MakePerspectiveFovMatrix();
-	// RootのMatrixを適用
-	object_->wvpCB_.data_->WVP = model_.rootNode.localMatrix * worldMatrix * viewMatrix * projectionMatrix;
-	object_->wvpCB_.data_->World = model_.rootNode.localMatrix * worldMatrix;
-
 	// 3Dオブジェクト描画
-	object_->Draw();
+	object_->Draw(uvCheckerGH_);
 
 	///
 	///	↑ ここまで3Dオブジェクトの描画コマンド
@@ -118,6 +112,9 @@ void GamePlayScene::Draw()
 	ImGui::DragFloat3("scale", &object_->transform_.scale.x, 0.01f);
 	ImGui::End();
 
+	// フレームごとの統計
+	FrameStats::GetInstance()->DrawImGui();
+
 	// ImGuiの内部コマンドを生成する
 	ImguiWrapper::Render(dxBase->GetCommandList());
 	// 描画後処理
@@ -34,7 +34,9 @@ private:
 	///
 
 	// モデルデータ
-	ModelManager::ModelData model_;
+	ModelManager::ModelHandle model_;
+	// モデルに貼るテクスチャ（モデルは共有されるので書き換えず、描画時に指定する）
+	uint32_t uvCheckerGH_ = 0;
 	// 3Dオブジェクト
 	Object3D* object_;
 
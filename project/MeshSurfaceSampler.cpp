@@ -0,0 +1,138 @@
+#include "MeshSurfaceSampler.h"
+#include <algorithm>
+#include <math.h>
+#include "Random.h"
+
+namespace {
+	Float3 Cross(const Float3& a, const Float3& b)
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	float Length(const Float3& a)
+	{
+		return sqrtf(a.x * a.x + a.y * a.y + a.z * a.z);
+	}
+
+	// 1度に乱数を作る数
+	constexpr size_t kBatchSize = 256;
+}
+
+void MeshSurfaceSampler::Build(const ModelVertex* vertices, const uint32_t* indices, size_t numIndices)
+{
+	// インデックスを辿って三角形リストに展開する
+	std::vector<Float3> positions(numIndices);
+	for (size_t i = 0; i < numIndices; ++i) {
+		const Float4& position = vertices[indices[i]].position;
+		positions[i] = { position.x, position.y, position.z };
+	}
+	Build(positions.data(), positions.size());
+}
+
+void MeshSurfaceSampler::Build(const Float3* positions, size_t numVertices)
+{
+	triangles_.clear();
+	aliasTable_.clear();
+	totalArea_ = 0.0f;
+	boundingRadius_ = 0.0f;
+
+	// 面積のある三角形だけを集める
+	std::vector<float> areas;
+	size_t numTriangles = numVertices / 3;
+	triangles_.reserve(numTriangles);
+	areas.reserve(numTriangles);
+	for (size_t i = 0; i < numTriangles; ++i) {
+		const Float3& a = positions[i * 3 + 0];
+		const Float3& b = positions[i * 3 + 1];
+		const Float3& c = positions[i * 3 + 2];
+		Triangle triangle;
+		triangle.origin = a;
+		triangle.edge1 = b - a;
+		triangle.edge2 = c - a;
+		Float3 cross = Cross(triangle.edge1, triangle.edge2);
+		float crossLength = Length(cross);
+		if (crossLength <= 0.0f) {
+			continue;
+		}
+		triangle.normal = cross * (1.0f / crossLength);
+		triangles_.push_back(triangle);
+		areas.push_back(crossLength * 0.5f);
+		totalArea_ += crossLength * 0.5f;
+		boundingRadius_ = (std::max)({ boundingRadius_, Length(a), Length(b), Length(c) });
+	}
+	if (triangles_.empty()) {
+		return;
+	}
+
+	// Vose のエイリアス法
+	// 平均を1とした確率で、1未満の列に1以上の三角形の余りを割り当て、全ての列をちょうど1にする
+	size_t count = triangles_.size();
+	aliasTable_.resize(count);
+	std::vector<double> scaled(count);
+	std::vector<uint32_t> small, large;
+	double scale = static_cast<double>(count) / static_cast<double>(totalArea_);
+	for (size_t i = 0; i < count; ++i) {
+		scaled[i] = areas[i] * scale;
+		(scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+	}
+	while (!small.empty() && !large.empty()) {
+		uint32_t less = small.back();
+		small.pop_back();
+		uint32_t more = large.back();
+		aliasTable_[less] = { static_cast<float>(scaled[less]), more };
+		// 余りを渡した分だけ減らし、1未満になったら割り当てられる側に回す
+		scaled[more] -= 1.0 - scaled[less];
+		if (scaled[more] < 1.0) {
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+	// 残りは誤差でずれているだけなので、確率1にする
+	for (uint32_t index : large) {
+		aliasTable_[index] = { 1.0f, index };
+	}
+	for (uint32_t index : small) {
+		aliasTable_[index] = { 1.0f, index };
+	}
+}
+
+void MeshSurfaceSampler::Sample(Random& random, size_t count, float* outX, float* outY, float* outZ,
+	float* outNormalX, float* outNormalY, float* outNormalZ) const
+{
+	if (triangles_.empty()) {
+		return;
+	}
+
+	const float numTriangles = static_cast<float>(triangles_.size());
+	const uint32_t lastTriangle = static_cast<uint32_t>(triangles_.size() - 1);
+
+	// 三角形を選ぶ乱数2つと、三角形内の位置を決める乱数2つをまとめて作る
+	float selectRandom[kBatchSize], aliasRandom[kBatchSize], u[kBatchSize], v[kBatchSize];
+	for (size_t batchBegin = 0; batchBegin < count; batchBegin += kBatchSize) {
+		size_t batchCount = (std::min)(kBatchSize, count - batchBegin);
+		random.FillUniform(selectRandom, batchCount, 0.0f, numTriangles);
+		random.FillUniform(aliasRandom, batchCount, 0.0f, 1.0f);
+		random.FillUniform(u, batchCount, 0.0f, 1.0f);
+		random.FillUniform(v, batchCount, 0.0f, 1.0f);
+
+		for (size_t i = 0; i < batchCount; ++i) {
+			// 列を一様に選び、その列の確率で列の三角形かエイリアスかを決める
+			uint32_t column = (std::min)(static_cast<uint32_t>(selectRandom[i]), lastTriangle);
+			const AliasEntry& entry = aliasTable_[column];
+			const Triangle& triangle = triangles_[aliasRandom[i] < entry.probability ? column : entry.alias];
+
+			// 三角形内で一様になる重心座標
+			float sqrtU = sqrtf(u[i]);
+			float weight1 = sqrtU * (1.0f - v[i]);
+			float weight2 = sqrtU * v[i];
+
+			size_t out = batchBegin + i;
+			outX[out] = triangle.origin.x + triangle.edge1.x * weight1 + triangle.edge2.x * weight2;
+			outY[out] = triangle.origin.y + triangle.edge1.y * weight1 + triangle.edge2.y * weight2;
+			outZ[out] = triangle.origin.z + triangle.edge1.z * weight1 + triangle.edge2.z * weight2;
+			outNormalX[out] = triangle.normal.x;
+			outNormalY[out] = triangle.normal.y;
+			outNormalZ[out] = triangle.normal.z;
+		}
+	}
+}
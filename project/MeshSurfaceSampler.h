@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+#include "ModelVertex.h"
+
+class Random;
+
+// メッシュの表面から一様に点を選ぶ
+// ・三角形を面積に比例した確率で選ぶためのエイリアス表を、Buildで1度だけ作る
+// ・1点ごとに乱数4つで三角形と三角形内の位置が決まる（三角形の数によらずO(1)）
+class MeshSurfaceSampler
+{
+public:
+	// モデルの頂点をインデックスが3つずつ指す三角形から表を作る
+	// （ModelManager::ModelDataなら vertices.data(), indices.data(), indices.size() を渡す）
+	void Build(const ModelVertex* vertices, const uint32_t* indices, size_t numIndices);
+	// 頂点の位置（3つずつで三角形）から表を作る
+	void Build(const Float3* positions, size_t numVertices);
+
+	// 面積のある三角形がなければtrue（Sampleは使えない）
+	bool IsEmpty() const { return triangles_.empty(); }
+	size_t GetTriangleCount() const { return triangles_.size(); }
+	float GetTotalArea() const { return totalArea_; }
+	// 原点から最も遠い頂点までの距離
+	float GetBoundingRadius() const { return boundingRadius_; }
+
+	// count個の点を表面から選び、位置と面の法線を書き込む
+	void Sample(Random& random, size_t count, float* outX, float* outY, float* outZ,
+		float* outNormalX, float* outNormalY, float* outNormalZ) const;
+
+private:
+	// 1点を求めるのに必要なものを1か所にまとめた三角形
+	struct Triangle {
+		Float3 origin; //!< 1つ目の頂点
+		Float3 edge1; //!< 1つ目から2つ目の頂点
+		Float3 edge2; //!< 1つ目から3つ目の頂点
+		Float3 normal; //!< 面の法線（正規化済み）
+	};
+
+	// エイリアス表の1列（probabilityの確率でこの三角形、そうでなければalias番目の三角形）
+	struct AliasEntry {
+		float probability;
+		uint32_t alias;
+	};
+
+	std::vector<Triangle> triangles_;
+	std::vector<AliasEntry> aliasTable_;
+	float totalArea_ = 0.0f;
+	float boundingRadius_ = 0.0f;
+};
@@ -0,0 +1,99 @@
+#include "ParticleBudget.h"
+#include <algorithm>
+#include <math.h>
+
+void ParticleBudget::GroupState::BeginFrame()
+{
+	requested = 0;
+	emitted = 0;
+}
+
+void ParticleBudget::GroupState::EndFrame()
+{
+	lastRequested = requested;
+	lastEmitted = emitted;
+}
+
+void ParticleBudget::BeginFrame(size_t numLive)
+{
+	numLive_ = static_cast<uint32_t>(numLive);
+	requested_ = 0;
+	emitted_ = 0;
+}
+
+void ParticleBudget::EndFrame()
+{
+	lastRequested_ = requested_;
+	lastEmitted_ = emitted_;
+}
+
+float ParticleBudget::ComputeLodScale(const Float3& position, float radius, const Matrix& viewMatrix, const Matrix& projectionMatrix) const
+{
+	// ビュー空間の座標（ビュー行列は回転と平行移動だけなので、長さがカメラからの距離になる）
+	float viewX = position.x * viewMatrix.r[0][0] + position.y * viewMatrix.r[1][0] + position.z * viewMatrix.r[2][0] + viewMatrix.r[3][0];
+	float viewY = position.x * viewMatrix.r[0][1] + position.y * viewMatrix.r[1][1] + position.z * viewMatrix.r[2][1] + viewMatrix.r[3][1];
+	float viewZ = position.x * viewMatrix.r[0][2] + position.y * viewMatrix.r[1][2] + position.z * viewMatrix.r[2][2] + viewMatrix.r[3][2];
+	float distance = sqrtf(viewX * viewX + viewY * viewY + viewZ * viewZ);
+
+	// 距離による倍率（lodNearDistanceまでは1、lodFarDistanceでlodMinScale）
+	float distanceScale = 1.0f;
+	if (distance > settings_.lodNearDistance) {
+		float range = (std::max)(settings_.lodFarDistance - settings_.lodNearDistance, 1e-4f);
+		float t = (std::min)((distance - settings_.lodNearDistance) / range, 1.0f);
+		distanceScale = 1.0f + (settings_.lodMinScale - 1.0f) * t;
+	}
+
+	// 画面の高さに対する大きさによる倍率（カメラを囲んでいれば画面全体を覆う）
+	float coverageScale = 1.0f;
+	if (distance > radius && settings_.lodMinCoverage > 0.0f) {
+		// 後ろにある場合も、近くにあればすぐに見えるので距離で見積もる
+		float depth = (std::max)(viewZ, distance - radius);
+		float coverage = radius * projectionMatrix.r[1][1] / depth;
+		coverageScale = (std::min)(coverage / settings_.lodMinCoverage, 1.0f);
+	}
+
+	return (std::max)(distanceScale * coverageScale, settings_.lodMinScale);
+}
+
+float ParticleBudget::ComputePressureScale(size_t numLive, uint32_t maxParticles) const
+{
+	if (maxParticles == 0) {
+		return 0.0f;
+	}
+	float fill = static_cast<float>(numLive) / static_cast<float>(maxParticles);
+	if (fill <= settings_.throttleStart) {
+		return 1.0f;
+	}
+	// throttleStartから上限までの間で1から0へ下げる
+	float range = (std::max)(1.0f - settings_.throttleStart, 1e-4f);
+	return (std::max)((1.0f - fill) / range, 0.0f);
+}
+
+uint32_t ParticleBudget::Allow(GroupState& group, size_t groupLive, uint32_t count, float lodScale)
+{
+	group.requested += count;
+	requested_ += count;
+
+	// グループと全体のうち、上限に近い方に合わせて減らす
+	float pressureScale = (std::min)(ComputePressureScale(groupLive, group.maxParticles), ComputePressureScale(numLive_, settings_.maxParticles));
+	group.scale = lodScale * pressureScale;
+
+	// 切り捨てた端数は次に持ち越す
+	float scaledCount = static_cast<float>(count) * group.scale + group.emitCarry;
+	uint32_t allowed = static_cast<uint32_t>(scaledCount);
+	group.emitCarry = scaledCount - static_cast<float>(allowed);
+
+	// どちらの上限も超えないようにする
+	size_t groupRoom = group.maxParticles > groupLive ? group.maxParticles - groupLive : 0;
+	size_t globalRoom = settings_.maxParticles > numLive_ ? settings_.maxParticles - numLive_ : 0;
+	size_t room = (std::min)(groupRoom, globalRoom);
+	if (allowed > room) {
+		allowed = static_cast<uint32_t>(room);
+		group.emitCarry = 0.0f;
+	}
+
+	group.emitted += allowed;
+	emitted_ += allowed;
+	numLive_ += allowed;
+	return allowed;
+}
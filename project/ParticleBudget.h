@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+
+// パーティクルの発生数を、生きている数の上限とカメラからの見え方で絞る
+// ・上限はグループごとと全体の2つ。上限に近づくにつれて発生数を減らし、上限を超えては発生させない
+// ・カメラから遠い、または画面上で小さい発生位置は発生数を減らす（LOD）
+// ・減らした端数は次のEmitに持ち越すので、少ない発生数でも平均の発生率は倍率どおりになる
+class ParticleBudget
+{
+public:
+	struct Settings {
+		uint32_t maxParticles = 65536; //!< 全体で生きているパーティクル数の上限
+		uint32_t defaultGroupMaxParticles = 16384; //!< グループごとの上限の既定値
+		float throttleStart = 0.75f; //!< 上限に対してこの割合を超えたら発生数を減らし始める
+
+		float lodNearDistance = 20.0f; //!< この距離までは減らさない
+		float lodFarDistance = 100.0f; //!< この距離でlodMinScaleまで減らす
+		float lodMinCoverage = 0.02f; //!< 画面の高さに対する大きさがこれより小さければ減らす
+		float lodMinScale = 0.1f; //!< LODで減らすときの倍率の下限
+	};
+
+	// グループごとの状態（ParticleGroupに持たせる）
+	struct GroupState {
+		uint32_t maxParticles = 0; //!< 生きているパーティクル数の上限
+		float emitCarry = 0.0f; //!< 倍率をかけて切り捨てた端数
+		float scale = 1.0f; //!< 直近のEmitでかけた倍率
+
+		// 今のフレームと直前のフレームで要求された数と、実際に発生させた数
+		uint32_t requested = 0, emitted = 0;
+		uint32_t lastRequested = 0, lastEmitted = 0;
+
+		// フレームの発生を始める前と、終えた後に呼ぶ
+		void BeginFrame();
+		void EndFrame();
+	};
+
+	// 全体の使用状況
+	struct Report {
+		uint32_t numLive; //!< 生きているパーティクル数
+		uint32_t maxParticles; //!< 上限
+		uint32_t requested; //!< 直前のフレームで要求された数
+		uint32_t emitted; //!< 直前のフレームで発生させた数
+	};
+
+	void SetSettings(const Settings& settings) { settings_ = settings; }
+	const Settings& GetSettings() const { return settings_; }
+
+	// フレームの発生を始める前に、生きている数を数え直して呼ぶ
+	void BeginFrame(size_t numLive);
+	// フレームの発生を全て終えた後に呼ぶ（使用状況を直前のフレームの値として確定させる）
+	void EndFrame();
+
+	// 発生位置の見え方による倍率（0～1）
+	// radiusは発生するパーティクル全体を囲む球の半径
+	float ComputeLodScale(const Float3& position, float radius, const Matrix& viewMatrix, const Matrix& projectionMatrix) const;
+
+	// count個要求されたときに、実際に発生させてよい数を返す（返した数は生きている数に加える）
+	// groupLiveはグループで生きている数、lodScaleはComputeLodScaleの結果
+	uint32_t Allow(GroupState& group, size_t groupLive, uint32_t count, float lodScale);
+
+	Report GetReport() const { return Report{ numLive_, settings_.maxParticles, lastRequested_, lastEmitted_ }; }
+
+private:
+	// 上限に対する生きている数の割合から求める倍率（throttleStartまでは1で、上限で0になる）
+	float ComputePressureScale(size_t numLive, uint32_t maxParticles) const;
+
+	Settings settings_;
+
+	uint32_t numLive_ = 0;
+	uint32_t requested_ = 0, emitted_ = 0;
+	uint32_t lastRequested_ = 0, lastEmitted_ = 0;
+};
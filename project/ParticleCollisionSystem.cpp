@@ -0,0 +1,327 @@
+#include "ParticleCollisionSystem.h"
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include "ParticleStorage.h"
+#include "SimdMath.h"
+
+namespace {
+	// 球の中心と重なったときに0で割らないための下限
+	constexpr float kMinDistanceSq = 1e-12f;
+
+	// 区間をさらに分けて範囲を求め直す単位（4の倍数）
+	// 区間の中で離れた場所のパーティクルが混ざっていても、近くのコライダーだけを判定できる
+	constexpr size_t kSubBlockSize = 64;
+	// 区間の候補がこれより多ければ、小さな単位ごとに木へ問い合わせ直す（少なければ候補を範囲で絞る）
+	constexpr size_t kMaxFilteredCandidates = 32;
+
+	// 4つ分のパーティクル
+	struct CollisionBatch {
+		Simd::Vec4 px, py, pz;
+		Simd::Vec4 vx, vy, vz;
+		Simd::Vec4 age, lifeTime;
+	};
+
+	// 4つ分の接触（内側のマスク、押し出す向き、めり込みの深さ）
+	struct Contact {
+		Simd::Mask4 inside;
+		Simd::Vec4 nx, ny, nz;
+		Simd::Vec4 depth;
+	};
+
+	// 内側の要素のマスクと、押し出す向き・深さを求める
+	// 外側の要素の向き・深さは使われないので何が入っていてもよい
+	Contact ComputeContact(const ParticleCollisionSystem::Collider& collider, const CollisionBatch& b)
+	{
+		using namespace Simd;
+		using Shape = ParticleCollisionSystem::Shape;
+
+		Contact contact;
+		switch (collider.shape) {
+		case Shape::Plane: {
+			// 面からの符号付き距離が負なら裏側
+			Vec4 signedDistance = Sub(
+				MulAdd(b.px, Set1(collider.normal.x), MulAdd(b.py, Set1(collider.normal.y), Mul(b.pz, Set1(collider.normal.z)))),
+				Set1(collider.distance));
+			contact.inside = CmpLt(signedDistance, Zero());
+			contact.nx = Set1(collider.normal.x);
+			contact.ny = Set1(collider.normal.y);
+			contact.nz = Set1(collider.normal.z);
+			contact.depth = Sub(Zero(), signedDistance);
+			break;
+		}
+		case Shape::Sphere: {
+			// 中心から外向きに押し出す（中心と重なった場合は+Y）
+			Vec4 dx = Sub(b.px, Set1(collider.center.x));
+			Vec4 dy = Sub(b.py, Set1(collider.center.y));
+			Vec4 dz = Sub(b.pz, Set1(collider.center.z));
+			Vec4 distanceSq = MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz)));
+			contact.inside = CmpLt(distanceSq, Set1(collider.radius * collider.radius));
+			Mask4 degenerate = CmpLt(distanceSq, Set1(kMinDistanceSq));
+			Vec4 distance = Sqrt(Max(distanceSq, Set1(kMinDistanceSq)));
+			Vec4 inverse = Div(Set1(1.0f), distance);
+			contact.nx = Select(degenerate, Zero(), Mul(dx, inverse));
+			contact.ny = Select(degenerate, Set1(1.0f), Mul(dy, inverse));
+			contact.nz = Select(degenerate, Zero(), Mul(dz, inverse));
+			contact.depth = Sub(Set1(collider.radius), distance);
+			break;
+		}
+		case Shape::Box: {
+			// 各軸で近い方の面までの距離を求め、最も浅い面から押し出す
+			const AABB& box = collider.bounds;
+			Vec4 toMinX = Sub(b.px, Set1(box.min.x)), toMaxX = Sub(Set1(box.max.x), b.px);
+			Vec4 toMinY = Sub(b.py, Set1(box.min.y)), toMaxY = Sub(Set1(box.max.y), b.py);
+			Vec4 toMinZ = Sub(b.pz, Set1(box.min.z)), toMaxZ = Sub(Set1(box.max.z), b.pz);
+			contact.inside = And(
+				And(And(CmpGt(toMinX, Zero()), CmpGt(toMaxX, Zero())), And(CmpGt(toMinY, Zero()), CmpGt(toMaxY, Zero()))),
+				And(CmpGt(toMinZ, Zero()), CmpGt(toMaxZ, Zero())));
+
+			Vec4 one = Set1(1.0f), minusOne = Set1(-1.0f), zero = Zero();
+			Vec4 depthX = Min(toMinX, toMaxX);
+			Vec4 depthY = Min(toMinY, toMaxY);
+			Vec4 depthZ = Min(toMinZ, toMaxZ);
+			Vec4 signX = Select(CmpLt(toMinX, toMaxX), minusOne, one);
+			Vec4 signY = Select(CmpLt(toMinY, toMaxY), minusOne, one);
+			Vec4 signZ = Select(CmpLt(toMinZ, toMaxZ), minusOne, one);
+
+			// X → Y → Z の順に、より浅い軸があれば置き換える
+			contact.depth = depthX;
+			contact.nx = signX;
+			contact.ny = zero;
+			contact.nz = zero;
+			Mask4 useY = CmpLt(depthY, contact.depth);
+			contact.depth = Select(useY, depthY, contact.depth);
+			contact.nx = Select(useY, zero, contact.nx);
+			contact.ny = Select(useY, signY, contact.ny);
+			Mask4 useZ = CmpLt(depthZ, contact.depth);
+			contact.depth = Select(useZ, depthZ, contact.depth);
+			contact.nx = Select(useZ, zero, contact.nx);
+			contact.ny = Select(useZ, zero, contact.ny);
+			contact.nz = Select(useZ, signZ, contact.nz);
+			break;
+		}
+		}
+		return contact;
+	}
+}
+
+ParticleCollisionSystem::Handle ParticleCollisionSystem::Add(const Collider& collider)
+{
+	needsBuild_ = true;
+	// 削除済みの番号があれば使い回す
+	if (!freeHandles_.empty()) {
+		Handle handle = freeHandles_.back();
+		freeHandles_.pop_back();
+		colliders_[handle] = collider;
+		alive_[handle] = 1;
+		return handle;
+	}
+	colliders_.push_back(collider);
+	alive_.push_back(1);
+	return static_cast<Handle>(colliders_.size() - 1);
+}
+
+void ParticleCollisionSystem::Remove(Handle handle)
+{
+	assert(handle < colliders_.size() && alive_[handle]);
+	alive_[handle] = 0;
+	freeHandles_.push_back(handle);
+	needsBuild_ = true;
+}
+
+void ParticleCollisionSystem::Set(Handle handle, const Collider& collider)
+{
+	assert(handle < colliders_.size() && alive_[handle]);
+	colliders_[handle] = collider;
+	needsBuild_ = true;
+}
+
+const ParticleCollisionSystem::Collider& ParticleCollisionSystem::Get(Handle handle) const
+{
+	assert(handle < colliders_.size() && alive_[handle]);
+	return colliders_[handle];
+}
+
+void ParticleCollisionSystem::Clear()
+{
+	colliders_.clear();
+	alive_.clear();
+	freeHandles_.clear();
+	needsBuild_ = true;
+}
+
+AABB ParticleCollisionSystem::ComputeBounds(const Collider& collider)
+{
+	switch (collider.shape) {
+	case Shape::Sphere: {
+		Float3 extent = { collider.radius, collider.radius, collider.radius };
+		return AABB{ collider.center - extent, collider.center + extent };
+	}
+	case Shape::Box:
+		return collider.bounds;
+	default: {
+		// 平面は無限に広がるので、常に候補になるようにする
+		constexpr float kInfinity = std::numeric_limits<float>::infinity();
+		return AABB{ { -kInfinity, -kInfinity, -kInfinity }, { kInfinity, kInfinity, kInfinity } };
+	}
+	}
+}
+
+void ParticleCollisionSystem::Build()
+{
+	if (!needsBuild_) {
+		return;
+	}
+	needsBuild_ = false;
+
+	// コライダーの範囲を木に登録し直す（削除済みの番号は登録しない）
+	tree_.Clear();
+	colliderBounds_.resize(colliders_.size());
+	for (size_t index = 0; index < colliders_.size(); ++index) {
+		colliderBounds_[index] = ComputeBounds(colliders_[index]);
+		if (alive_[index]) {
+			tree_.Insert(colliderBounds_[index], static_cast<uint32_t>(index));
+		}
+	}
+	tree_.Build();
+}
+
+void ParticleCollisionSystem::Query(const AABB& bounds, std::vector<uint32_t>& out) const
+{
+	assert(!needsBuild_);
+	out.clear();
+	tree_.QueryAABB(bounds, out);
+	// 登録順に並べる（適用する順番が木の形によらないように）
+	std::sort(out.begin(), out.end());
+}
+
+void ParticleCollisionSystem::Apply(ParticleStorage& particles, size_t begin, size_t end) const
+{
+	if (begin >= end) {
+		return;
+	}
+
+	// 区間のパーティクルを囲む範囲と重なるコライダーを集める
+	thread_local std::vector<uint32_t> candidates;
+	Query(particles.ComputeBounds(begin, end), candidates);
+	if (candidates.empty()) {
+		return;
+	}
+
+	// 小さな単位ごとに範囲を求め直し、重なる候補だけを判定する
+	thread_local std::vector<uint32_t> blockCandidates;
+	bool requery = candidates.size() > kMaxFilteredCandidates;
+	for (size_t blockBegin = begin; blockBegin < end; blockBegin += kSubBlockSize) {
+		size_t blockEnd = (std::min)(blockBegin + kSubBlockSize, end);
+		AABB bounds = particles.ComputeBounds(blockBegin, blockEnd);
+		Float3 center = (bounds.min + bounds.max) * 0.5f;
+		Float3 extent = (bounds.max - bounds.min) * 0.5f;
+		if (requery) {
+			Query(bounds, blockCandidates);
+		}
+
+		for (uint32_t index : requery ? blockCandidates : candidates) {
+			if (!IsCollision(colliderBounds_[index], bounds)) {
+				continue;
+			}
+			const Collider& collider = colliders_[index];
+			if (collider.shape == Shape::Plane) {
+				// 範囲が全て平面の表側にあれば判定しない
+				const Float3& n = collider.normal;
+				float centerDistance = n.x * center.x + n.y * center.y + n.z * center.z - collider.distance;
+				float projectedExtent = fabsf(n.x) * extent.x + fabsf(n.y) * extent.y + fabsf(n.z) * extent.z;
+				if (centerDistance - projectedExtent >= 0.0f) {
+					continue;
+				}
+			}
+			ApplyCollider(collider, particles, blockBegin, blockEnd);
+		}
+	}
+}
+
+void ParticleCollisionSystem::ApplyCollider(const Collider& collider, ParticleStorage& particles, size_t begin, size_t end)
+{
+	using namespace Simd;
+
+	const bool isKill = collider.response == Response::Kill;
+	const Vec4 restitution = Set1(collider.restitution);
+	const Vec4 tangentScale = Set1(1.0f - collider.friction);
+
+	// 4つ分を読み、内側の要素だけ書き換える
+	// streamsは位置XYZ・速度XYZ・経過時間・生存可能時間の順
+	auto applyBatch = [&](float* const* streams) {
+		CollisionBatch batch = {
+			Load(streams[0]), Load(streams[1]), Load(streams[2]),
+			Load(streams[3]), Load(streams[4]), Load(streams[5]),
+			Load(streams[6]), Load(streams[7]),
+		};
+
+		// 内側の要素が1つもなければ何もしない
+		Contact contact = ComputeContact(collider, batch);
+		if (MoveMask(contact.inside) == 0) {
+			return;
+		}
+
+		if (isKill) {
+			// 経過時間を生存可能時間にして、次のRemoveDeadで消す
+			Store(streams[6], Select(contact.inside, batch.lifeTime, batch.age));
+			return;
+		}
+
+		// 表面まで押し戻す
+		Store(streams[0], Select(contact.inside, MulAdd(contact.nx, contact.depth, batch.px), batch.px));
+		Store(streams[1], Select(contact.inside, MulAdd(contact.ny, contact.depth, batch.py), batch.py));
+		Store(streams[2], Select(contact.inside, MulAdd(contact.nz, contact.depth, batch.pz), batch.pz));
+
+		// 面に向かっている要素だけ、法線方向を反発係数で反転し、接線方向を摩擦で減らす
+		Vec4 normalSpeed = MulAdd(batch.vx, contact.nx, MulAdd(batch.vy, contact.ny, Mul(batch.vz, contact.nz)));
+		Mask4 approaching = And(contact.inside, CmpLt(normalSpeed, Zero()));
+		Vec4 normalX = Mul(contact.nx, normalSpeed);
+		Vec4 normalY = Mul(contact.ny, normalSpeed);
+		Vec4 normalZ = Mul(contact.nz, normalSpeed);
+		Vec4 bouncedX = Sub(Mul(Sub(batch.vx, normalX), tangentScale), Mul(normalX, restitution));
+		Vec4 bouncedY = Sub(Mul(Sub(batch.vy, normalY), tangentScale), Mul(normalY, restitution));
+		Vec4 bouncedZ = Sub(Mul(Sub(batch.vz, normalZ), tangentScale), Mul(normalZ, restitution));
+		Store(streams[3], Select(approaching, bouncedX, batch.vx));
+		Store(streams[4], Select(approaching, bouncedY, batch.vy));
+		Store(streams[5], Select(approaching, bouncedZ, batch.vz));
+	};
+
+	float* streams[8] = {
+		particles.positionX.data(), particles.positionY.data(), particles.positionZ.data(),
+		particles.velocityX.data(), particles.velocityY.data(), particles.velocityZ.data(),
+		particles.age.data(), particles.lifeTime.data(),
+	};
+
+	// 4つずつ処理
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		float* batchStreams[8];
+		for (size_t stream = 0; stream < 8; ++stream) {
+			batchStreams[stream] = streams[stream] + i;
+		}
+		applyBatch(batchStreams);
+	}
+
+	// 端数は一時配列に詰めて同じ計算で処理する
+	// 空きの要素は位置をNaNにしておき、どの判定でも外側になるようにする
+	if (i < end) {
+		size_t rest = end - i;
+		float tail[8][4];
+		float* batchStreams[8];
+		for (size_t stream = 0; stream < 8; ++stream) {
+			for (size_t lane = 0; lane < 4; ++lane) {
+				tail[stream][lane] = lane < rest ? streams[stream][i + lane] : (stream < 3 ? NAN : 0.0f);
+			}
+			batchStreams[stream] = tail[stream];
+		}
+		applyBatch(batchStreams);
+		// 位置・速度・経過時間を書き戻す
+		for (size_t stream = 0; stream < 7; ++stream) {
+			for (size_t lane = 0; lane < rest; ++lane) {
+				streams[stream][i + lane] = tail[stream][lane];
+			}
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+#include "AABBTree.h"
+
+class ParticleStorage;
+
+// パーティクルとワールドのコライダー（平面・球・箱）の衝突
+// ・移動後の位置でコライダーの内側に入ったパーティクルを、反射させるか寿命を終わらせる
+// ・コライダーの範囲をAABBTreeに登録しておき、パーティクルの区間の範囲と重なるものだけを判定する
+//   候補は区間をさらに小さく分けた範囲でも絞り込む
+//   （平面は範囲が無限なので常に候補になり、範囲が全て表側にあれば判定を省く）
+// ・判定は要素ごとの配列に対して4つずつSIMDで行い、内側かどうかはマスクで扱う
+class ParticleCollisionSystem
+{
+public:
+	enum class Shape {
+		Plane,	// 平面（法線の裏側が内側）
+		Sphere,	// 球（中身の詰まった球で、外側に押し出す）
+		Box,	// 軸に沿った箱（最も浅い面から外側に押し出す）
+	};
+
+	enum class Response {
+		Bounce,	// 表面まで押し戻し、速度を反射させる
+		Kill,	// 触れたパーティクルの寿命を終わらせる
+	};
+
+	struct Collider {
+		Shape shape = Shape::Plane;
+		Response response = Response::Bounce;
+		Float3 normal = { 0.0f, 1.0f, 0.0f }; //!< Plane: 法線（正規化済み）
+		float distance = 0.0f; //!< Plane: dot(normal, p) = distance が面
+		Float3 center = { 0.0f, 0.0f, 0.0f }; //!< Sphere: 中心
+		float radius = 1.0f; //!< Sphere: 半径
+		AABB bounds; //!< Box: 範囲
+		float restitution = 0.5f; //!< Bounce: 法線方向の速度に掛ける反発係数
+		float friction = 0.1f; //!< Bounce: 接線方向の速度を減らす割合（0～1）
+	};
+
+	// コライダーを指す番号（Removeするまで変わらない）
+	using Handle = uint32_t;
+
+	///
+	/// 登録
+	///
+
+	Handle Add(const Collider& collider);
+	void Remove(Handle handle);
+	// 登録済みのコライダーを書き換える
+	void Set(Handle handle, const Collider& collider);
+	const Collider& Get(Handle handle) const;
+	void Clear();
+	// 登録されているコライダーの数
+	size_t Size() const { return colliders_.size() - freeHandles_.size(); }
+
+	// 登録内容が変わっていれば木を作り直す
+	// Applyを並列に呼ぶ前に、1つのスレッドから呼ぶこと
+	void Build();
+
+	///
+	/// 判定
+	///
+
+	// [begin, end) のパーティクルのうち、コライダーの内側に入ったものに応答を適用する
+	// Build後であれば複数のスレッドから同時に呼んでよい
+	void Apply(ParticleStorage& particles, size_t begin, size_t end) const;
+
+	// boundsと重なるコライダーの番号を小さい順にoutへ集める（outは先にクリアされる）
+	void Query(const AABB& bounds, std::vector<uint32_t>& out) const;
+
+private:
+	// コライダーが内側と判定しうる範囲（平面は無限）
+	static AABB ComputeBounds(const Collider& collider);
+
+	// 1つのコライダーを区間に適用する
+	static void ApplyCollider(const Collider& collider, ParticleStorage& particles, size_t begin, size_t end);
+
+	std::vector<Collider> colliders_;
+	std::vector<uint8_t> alive_;
+	std::vector<Handle> freeHandles_;
+
+	// コライダーの範囲を登録した木（平面は範囲が無限なので木の外で常に判定される）
+	AABBTree tree_;
+	std::vector<AABB> colliderBounds_;
+	bool needsBuild_ = false;
+};
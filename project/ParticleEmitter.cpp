@@ -1,14 +1,11 @@
 #include "ParticleEmitter.h"
+#include <cassert>
 
 ParticleEmitter::ParticleEmitter(ParticleManager& manager)
 {
+	// パーティクルグループはParticleManagerが持ち、エミッタは発生を予約するだけ
 	this->particleManager = &manager;
 
-	// パーティクルグループをコピー
-	for (auto& pair : manager.particleGroups) {
-		this->particleGroups[pair.first] = std::move(pair.second);
-	}
-
 	// emitterの初期値を設定
 	count = 3;
 	frequency = 0.5f; // 0.5秒ごとに発生
@@ -16,6 +13,7 @@ ParticleEmitter::ParticleEmitter(ParticleManager& manager)
 	transform.translate = { 0.0f, 0.0f, 0.0f };
 	transform.rotate = { 0.0f, 0.0f, 0.0f };
 	transform.scale = { 1.0f, 1.0f, 1.0f };
+	shape = EmitterShape::Box({ 1.0f, 1.0f, 1.0f });
 }
 
 void ParticleEmitter::Update(std::string name, bool isEmit)
@@ -31,5 +29,7 @@ void ParticleEmitter::Update(std::string name, bool isEmit)
 
 void ParticleEmitter::Emit(std::string name)
 {
-	particleManager->Emit(name, transform.translate, count);
+	ParticleManager::GroupHandle group = particleManager->FindGroup(name);
+	assert(group != ParticleManager::kInvalidGroup); // 登録済みのパーティクルグループかチェック
+	particleManager->Emit(group, transform, shape, count);
 }
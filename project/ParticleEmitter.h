@@ -9,16 +9,19 @@ public:
 
 	void Update(std::string name, bool isEmit);
 	void Emit(std::string name);
+
+	// 発生させる範囲の形（既定は±1の箱）
+	void SetShape(const EmitterShape& shape) { this->shape = shape; }
+	// エミッタの位置・回転・スケール（形はこのTransformで配置される）
+	void SetTransform(const Transform& transform) { this->transform = transform; }
 private:
 	ParticleManager* particleManager = nullptr;
 
-	// パーティクルグループコンテナ
-	std::unordered_map<std::string, std::unique_ptr<ParticleManager::ParticleGroup>> particleGroups;
-
 	// Δtを定義
 	const float kDeltaTime = 1.0f / 60.0f;
 
 	Transform transform; //!< エミッタのTransform
+	EmitterShape shape; //!< 発生させる範囲の形
 	uint32_t count; //!< 発生数
 	float frequency; //!< 発生頻度
 	float frequencyTime; // !< 頻度用時刻
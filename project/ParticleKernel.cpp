@@ -0,0 +1,158 @@
+#include "ParticleKernel.h"
+#include <algorithm>
+#include "ParticleStorage.h"
+#include "SimdMath.h"
+
+namespace {
+	// 配列の先頭ポインタ
+	struct IntegrateStreams {
+		float* positionX;
+		float* positionY;
+		float* positionZ;
+		const float* velocityX;
+		const float* velocityY;
+		const float* velocityZ;
+		float* age;
+	};
+
+	IntegrateStreams MakeStreams(ParticleStorage& particles)
+	{
+		return IntegrateStreams{
+			particles.positionX.data(), particles.positionY.data(), particles.positionZ.data(),
+			particles.velocityX.data(), particles.velocityY.data(), particles.velocityZ.data(),
+			particles.age.data(),
+		};
+	}
+
+	// 1つ分の更新（Reference版と、SIMD版の端数で使う）
+	inline void IntegrateOne(const IntegrateStreams& s, size_t i, float deltaTime)
+	{
+		s.positionX[i] += s.velocityX[i] * deltaTime;
+		s.positionY[i] += s.velocityY[i] * deltaTime;
+		s.positionZ[i] += s.velocityZ[i] * deltaTime;
+		s.age[i] += deltaTime;
+	}
+
+#if defined(MATH_SIMD_AVX)
+	// 8つ分の更新
+	inline void Integrate8(const IntegrateStreams& s, size_t i, float deltaTime)
+	{
+		__m256 dt = _mm256_set1_ps(deltaTime);
+		_mm256_storeu_ps(s.positionX + i, _mm256_add_ps(_mm256_loadu_ps(s.positionX + i), _mm256_mul_ps(_mm256_loadu_ps(s.velocityX + i), dt)));
+		_mm256_storeu_ps(s.positionY + i, _mm256_add_ps(_mm256_loadu_ps(s.positionY + i), _mm256_mul_ps(_mm256_loadu_ps(s.velocityY + i), dt)));
+		_mm256_storeu_ps(s.positionZ + i, _mm256_add_ps(_mm256_loadu_ps(s.positionZ + i), _mm256_mul_ps(_mm256_loadu_ps(s.velocityZ + i), dt)));
+		_mm256_storeu_ps(s.age + i, _mm256_add_ps(_mm256_loadu_ps(s.age + i), dt));
+	}
+#elif !defined(MATH_SIMD_SCALAR)
+	// 4つ分の更新
+	inline void Integrate4(const IntegrateStreams& s, size_t i, float deltaTime)
+	{
+		using namespace Simd;
+
+		Vec4 dt = Set1(deltaTime);
+		Store(s.positionX + i, MulAdd(Load(s.velocityX + i), dt, Load(s.positionX + i)));
+		Store(s.positionY + i, MulAdd(Load(s.velocityY + i), dt, Load(s.positionY + i)));
+		Store(s.positionZ + i, MulAdd(Load(s.velocityZ + i), dt, Load(s.positionZ + i)));
+		Store(s.age + i, Add(Load(s.age + i), dt));
+	}
+#endif
+}
+
+void ParticleKernel::Integrate(ParticleStorage& particles, size_t begin, size_t end, float deltaTime)
+{
+	IntegrateStreams streams = MakeStreams(particles);
+
+	size_t i = begin;
+#if !defined(MATH_SIMD_SCALAR)
+	// 8つずつ処理
+	for (; i + 8 <= end; i += 8) {
+#if defined(MATH_SIMD_AVX)
+		Integrate8(streams, i, deltaTime);
+#else
+		Integrate4(streams, i, deltaTime);
+		Integrate4(streams, i + 4, deltaTime);
+#endif
+	}
+#endif
+	// 端数は1つずつ
+	for (; i < end; ++i) {
+		IntegrateOne(streams, i, deltaTime);
+	}
+}
+
+void ParticleKernel::IntegrateReference(ParticleStorage& particles, size_t begin, size_t end, float deltaTime)
+{
+	IntegrateStreams streams = MakeStreams(particles);
+
+	for (size_t i = begin; i < end; ++i) {
+		IntegrateOne(streams, i, deltaTime);
+	}
+}
+
+void ParticleKernel::ComputeAlpha(const ParticleStorage& particles, size_t begin, size_t end, float* outAlpha)
+{
+	const float* colorA = particles.colorA.data();
+	const float* age = particles.age.data();
+	const float* lifeTime = particles.lifeTime.data();
+
+	size_t i = begin;
+	// 8つずつ処理
+	for (; i + 8 <= end; i += 8) {
+#if defined(MATH_SIMD_AVX)
+		__m256 alpha = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(_mm256_loadu_ps(age + i), _mm256_loadu_ps(lifeTime + i)));
+		_mm256_storeu_ps(outAlpha + (i - begin), _mm256_mul_ps(_mm256_loadu_ps(colorA + i), alpha));
+#else
+		for (size_t offset = 0; offset < 8; offset += 4) {
+			size_t index = i + offset;
+			Simd::Vec4 alpha = Simd::Sub(Simd::Set1(1.0f), Simd::Div(Simd::Load(age + index), Simd::Load(lifeTime + index)));
+			Simd::Store(outAlpha + (index - begin), Simd::Mul(Simd::Load(colorA + index), alpha));
+		}
+#endif
+	}
+	// 端数は1つずつ
+	for (; i < end; ++i) {
+		outAlpha[i - begin] = colorA[i] * (1.0f - age[i] / lifeTime[i]);
+	}
+}
+
+void ParticleKernel::ComputeAlphaReference(const ParticleStorage& particles, size_t begin, size_t end, float* outAlpha)
+{
+	for (size_t i = begin; i < end; ++i) {
+		outAlpha[i - begin] = particles.colorA[i] * (1.0f - particles.age[i] / particles.lifeTime[i]);
+	}
+}
+
+void ParticleKernel::PackColors(const ParticleStorage& particles, size_t begin, size_t end, const float* alpha, uint32_t* outColor)
+{
+	const float* colorR = particles.colorR.data();
+	const float* colorG = particles.colorG.data();
+	const float* colorB = particles.colorB.data();
+
+	size_t i = begin;
+#if !defined(MATH_SIMD_SCALAR)
+	// 4つずつ処理
+	for (; i + 4 <= end; i += 4) {
+		Simd::PackUnorm8(Simd::Load(colorR + i), Simd::Load(colorG + i), Simd::Load(colorB + i), Simd::Load(alpha + (i - begin)), outColor + (i - begin));
+	}
+#endif
+	// 端数は1つずつ
+	for (; i < end; ++i) {
+		outColor[i - begin] = PackColor(colorR[i], colorG[i], colorB[i], alpha[i - begin]);
+	}
+}
+
+void ParticleKernel::PackColorsReference(const ParticleStorage& particles, size_t begin, size_t end, const float* alpha, uint32_t* outColor)
+{
+	for (size_t i = begin; i < end; ++i) {
+		outColor[i - begin] = PackColor(particles.colorR[i], particles.colorG[i], particles.colorB[i], alpha[i - begin]);
+	}
+}
+
+uint32_t ParticleKernel::PackColor(float r, float g, float b, float a)
+{
+	// Simd::PackUnorm8と同じ式で量子化する
+	auto quantize = [](float value) {
+		return static_cast<uint32_t>((std::min)((std::max)(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	};
+	return quantize(r) | (quantize(g) << 8) | (quantize(b) << 16) | (quantize(a) << 24);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class ParticleStorage;
+
+// ParticleStorageの配列に対して、移動・Alpha値の計算・色の量子化をまとめて行う
+// ・8個ずつ（AVXなら8要素1回、SSE/NEONは4要素を2回）処理し、8個に満たない端数は1つずつ処理する
+// ・Reference版は同じ式を同じ順序で1つずつ計算するので、SIMD版と結果はビット単位で一致する
+// ・Fieldによる速度の変更はForceFieldSystemで先に行っておく
+class ParticleKernel
+{
+public:
+	// [begin, end) のパーティクルの位置を速度で、経過時間をdeltaTimeだけ進める
+	static void Integrate(ParticleStorage& particles, size_t begin, size_t end, float deltaTime);
+	// Integrateと同じ処理のスカラー版（結果の検証用）
+	static void IntegrateReference(ParticleStorage& particles, size_t begin, size_t end, float deltaTime);
+
+	// [begin, end) のパーティクルの経過時間に応じたAlpha値 colorA * (1 - age / lifeTime) を
+	// outAlpha[0]～outAlpha[end - begin - 1] に書き込む
+	static void ComputeAlpha(const ParticleStorage& particles, size_t begin, size_t end, float* outAlpha);
+	// ComputeAlphaと同じ処理のスカラー版（結果の検証用）
+	static void ComputeAlphaReference(const ParticleStorage& particles, size_t begin, size_t end, float* outAlpha);
+
+	// [begin, end) のパーティクルの色を、Alphaだけalpha[0]～alpha[end - begin - 1]に置き換えてRGBA8に詰め、
+	// outColor[0]～outColor[end - begin - 1] に書き込む（下位からR, G, B, A。範囲外は0～1に収める）
+	static void PackColors(const ParticleStorage& particles, size_t begin, size_t end, const float* alpha, uint32_t* outColor);
+	// PackColorsと同じ処理のスカラー版（結果の検証用）
+	static void PackColorsReference(const ParticleStorage& particles, size_t begin, size_t end, const float* alpha, uint32_t* outColor);
+	// 1色分をRGBA8に詰める
+	static uint32_t PackColor(float r, float g, float b, float a);
+};
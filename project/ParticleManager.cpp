@@ -1,8 +1,30 @@
 #include "ParticleManager.h"
 #include <cassert>
 #include <numbers>
+#include <algorithm>
+#include <math.h>
 
 #include "Camera.h"
+#include "Culling.h"
+#include "FrameStats.h"
+#include "JobSystem.h"
+#include "ParticleKernel.h"
+#include "RadixSort.h"
+#include "externals/imgui/imgui.h"
+
+namespace {
+	// モデルを原点中心の球で囲んだときの半径（モデルがなければ0）
+	float ComputeModelRadius(const ModelManager::ModelData* model)
+	{
+		if (!model) {
+			return 0.0f;
+		}
+		float x = (std::max)(fabsf(model->bounds.min.x), fabsf(model->bounds.max.x));
+		float y = (std::max)(fabsf(model->bounds.min.y), fabsf(model->bounds.max.y));
+		float z = (std::max)(fabsf(model->bounds.min.z), fabsf(model->bounds.max.z));
+		return sqrtf(x * x + y * y + z * z);
+	}
+}
 
 ParticleManager* ParticleManager::GetInstance()
 {
@@ -17,7 +39,7 @@ void ParticleManager::Initialize(DirectXBase* dxBase, SRVManager* srvManager)
 	this->srvManager = srvManager;
 
 	// ランダムエンジンの初期化
-	randomEngine.seed(seedGenerator());
+	random_.Seed((static_cast<uint64_t>(seedGenerator()) << 32) | seedGenerator());
 
 	// 反対側に回す回転行列
 	backToFrontMatrix = Matrix::RotationY(std::numbers::pi_v<float>);
@@ -26,27 +48,39 @@ void ParticleManager::Initialize(DirectXBase* dxBase, SRVManager* srvManager)
 	for (auto& [name, groupPtr] : particleGroups) {
 		auto& group = *groupPtr;
 		group.object.transform_.rotate = { 0.0f, 3.1f, 0.0f };
-		// 単位行列を書き込んでおく
-		for (uint32_t index = 0; index < group.instancingBuffer.numMaxInstance_; ++index) {
-			group.instancingBuffer.data_[index].WVP = Matrix::Identity();
-			group.instancingBuffer.data_[index].World = Matrix::Identity();
-			group.instancingBuffer.data_[index].color = Float4(1.0f, 1.0f, 1.0f, 1.0f); // とりあえず白を書き込む
-		}
 	}
 
-	accelerationField.acceleration = { 15.0f, 0.0f, 0.0f };
-	accelerationField.area.min = { -1.0f, -1.0f, -1.0f };
-	accelerationField.area.max = { 1.0f, 1.0f, 1.0f };
+	// 原点付近で+X方向に流すField
+	ForceFieldSystem::Field field;
+	field.type = ForceFieldSystem::Type::Gravity;
+	field.vector = { 15.0f, 0.0f, 0.0f };
+	field.bounds.min = { -1.0f, -1.0f, -1.0f };
+	field.bounds.max = { 1.0f, 1.0f, 1.0f };
+	forceFields_.Add(field);
 }
 
-void ParticleManager::CreateParticleGroup(const std::string name)
+ParticleManager::GroupHandle ParticleManager::CreateParticleGroup(const std::string name, size_t capacity)
 {
 	assert(particleGroups.find(name) == particleGroups.end());
 
 	// 新たな空のパーティクルグループを作成
-	auto newGroup = std::make_unique<ParticleGroup>();
-	// コンテナに登録
+	auto newGroup = std::make_unique<ParticleGroup>(static_cast<uint32_t>(capacity));
+	newGroup->particles.Reserve(capacity);
+	newGroup->cullingRadius.reserve(capacity);
+	newGroup->visible.reserve(capacity);
+	newGroup->budget.maxParticles = budget_.GetSettings().defaultGroupMaxParticles;
+	// 番号を割り当ててコンテナに登録
+	GroupHandle handle = static_cast<GroupHandle>(groupHandles_.size());
+	groupHandles_.push_back(newGroup.get());
+	groupNames_[name] = handle;
 	particleGroups[name] = std::move(newGroup);
+	return handle;
+}
+
+ParticleManager::GroupHandle ParticleManager::FindGroup(const std::string& name) const
+{
+	auto it = groupNames_.find(name);
+	return it != groupNames_.end() ? it->second : kInvalidGroup;
 }
 
 void ParticleManager::SetModel(const std::string name, ModelManager::ModelData* model)
@@ -60,101 +94,373 @@ void ParticleManager::SetModel(const std::string name, ModelManager::ModelData*
 
 void ParticleManager::Update()
 {
-	// ビュー行列とプロジェクション行列をカメラから取得
-	Matrix viewMatrix = Camera::GetCurrent()->MakeViewMatrix();
-	Matrix projectionMatrix = Camera::GetCurrent()->MakePerspectiveFovMatrix();
+	// ビュー行列とビュープロジェクション行列をカメラのキャッシュから取得
+	const Matrix& viewMatrix = Camera::GetCurrent()->GetViewMatrix();
+	const Matrix& viewProjectionMatrix = Camera::GetCurrent()->GetViewProjectionMatrix();
+	const Culling::Planes& cullingPlanes = Camera::GetCurrent()->GetCullingPlanes();
 
 	// ビルボード行列の計算
 	billboardMatrix = backToFrontMatrix * viewMatrix;
 	billboardMatrix.r[3][0] = 0.0f;
 	billboardMatrix.r[3][1] = 0.0f;
 	billboardMatrix.r[3][2] = 0.0f;
+	// ビルボードとビュープロジェクションは全Particleで共通なので、VSに1度だけ渡す
+	particleViewCB_.data_->billboard = billboardMatrix;
+	particleViewCB_.data_->viewProjection = viewProjectionMatrix;
+	// 並べ替え用に、ワールド座標からビュー空間の深度を求める係数を取り出しておく
+	viewDepthAxis_ = { viewMatrix.r[0][2], viewMatrix.r[1][2], viewMatrix.r[2][2], viewMatrix.r[3][2] };
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+
+	// 並列に処理できるように番号の順に一覧にし、グループの行列はまとめて更新する
+	groupList_.clear();
+	groupObjects_.clear();
+	for (ParticleGroup* group : groupHandles_) {
+		groupList_.push_back(group);
+		groupObjects_.push_back(&group->object);
+	}
+	Object3D::UpdateMatrices(groupObjects_.data(), groupObjects_.size());
 
-	// 全てのパーティクルグループについて処理する
-	for (auto& [name, groupPtr] : particleGroups) {
-		auto& group = *groupPtr;
+	// 生存期間が過ぎたParticleは末尾と入れ替えて詰める（グループごとに並列）
+	jobSystem->ParallelFor(groupList_.size(), 1, [this](size_t begin, size_t end, size_t) {
+		for (size_t i = begin; i < end; ++i) {
+			groupList_[i]->particles.RemoveDead();
+		}
+	});
 
-		group.object.UpdateMatrix();
+	// 生きている数を数え直してから、予約された発生をまとめて行う
+	size_t numLive = 0;
+	for (ParticleGroup* group : groupList_) {
+		numLive += group->particles.Size();
+		group->budget.BeginFrame();
+	}
+	budget_.BeginFrame(numLive);
+	SpawnPendingEmits();
+	for (ParticleGroup* group : groupList_) {
+		group->budget.EndFrame();
+	}
+	budget_.EndFrame();
+
+	// 全グループのパーティクルを固定サイズの区間に分ける
+	chunks_.clear();
+	for (ParticleGroup* group : groupList_) {
+		size_t numParticle = group->particles.Size();
+		group->cullingRadius.resize(numParticle);
+		group->visible.resize(numParticle);
+		for (size_t begin = 0; begin < numParticle; begin += kChunkSize) {
+			size_t end = (std::min)(begin + kChunkSize, numParticle);
+			chunks_.push_back(ParticleChunk{ group, begin, end, 0, 0 });
+		}
+	}
 
-		uint32_t numInstance = 0; // 描画すべきインスタンス数
+	// 区間ごとにカリング
+	jobSystem->ParallelFor(chunks_.size(), 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t i = begin; i < end; ++i) {
+			CullChunk(chunks_[i], cullingPlanes);
+		}
+	});
+
+	// 見えている数の累積和で、各区間がinstancingBufferに書き込む位置を決める
+	uint32_t numCulled = 0;
+	uint32_t numDrawn = 0;
+	for (size_t i = 0; i < chunks_.size();) {
+		ParticleGroup* group = chunks_[i].group;
+		uint32_t offset = 0;
+		for (; i < chunks_.size() && chunks_[i].group == group; ++i) {
+			chunks_[i].instanceOffset = offset;
+			offset += chunks_[i].numVisible;
+			numCulled += static_cast<uint32_t>(chunks_[i].end - chunks_[i].begin) - chunks_[i].numVisible;
+		}
+		// 今回書き込むバッファに切り替える（足りなければここで広げるので、見えている分は全て書き込める）
+		group->instancingBuffer.BeginWrite(offset);
+		numDrawn += offset;
+		// 並べ替える場合は先に作業用の配列へ書き込む
+		if (group->sortMode != SortMode::None) {
+			group->unsortedInstances.resize(offset);
+			group->sortKeys.resize(offset);
+			group->sortIndices.resize(offset);
+			group->sortTempKeys.resize(offset);
+			group->sortTempIndices.resize(offset);
+		}
+	}
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleCulled, numCulled);
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleDrawn, numDrawn);
 
-		for (auto particleIterator = group.particles.begin(); particleIterator != group.particles.end();) {
-			if (particleIterator->lifeTime <= particleIterator->currentTime) {
-				particleIterator = group.particles.erase(particleIterator); // 生存期間が過ぎたParticleはlistから消す。戻り値が次のイテレーターとなる
-				continue;
-			}
+	// Fieldとコライダーの登録内容が変わっていれば範囲のAABBTreeを作り直す（区間ごとの評価は並列に行う）
+	forceFields_.Build();
+	collisions_.Build();
 
-			Matrix worldMatrix = particleIterator->transform.MakeAffineMatrix();
-			Matrix viewProjectionMatrix = viewMatrix * projectionMatrix;
-			Matrix worldViewProjectionMatrix = worldMatrix * billboardMatrix * viewProjectionMatrix;
+	// 区間ごとにインスタンスの書き込みと移動
+	jobSystem->ParallelFor(chunks_.size(), 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t i = begin; i < end; ++i) {
+			SimulateChunk(chunks_[i]);
+		}
+	});
+
+	// 描画順を指定されたグループを並べ替える
+	uint32_t numSorted = 0;
+	for (ParticleGroup* group : groupList_) {
+		if (group->sortMode == SortMode::None) {
+			continue;
+		}
+		SortInstances(*group);
+		numSorted += group->instancingBuffer.GetNumWritten();
+	}
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleSorted, numSorted);
+}
 
-			if (numInstance < group.instancingBuffer.numMaxInstance_) { // パーティクルのインスタンス数がバッファのサイズを超えないようにする
-				group.instancingBuffer.data_[numInstance].WVP = worldViewProjectionMatrix;
-				group.instancingBuffer.data_[numInstance].World = worldMatrix;
-				group.instancingBuffer.data_[numInstance].color = particleIterator->color; // パーティクルの色をそのままコピー
+void ParticleManager::CullChunk(ParticleChunk& chunk, const Culling::Planes& cullingPlanes)
+{
+	ParticleGroup& group = *chunk.group;
+	ParticleStorage& particles = group.particles;
+	size_t count = chunk.end - chunk.begin;
+
+	// ビルボードでどの向きに回ってもよいように、モデルを原点中心の球で囲んでカリングする
+	float modelRadius = ComputeModelRadius(group.object.model_);
+	for (size_t i = chunk.begin; i < chunk.end; ++i) {
+		group.cullingRadius[i] = modelRadius * particles.scale[i];
+	}
+	size_t numVisible = Culling::CullSpheres(cullingPlanes,
+		particles.positionX.data() + chunk.begin, particles.positionY.data() + chunk.begin, particles.positionZ.data() + chunk.begin,
+		group.cullingRadius.data() + chunk.begin, count, group.visible.data() + chunk.begin);
+	chunk.numVisible = static_cast<uint32_t>(numVisible);
+}
 
-				float alpha = 1.0f - (particleIterator->currentTime / particleIterator->lifeTime); // 経過時間に応じたAlpha値を算出
-				group.instancingBuffer.data_[numInstance].color.w = alpha; // GPUに送る
+void ParticleManager::SimulateChunk(const ParticleChunk& chunk)
+{
+	ParticleGroup& group = *chunk.group;
+	ParticleStorage& particles = group.particles;
+
+	// 経過時間に応じたAlpha値を算出し、色と合わせてRGBA8に詰める
+	float alpha[kChunkSize];
+	uint32_t color[kChunkSize];
+	ParticleKernel::ComputeAlpha(particles, chunk.begin, chunk.end, alpha);
+	ParticleKernel::PackColors(particles, chunk.begin, chunk.end, alpha, color);
+
+	// 並べ替える場合は作業用の配列に書き込み、後でinstancingBufferへ写す
+	bool isSorted = group.sortMode != SortMode::None;
+	Object3D::ParticleForGPU* instances = isSorted ? group.unsortedInstances.data() : group.instancingBuffer.GetData();
+	uint32_t instanceIndex = chunk.instanceOffset; // この区間が書き込む位置
+
+	for (size_t i = chunk.begin; i < chunk.end; ++i) {
+		// 視錐台の外にあるParticleは書き込まない
+		if (!group.visible[i]) {
+			continue;
+		}
+		// 行列はVSで合成するので、位置・スケール・回転・色だけ送る
+		Object3D::ParticleForGPU& instance = instances[instanceIndex];
+		instance.position = { particles.positionX[i], particles.positionY[i], particles.positionZ[i] };
+		instance.scale = particles.scale[i];
+		instance.rotation = particles.rotation[i];
+		instance.color = color[i - chunk.begin];
+		if (isSorted) {
+			// ビュー空間の深度をキーにする（遠い順にする場合はキーを反転して昇順に並べる）
+			float depth = particles.positionX[i] * viewDepthAxis_.x + particles.positionY[i] * viewDepthAxis_.y +
+				particles.positionZ[i] * viewDepthAxis_.z + viewDepthAxis_.w;
+			uint32_t key = RadixSort::FloatToKey(depth);
+			group.sortKeys[instanceIndex] = group.sortMode == SortMode::BackToFront ? RadixSort::InvertKey(key) : key;
+			group.sortIndices[instanceIndex] = instanceIndex;
+		}
+		++instanceIndex;
+	}
 
-				++numInstance; // 生きているParticleの数を1つカウントする
-			}
+	// 区間と重なるFieldだけを適用し、全てのParticleを移動させる
+	forceFields_.Apply(particles, chunk.begin, chunk.end, kDeltaTime);
+	ParticleKernel::Integrate(particles, chunk.begin, chunk.end, kDeltaTime);
+	// 移動後にコライダーの内側に入ったParticleを押し戻すか消す
+	collisions_.Apply(particles, chunk.begin, chunk.end);
+}
 
-			// Fieldの範囲内のParticleには加速度を適用する
-			if (IsCollision(accelerationField.area, particleIterator->transform.translate)) {
-				particleIterator->velocity += accelerationField.acceleration * kDeltaTime;
-			}
+void ParticleManager::SortInstances(ParticleGroup& group)
+{
+	uint32_t count = group.instancingBuffer.GetNumWritten();
+	if (count == 0) {
+		return;
+	}
 
-			// Particleの更新処理
-			particleIterator->transform.translate += particleIterator->velocity * kDeltaTime;
-			particleIterator->currentTime += kDeltaTime; // 経過時間を足す
+	// キーの順に番号を並べる（数が多ければブロックに分けて並列に行う）
+	if (count >= kParallelSortThreshold) {
+		RadixSort::SortParallel(group.sortKeys.data(), group.sortIndices.data(), count, group.sortTempKeys.data(), group.sortTempIndices.data());
+	} else {
+		RadixSort::Sort(group.sortKeys.data(), group.sortIndices.data(), count, group.sortTempKeys.data(), group.sortTempIndices.data());
+	}
 
-			++particleIterator; // 次のイテレータに進める
+	// 並べた順にinstancingBufferへ写す（書き込みは先頭から順番になる）
+	Object3D::ParticleForGPU* instances = group.instancingBuffer.GetData();
+	const Object3D::ParticleForGPU* source = group.unsortedInstances.data();
+	const uint32_t* indices = group.sortIndices.data();
+	JobSystem::GetInstance()->ParallelFor(count, kChunkSize * 8, [&](size_t begin, size_t end, size_t) {
+		for (size_t i = begin; i < end; ++i) {
+			instances[i] = source[indices[i]];
 		}
-	}
+	});
 }
 
 void ParticleManager::Draw()
 {
 	for (auto& [name, groupPtr] : particleGroups) {
 		auto& group = *groupPtr;
-		uint32_t numInstance = static_cast<uint32_t>(group.particles.size());
-		group.object.DrawInstancing(group.instancingBuffer, numInstance, group.textureHandle);
+		// 見えているParticleがなければドローコールを積まない
+		if (group.instancingBuffer.GetNumWritten() == 0) {
+			continue;
+		}
+		group.object.DrawInstancing(group.instancingBuffer, particleViewCB_, group.textureHandle);
 	}
 }
 
+void ParticleManager::Emit(GroupHandle group, const Transform& transform, const EmitterShape& shape, uint32_t count)
+{
+	assert(group < groupHandles_.size()); // 作成済みのパーティクルグループかチェック
+
+	if (!emitQueue_.TryPush(EmitRequest{ group, count, transform, shape })) {
+		// 満杯なら捨てて、次のUpdateで数だけ記録する
+		numDroppedEmits_.fetch_add(count, std::memory_order_relaxed);
+	}
+}
+
+void ParticleManager::Emit(GroupHandle group, const Float3& position, uint32_t count)
+{
+	Transform transform;
+	transform.scale = { 1.0f, 1.0f, 1.0f };
+	transform.rotate = { 0.0f, 0.0f, 0.0f };
+	transform.translate = position;
+	Emit(group, transform, EmitterShape::Box({ kEmitSpread, kEmitSpread, kEmitSpread }), count);
+}
+
 void ParticleManager::Emit(const std::string name, const Float3& position, uint32_t count)
 {
-	auto it = particleGroups.find(name);
-	assert(it != particleGroups.end()); // 登録済みのパーティクルグループかチェック
+	GroupHandle group = FindGroup(name);
+	assert(group != kInvalidGroup); // 登録済みのパーティクルグループかチェック
+	Emit(group, position, count);
+}
+
+void ParticleManager::SpawnPendingEmits()
+{
+	// 予約を全て取り出す
+	pendingEmits_.clear();
+	EmitRequest request;
+	while (emitQueue_.TryPop(request)) {
+		pendingEmits_.push_back(request);
+	}
+	uint32_t numDropped = numDroppedEmits_.exchange(0, std::memory_order_relaxed);
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleEmitThrottled, numDropped);
+	if (pendingEmits_.empty()) {
+		return;
+	}
 
-	// 指定されたパーティクルグループを取得
-	auto& group = *it->second;
-	// 新たなパーティクルを作成し、指定されたパーティクルグループに登録
-	for (uint32_t i = 0; i < count; ++i) {
-		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
-		Particle particle;
-		particle.transform.scale = { 1.0f, 1.0f, 1.0f };
-		particle.transform.rotate = { 0.0f, 0.0f, 0.0f };
-		particle.transform.translate = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
-		particle.velocity = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+	// カメラからの見え方と上限に応じて、予約ごとに発生数を減らす（上限を超える分は発生させない）
+	Camera* camera = Camera::GetCurrent();
+	uint32_t numRequested = 0;
+	uint32_t numEmitted = 0;
+	for (EmitRequest& pending : pendingEmits_) {
+		ParticleGroup& group = *groupHandles_[pending.group];
+		float lodScale = 1.0f;
+		if (camera) {
+			// 発生範囲とモデルの大きさを合わせた球で見積もる
+			const Float3& scale = pending.transform.scale;
+			float maxScale = (std::max)({ fabsf(scale.x), fabsf(scale.y), fabsf(scale.z) });
+			float radius = pending.shape.GetBoundingRadius() * maxScale + ComputeModelRadius(group.object.model_);
+			lodScale = budget_.ComputeLodScale(pending.transform.translate, radius, camera->GetViewMatrix(), camera->GetProjectionMatrix());
+		}
+		numRequested += pending.count;
+		pending.count = budget_.Allow(group.budget, group.particles.Size() + group.pendingEmitCount, pending.count, lodScale);
+		group.pendingEmitCount += pending.count;
+		numEmitted += pending.count;
+	}
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleEmitted, numEmitted);
+	FrameStats::GetInstance()->Add(FrameStats::Counter::ParticleEmitThrottled, numRequested - numEmitted);
+
+	// グループごとに1度だけ追加し、発生位置によらない値は追加した全体をまとめて乱数で埋める
+	for (ParticleGroup* groupPtr : groupHandles_) {
+		ParticleGroup& group = *groupPtr;
+		uint32_t count = group.pendingEmitCount;
+		if (count == 0) {
+			continue;
+		}
+		ParticleStorage& particles = group.particles;
+		size_t first = particles.Append(count);
+		group.emitCursor = first;
 
-		Float3 randomTranslate{ distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
-		particle.transform.translate = position + randomTranslate;
+		random_.FillUniform(particles.velocityX.data() + first, count, -1.0f, 1.0f);
+		random_.FillUniform(particles.velocityY.data() + first, count, -1.0f, 1.0f);
+		random_.FillUniform(particles.velocityZ.data() + first, count, -1.0f, 1.0f);
 
 		// 色をランダムに初期化
-		std::uniform_real_distribution<float> distColor(0.0f, 1.0f);
-		particle.color = { distColor(randomEngine), distColor(randomEngine), distColor(randomEngine), 1.0f };
+		random_.FillUniform(particles.colorR.data() + first, count, 0.0f, 1.0f);
+		random_.FillUniform(particles.colorG.data() + first, count, 0.0f, 1.0f);
+		random_.FillUniform(particles.colorB.data() + first, count, 0.0f, 1.0f);
+		std::fill_n(particles.colorA.data() + first, count, 1.0f);
 
-		// 生存可能時間と経過時間を初期化
-		std::uniform_real_distribution<float> distTime(1.0f, 3.0f);
-		particle.lifeTime = distTime(randomEngine);
-		particle.currentTime = 0;
+		// 生存可能時間を初期化（経過時間は0から始まる）
+		random_.FillUniform(particles.lifeTime.data() + first, count, 1.0f, 3.0f);
+	}
+
+	// 予約の順に、形の中の位置を求めてエミッタのTransformで配置する
+	for (EmitRequest& pending : pendingEmits_) {
+		uint32_t count = pending.count;
+		if (count == 0) {
+			continue;
+		}
+		ParticleGroup& group = *groupHandles_[pending.group];
+		ParticleStorage& particles = group.particles;
+		size_t first = group.emitCursor;
+		group.emitCursor += count;
+
+		float* positionX = particles.positionX.data() + first;
+		float* positionY = particles.positionY.data() + first;
+		float* positionZ = particles.positionZ.data() + first;
+		emitDirectionX_.resize((std::max)(emitDirectionX_.size(), size_t(count)));
+		emitDirectionY_.resize(emitDirectionX_.size());
+		emitDirectionZ_.resize(emitDirectionX_.size());
+		pending.shape.Sample(random_, count, positionX, positionY, positionZ,
+			emitDirectionX_.data(), emitDirectionY_.data(), emitDirectionZ_.data());
+
+		// ローカル座標からワールド座標へ（行ベクトルなので p * M）
+		Matrix m = pending.transform.MakeAffineMatrix();
+		for (uint32_t i = 0; i < count; ++i) {
+			float x = positionX[i], y = positionY[i], z = positionZ[i];
+			positionX[i] = x * m.r[0][0] + y * m.r[1][0] + z * m.r[2][0] + m.r[3][0];
+			positionY[i] = x * m.r[0][1] + y * m.r[1][1] + z * m.r[2][1] + m.r[3][1];
+			positionZ[i] = x * m.r[0][2] + y * m.r[1][2] + z * m.r[2][2] + m.r[3][2];
+		}
 
-		// 新たなパーティクルをパーティクルグループに追加
-		group.particles.push_back(particle);
+		// 形の向きに沿った速さを初速度に加える（向きは回転だけ反映し、スケールは掛けない）
+		float speed = pending.shape.speed;
+		if (speed != 0.0f) {
+			Matrix rotation = Matrix::Affine({ 1.0f, 1.0f, 1.0f }, pending.transform.rotate, { 0.0f, 0.0f, 0.0f });
+			float* velocityX = particles.velocityX.data() + first;
+			float* velocityY = particles.velocityY.data() + first;
+			float* velocityZ = particles.velocityZ.data() + first;
+			for (uint32_t i = 0; i < count; ++i) {
+				float x = emitDirectionX_[i], y = emitDirectionY_[i], z = emitDirectionZ_[i];
+				velocityX[i] += (x * rotation.r[0][0] + y * rotation.r[1][0] + z * rotation.r[2][0]) * speed;
+				velocityY[i] += (x * rotation.r[0][1] + y * rotation.r[1][1] + z * rotation.r[2][1]) * speed;
+				velocityZ[i] += (x * rotation.r[0][2] + y * rotation.r[1][2] + z * rotation.r[2][2]) * speed;
+			}
+		}
+	}
+
+	for (ParticleGroup* group : groupHandles_) {
+		group->pendingEmitCount = 0;
 	}
 }
 
+void ParticleManager::SetGroupBudget(const std::string name, uint32_t maxParticles)
+{
+	auto it = particleGroups.find(name);
+	assert(it != particleGroups.end()); // 登録済みのパーティクルグループかチェック
+
+	it->second->budget.maxParticles = maxParticles;
+}
+
+void ParticleManager::SetSortMode(const std::string name, SortMode sortMode)
+{
+	auto it = particleGroups.find(name);
+	assert(it != particleGroups.end()); // 登録済みのパーティクルグループかチェック
+
+	it->second->sortMode = sortMode;
+}
+
 void ParticleManager::SetTexture(const std::string name, uint32_t textureHandle)
 {
 	auto it = particleGroups.find(name);
@@ -163,3 +469,41 @@ void ParticleManager::SetTexture(const std::string name, uint32_t textureHandle)
 	// モデルをロードし、ParticleGroupにセット
 	it->second->textureHandle = textureHandle;
 }
+
+std::vector<ParticleManager::InstanceBufferReport> ParticleManager::GetInstanceBufferReport() const
+{
+	std::vector<InstanceBufferReport> report;
+	report.reserve(particleGroups.size());
+	for (auto& [name, groupPtr] : particleGroups) {
+		const auto& buffer = groupPtr->instancingBuffer;
+		report.push_back(InstanceBufferReport{ name, buffer.GetNumWritten(), buffer.GetCapacity(), buffer.GetHighWaterMark(), buffer.GetGrowCount() });
+	}
+	// 表示順が毎回変わらないように名前順に並べる
+	std::sort(report.begin(), report.end(), [](const InstanceBufferReport& a, const InstanceBufferReport& b) { return a.name < b.name; });
+	return report;
+}
+
+void ParticleManager::DrawImGui()
+{
+	ImGui::Begin("ParticleManager");
+	for (const InstanceBufferReport& report : GetInstanceBufferReport()) {
+		ImGui::Text("%s: %u / %u (high water %u, grow %u)", report.name.c_str(), report.numWritten, report.capacity, report.highWaterMark, report.growCount);
+	}
+
+	// 発生数の上限の使用状況（全体と、名前順のグループごと）
+	ImGui::Separator();
+	ParticleBudget::Report budgetReport = budget_.GetReport();
+	ImGui::Text("Budget: %u / %u live, emitted %u / %u requested", budgetReport.numLive, budgetReport.maxParticles, budgetReport.emitted, budgetReport.requested);
+	std::vector<const std::string*> names;
+	names.reserve(particleGroups.size());
+	for (auto& [name, groupPtr] : particleGroups) {
+		names.push_back(&name);
+	}
+	std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+	for (const std::string* name : names) {
+		const ParticleGroup& group = *particleGroups.at(*name);
+		ImGui::Text("%s: %zu / %u live, emitted %u / %u requested (scale %.2f)", name->c_str(), group.particles.Size(), group.budget.maxParticles,
+			group.budget.lastEmitted, group.budget.lastRequested, group.budget.scale);
+	}
+	ImGui::End();
+}
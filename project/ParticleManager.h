@@ -1,39 +1,71 @@
 #pragma once
 #include <random>
-#include <list>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
 
 #include "DirectXBase.h"
 #include "SRVManager.h"
 #include "Object3D.h"
+#include "ParticleStorage.h"
+#include "Culling.h"
+#include "Random.h"
+#include "ForceFieldSystem.h"
+#include "ParticleCollisionSystem.h"
+#include "ParticleBudget.h"
+#include "MPSCQueue.h"
+#include "EmitterShape.h"
 
 class ParticleManager
 {
 public:
-	struct Particle {
-		Transform transform;
-		Float3 velocity;
-		Float4 color;
-		float lifeTime;
-		float currentTime;
+	// インスタンスの描画順
+	enum class SortMode {
+		None,			// 並べ替えない（リストの順）
+		BackToFront,	// カメラから遠い順（半透明の合成用）
+		FrontToBack,	// カメラに近い順（不透明で深度テストを効かせる用）
 	};
 
 	struct ParticleGroup {
 		Object3D object;
 		uint32_t textureHandle;
-		std::list<Particle> particles;
-		StructuredBuffer<Object3D::ParticleForGPU> instancingBuffer;
+		// パーティクル本体（要素ごとの配列）
+		ParticleStorage particles;
+		// 見えているパーティクルのインスタンス（足りなければ倍に広げる）
+		RingStructuredBuffer<Object3D::ParticleForGPU> instancingBuffer;
+		// カリング用の作業領域（境界球の半径と判定結果）
+		std::vector<float> cullingRadius;
+		std::vector<uint8_t> visible;
+
+		// 描画順
+		SortMode sortMode = SortMode::None;
+		// 並べ替える場合は、インスタンスを一度ここに書き込んでから並べた順にinstancingBufferへ写す
+		std::vector<Object3D::ParticleForGPU> unsortedInstances;
+		// ビュー空間の深度から作ったキーと、unsortedInstancesの番号（と基数ソートの作業領域）
+		std::vector<uint32_t> sortKeys, sortIndices, sortTempKeys, sortTempIndices;
+
+		// 発生数の上限と使用状況
+		ParticleBudget::GroupState budget;
+		// Updateでまとめて発生させる数と、次に書き込む位置（キューを処理している間だけ使う）
+		uint32_t pendingEmitCount = 0;
+		size_t emitCursor = 0;
 
-		ParticleGroup() : instancingBuffer(100){}
+		ParticleGroup(uint32_t instanceCapacity) : instancingBuffer(instanceCapacity){}
 	};
 
-	// Field
-	struct AccelerationField {
-		Float3 acceleration; //!< 加速度
-		AABB area; //!< 範囲
+	// インスタンスバッファの使用状況（容量の調整用）
+	struct InstanceBufferReport {
+		std::string name;
+		uint32_t numWritten; //!< 直前のフレームで書き込んだ数
+		uint32_t capacity; //!< 直前のフレームで書き込んだバッファの容量
+		uint32_t highWaterMark; //!< これまでに書き込んだ数の最大値
+		uint32_t growCount; //!< 容量が足りずに作り直した回数
 	};
 
+	// パーティクルグループを指す番号（名前を引かずにEmitする用）
+	using GroupHandle = uint32_t;
+	static constexpr GroupHandle kInvalidGroup = UINT32_MAX;
+
 public:
 	ParticleManager* GetInstance();
 
@@ -41,10 +73,37 @@ public:
 	void Update();
 	void Draw();
 
-	void CreateParticleGroup(const std::string name);
+	// capacityはあらかじめ確保しておくパーティクル数（超えた場合は倍に広げる）
+	// グループの作成はEmitを呼ぶスレッドが動き出す前に行うこと
+	GroupHandle CreateParticleGroup(const std::string name, size_t capacity = kDefaultCapacity);
+	// 名前からグループの番号を引く（なければkInvalidGroup）
+	GroupHandle FindGroup(const std::string& name) const;
 	void SetModel(const std::string name, ModelManager::ModelData* model);
 	void SetTexture(const std::string name, uint32_t textureHandle);
+	// 発生を予約する（どのスレッドから呼んでもよい）
+	// 予約は次のUpdateの始めにまとめて発生させる。キューが満杯なら捨てる
+	// shapeの範囲をtransformで配置した位置に発生させる（shapeがメッシュを指す場合は、Updateまで破棄しないこと）
+	void Emit(GroupHandle group, const Transform& transform, const EmitterShape& shape, uint32_t count);
+	// positionの周り±kEmitSpreadの箱の中に発生させる
+	void Emit(GroupHandle group, const Float3& position, uint32_t count);
 	void Emit(const std::string name, const Float3& position, uint32_t count);
+	// グループで生きているパーティクル数の上限を設定する（既定はParticleBudget::Settings::defaultGroupMaxParticles）
+	void SetGroupBudget(const std::string name, uint32_t maxParticles);
+	// 描画順を設定する（既定はSortMode::None）
+	void SetSortMode(const std::string name, SortMode sortMode);
+
+	// パーティクルに作用するFieldの一覧（追加・削除はUpdateの外で行うこと）
+	ForceFieldSystem& GetForceFields() { return forceFields_; }
+	// パーティクルが衝突するコライダーの一覧（追加・削除はUpdateの外で行うこと）
+	ParticleCollisionSystem& GetCollisions() { return collisions_; }
+
+	// 全体の上限とLODの設定
+	ParticleBudget& GetBudget() { return budget_; }
+
+	// グループごとのインスタンスバッファの使用状況
+	std::vector<InstanceBufferReport> GetInstanceBufferReport() const;
+	// ImGuiにインスタンスバッファと発生数の上限の使用状況を表示
+	void DrawImGui();
 
 	// パーティクルグループコンテナ
 	std::unordered_map<std::string, std::unique_ptr<ParticleGroup>> particleGroups;
@@ -54,16 +113,92 @@ private:
 
 	// 乱数生成器の初期化
 	std::random_device seedGenerator;
-	std::mt19937 randomEngine;
+	Random random_;
 
 	// Δtを定義
 	const float kDeltaTime = 1.0f / 60.0f;
+	// パーティクルグループごとに確保しておくパーティクル数の既定値
+	static constexpr size_t kDefaultCapacity = 1024;
+	// Emitで発生位置の周りに散らす範囲（各軸±この値）
+	static constexpr float kEmitSpread = 1.0f;
 	// 反対側に回す回転行列
 	Matrix backToFrontMatrix;
 	// billboard行列
 	Matrix billboardMatrix;
+	// ビルボードとビュープロジェクション行列（全グループ共通で、合成はVSで行う）
+	ConstBuffer<Object3D::ParticleViewForGPU> particleViewCB_;
+
+	// ビュー行列のZ列（ワールド座標との内積 + wでビュー空間の深度になる）
+	Float4 viewDepthAxis_ = { 0.0f, 0.0f, 1.0f, 0.0f };
 
 	// Field
-	AccelerationField accelerationField;
+	ForceFieldSystem forceFields_;
+	// コライダー
+	ParticleCollisionSystem collisions_;
+
+	// 発生数の上限とLOD
+	ParticleBudget budget_;
+
+	///
+	/// 発生の予約
+	///
+
+	struct EmitRequest {
+		GroupHandle group;
+		uint32_t count;
+		Transform transform;
+		EmitterShape shape;
+	};
+
+	// 1フレームに予約できる数
+	static constexpr size_t kEmitQueueCapacity = 4096;
+
+	// 予約をまとめて発生させる（Updateの始めに呼ぶ）
+	void SpawnPendingEmits();
+
+	// 番号ごとのグループと、名前から番号を引くための表
+	std::vector<ParticleGroup*> groupHandles_;
+	std::unordered_map<std::string, GroupHandle> groupNames_;
+	// どのスレッドからでも積める予約のキュー
+	MPSCQueue<EmitRequest> emitQueue_{ kEmitQueueCapacity };
+	// キューから取り出した予約と、形から求めた向き（作業用）
+	std::vector<EmitRequest> pendingEmits_;
+	std::vector<float> emitDirectionX_, emitDirectionY_, emitDirectionZ_;
+	// キューが満杯で捨てたパーティクル数
+	std::atomic<uint32_t> numDroppedEmits_ = 0;
+
+	///
+	/// 並列更新
+	///
+
+	// 1つのジョブで処理するパーティクル数
+	// スレッド数によらずこの単位で分けるので、インスタンスの並びは常に同じになる
+	static constexpr size_t kChunkSize = 1024;
+	// 描画するインスタンス数がこれ以上のグループは、並べ替えを並列に行う
+	static constexpr uint32_t kParallelSortThreshold = 32768;
+
+	// グループ内のパーティクルの一区間
+	struct ParticleChunk {
+		ParticleGroup* group;
+		size_t begin;
+		size_t end;
+		// 区間内で見えているパーティクル数
+		uint32_t numVisible;
+		// instancingBufferに書き込み始める位置（見えている数の累積和）
+		uint32_t instanceOffset;
+	};
+
+	// 区間ごとにカリングを行う
+	void CullChunk(ParticleChunk& chunk, const Culling::Planes& cullingPlanes);
+	// 区間ごとにインスタンスを書き込み、Field・移動・衝突を適用する
+	void SimulateChunk(const ParticleChunk& chunk);
+	// 書き込んだインスタンスを深度の順に並べ、instancingBufferへ写す
+	void SortInstances(ParticleGroup& group);
+
+	// 毎フレーム作り直す作業用の配列
+	std::vector<ParticleGroup*> groupList_;
+	// groupList_と同じ順のObject3D（行列をまとめて更新する用）
+	std::vector<Object3D*> groupObjects_;
+	std::vector<ParticleChunk> chunks_;
 };
 
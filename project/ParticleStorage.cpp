@@ -0,0 +1,110 @@
+#include "ParticleStorage.h"
+#include <cassert>
+#include <algorithm>
+#include "SimdMath.h"
+
+namespace {
+	// 全配列（まとめて広げたり詰めたりする用）
+	constexpr std::vector<float> ParticleStorage::* kStreams[] = {
+		&ParticleStorage::positionX, &ParticleStorage::positionY, &ParticleStorage::positionZ,
+		&ParticleStorage::velocityX, &ParticleStorage::velocityY, &ParticleStorage::velocityZ,
+		&ParticleStorage::colorR, &ParticleStorage::colorG, &ParticleStorage::colorB, &ParticleStorage::colorA,
+		&ParticleStorage::lifeTime, &ParticleStorage::age,
+		&ParticleStorage::scale, &ParticleStorage::rotation,
+	};
+}
+
+void ParticleStorage::Reserve(size_t capacity)
+{
+	if (capacity <= capacity_) {
+		return;
+	}
+	for (std::vector<float> ParticleStorage::* stream : kStreams) {
+		(this->*stream).resize(capacity);
+	}
+	capacity_ = capacity;
+}
+
+size_t ParticleStorage::Append(size_t count)
+{
+	// 容量が足りなければ、足りるまで倍に広げる
+	if (capacity_ < count_ + count) {
+		size_t capacity = capacity_ ? capacity_ : 64;
+		while (capacity < count_ + count) {
+			capacity *= 2;
+		}
+		Reserve(capacity);
+	}
+
+	size_t first = count_;
+	count_ += count;
+	std::fill(age.begin() + first, age.begin() + count_, 0.0f);
+	std::fill(scale.begin() + first, scale.begin() + count_, 1.0f);
+	std::fill(rotation.begin() + first, rotation.begin() + count_, 0.0f);
+	return first;
+}
+
+void ParticleStorage::RemoveSwapBack(size_t index)
+{
+	assert(index < count_);
+	size_t last = --count_;
+	if (index == last) {
+		return;
+	}
+	for (std::vector<float> ParticleStorage::* stream : kStreams) {
+		(this->*stream)[index] = (this->*stream)[last];
+	}
+}
+
+size_t ParticleStorage::RemoveDead()
+{
+	size_t removed = 0;
+	for (size_t index = 0; index < count_;) {
+		if (lifeTime[index] <= age[index]) {
+			// 末尾の要素が移ってくるので、同じ位置をもう一度調べる
+			RemoveSwapBack(index);
+			++removed;
+			continue;
+		}
+		++index;
+	}
+	return removed;
+}
+
+AABB ParticleStorage::ComputeBounds(size_t begin, size_t end) const
+{
+	const float* streams[3] = { positionX.data(), positionY.data(), positionZ.data() };
+	float minValue[3];
+	float maxValue[3];
+	for (size_t axis = 0; axis < 3; ++axis) {
+		const float* p = streams[axis];
+		float lo = p[begin];
+		float hi = p[begin];
+		size_t i = begin;
+		// 4つずつ最小・最大を取り、最後に4要素をまとめる
+		if (i + 4 <= end) {
+			Simd::Vec4 vmin = Simd::Load(p + i);
+			Simd::Vec4 vmax = vmin;
+			for (i += 4; i + 4 <= end; i += 4) {
+				Simd::Vec4 v = Simd::Load(p + i);
+				vmin = Simd::Min(vmin, v);
+				vmax = Simd::Max(vmax, v);
+			}
+			float lanesMin[4];
+			float lanesMax[4];
+			Simd::Store(lanesMin, vmin);
+			Simd::Store(lanesMax, vmax);
+			for (size_t lane = 0; lane < 4; ++lane) {
+				lo = (std::min)(lo, lanesMin[lane]);
+				hi = (std::max)(hi, lanesMax[lane]);
+			}
+		}
+		for (; i < end; ++i) {
+			lo = (std::min)(lo, p[i]);
+			hi = (std::max)(hi, p[i]);
+		}
+		minValue[axis] = lo;
+		maxValue[axis] = hi;
+	}
+	return AABB{ { minValue[0], minValue[1], minValue[2] }, { maxValue[0], maxValue[1], maxValue[2] } };
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MyMath.h"
+
+// パーティクルを要素ごとの配列（SoA）で保持する
+// ・各配列はCapacityの長さで確保しておき、先頭からSize個が生きているパーティクル
+// ・削除は末尾の要素を空いた位置に移して詰める（順番は保たれない）
+// ・容量が足りなくなったときだけ倍に広げる
+class ParticleStorage
+{
+public:
+	// 容量を確保する（既存の要素はそのまま）
+	void Reserve(size_t capacity);
+	// 全て削除する（容量はそのまま）
+	void Clear() { count_ = 0; }
+
+	// 末尾にcount個追加し、先頭の位置を返す（まとめて書き込む用）
+	// 経過時間は0、スケールは1、回転は0で初期化し、それ以外は呼び出し側で書き込む
+	size_t Append(size_t count);
+	// index番目を削除し、末尾の要素で埋める
+	void RemoveSwapBack(size_t index);
+	// 経過時間が生存期間を過ぎたものを全て削除し、削除した数を返す
+	size_t RemoveDead();
+
+	// 生きているパーティクルの数
+	size_t Size() const { return count_; }
+	// 確保済みの数
+	size_t Capacity() const { return capacity_; }
+
+	// [begin, end) のパーティクルの位置を囲むAABB（begin < endであること）
+	AABB ComputeBounds(size_t begin, size_t end) const;
+
+	// 位置
+	std::vector<float> positionX, positionY, positionZ;
+	// 速度
+	std::vector<float> velocityX, velocityY, velocityZ;
+	// 色
+	std::vector<float> colorR, colorG, colorB, colorA;
+	// 生存可能時間と経過時間
+	std::vector<float> lifeTime, age;
+	// 一様スケールとZ軸回転
+	std::vector<float> scale, rotation;
+
+private:
+	size_t count_ = 0;
+	size_t capacity_ = 0;
+};
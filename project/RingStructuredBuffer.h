@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include "DirectXUtil.h"
+#include "DirectXBase.h"
+#include "SRVManager.h"
+
+// フレームごとに書き込み先を切り替え、足りなくなったら倍に広げるStructuredBuffer
+// ・kNumVersions個のバッファを順番に使うので、GPUが読んでいる途中のバッファにCPUが書き込むことはない
+//   （同時に処理中のフレームがkNumVersions - 1以下であること）
+// ・広げるのは書き込み先のバッファだけで、SRVも同じデスクリプタに作り直す
+template<class Type>
+class RingStructuredBuffer
+{
+public:
+	// 書き込み先を切り替えて使うバッファの数
+	static constexpr uint32_t kNumVersions = 2;
+
+	RingStructuredBuffer(uint32_t initialCapacity)
+	{
+		for (Version& version : versions_) {
+			version.srvIndex = SRVManager::GetInstance()->Allocate();
+			Create(version, (std::max)(initialCapacity, 1u));
+		}
+	}
+
+	// 次のバッファに切り替え、count個書き込めるようにして先頭を返す
+	// 書き込んだ数はcountとして記録され、描画時のインスタンス数になる
+	Type* BeginWrite(uint32_t count)
+	{
+		current_ = (current_ + 1) % kNumVersions;
+		Version& version = versions_[current_];
+		if (version.capacity < count) {
+			Create(version, (std::max)(count, version.capacity * 2));
+			++growCount_;
+		}
+		numWritten_ = count;
+		highWaterMark_ = (std::max)(highWaterMark_, count);
+		return version.data;
+	}
+
+	// 直前のBeginWriteで書き込んだバッファ
+	Type* GetData() const { return versions_[current_].data; }
+	uint32_t GetSRVIndex() const { return versions_[current_].srvIndex; }
+
+	// 直前のBeginWriteで書き込んだ数
+	uint32_t GetNumWritten() const { return numWritten_; }
+	// 直前のBeginWriteで書き込んだバッファの容量
+	uint32_t GetCapacity() const { return versions_[current_].capacity; }
+	// これまでに書き込んだ数の最大値
+	uint32_t GetHighWaterMark() const { return highWaterMark_; }
+	// 容量が足りずに作り直した回数
+	uint32_t GetGrowCount() const { return growCount_; }
+
+	// コピー不可にする
+	RingStructuredBuffer(const RingStructuredBuffer&) = delete;
+	RingStructuredBuffer(RingStructuredBuffer&&) = delete;
+	RingStructuredBuffer& operator=(const RingStructuredBuffer&) = delete;
+	RingStructuredBuffer& operator=(RingStructuredBuffer&&) = delete;
+
+private:
+	struct Version {
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		Type* data = nullptr;
+		uint32_t capacity = 0;
+		uint32_t srvIndex = 0;
+	};
+
+	// capacity個分のリソースを作り直し、SRVを同じデスクリプタに作る
+	void Create(Version& version, uint32_t capacity)
+	{
+		// 古いリソースはこのバッファを最後に使ったフレームの完了後なので、そのまま解放してよい
+		version.resource = CreateBufferResource(DirectXBase::GetInstance()->GetDevice(), sizeof(Type) * capacity);
+		version.data = nullptr;
+		version.resource->Map(0, nullptr, reinterpret_cast<void**>(&version.data));
+		version.capacity = capacity;
+		SRVManager::GetInstance()->CrateSRVforStructuredBuffer(version.srvIndex, version.resource.Get(), capacity, sizeof(Type));
+	}
+
+	Version versions_[kNumVersions];
+	uint32_t current_ = 0;
+
+	uint32_t numWritten_ = 0;
+	uint32_t highWaterMark_ = 0;
+	uint32_t growCount_ = 0;
+};
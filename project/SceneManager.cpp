@@ -1,5 +1,6 @@
 #include "SceneManager.h"
 #include <cassert>
+#include "ModelManager.h"
 
 SceneManager* SceneManager::GetInstance()
 {
@@ -44,6 +45,9 @@ void SceneManager::Update()
 
 		// 次シーンを初期化する
 		scene_->Initialize();
+
+		// 次シーンでも使うモデルは読み込み済みのものをそのまま使い、使わなくなったものだけ解放する
+		ModelManager::ReleaseUnused();
 	}
 
 	// 実行中シーンを更新する
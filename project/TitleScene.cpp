@@ -1,5 +1,6 @@
 #include "TitleScene.h" 
 #include "ImguiWrapper.h"
+#include "FrameStats.h"
 #include "DirectXBase.h"
 #include "SRVManager.h"
 #include "SpriteCommon.h"
@@ -41,11 +42,11 @@ void TitleScene::Initialize()
 	sprite_->SetSize({ 500.0f, 500.0f });
 
 	// モデル読み込み
-	model_ = ModelManager::LoadModelFile("resources/Models", "plane.obj", dxBase->GetDevice());
+	model_ = ModelManager::Load("resources/Models", "plane.obj");
 
 	// 3Dオブジェクトの生成とモデル指定
 	object_ = new Object3D();
-	object_->model_ = &model_;
+	object_->model_ = model_.get();
 	object_->transform_.rotate = { 0.0f, 3.14f, 0.0f };
 }
 
@@ -137,6 +138,9 @@ void TitleScene::Draw()
 
 	ImGui::End();
 
+	// フレームごとの統計
+	FrameStats::GetInstance()->DrawImGui();
+
 	// ImGuiの内部コマンドを生成する
 	ImguiWrapper::Render(dxBase->GetCommandList());
 	// 描画後処理
@@ -36,7 +36,7 @@ private:
 	///
 
 	// モデルデータ
-	ModelManager::ModelData model_;
+	ModelManager::ModelHandle model_;
 	// 3Dオブジェクト
 	Object3D* object_;
 
@@ -0,0 +1,98 @@
+#include "AABBTree.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <vector>
+#include <math.h>
+
+// AABBTreeのクエリと、全ての要素を1つずつ判定する線形探索を比べる
+// ・AABB: パーティクルの1チャンク分ほどの範囲（ForceFieldSystem / ParticleCollisionSystemの使い方）
+// ・点・レイ・視錐台はAABBTreeのその他のクエリ
+int main()
+{
+	const uint32_t kSizes[] = { 100, 1000, 10000, 100000 };
+	const int kQueryCount = 1000;
+
+	Transform camera{ { 1.0f, 1.0f, 1.0f }, { 0.1f, 0.3f, 0.0f }, { 0.0f, 0.0f, -600.0f } };
+	Matrix viewProjection = camera.MakeInverseAffineMatrix() * Matrix::PerspectiveFovLH(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	Culling::Planes planes = Culling::MakePlanes(Frustum::FromViewProjection(viewProjection));
+
+	std::printf("AABBTree vs linear scan (us per query, tree / linear)\n");
+	std::printf("%8s %18s %18s %18s %18s %10s %10s\n", "count", "aabb", "point", "ray", "frustum", "build ms", "refit ms");
+	for (uint32_t count : kSizes) {
+		// 一辺1000の空間に大きさ1～10の箱を置く
+		Random random(3);
+		std::vector<AABB> boxes(count);
+		AABBTree tree;
+		for (uint32_t index = 0; index < count; ++index) {
+			Float3 center = { random.Range(-500.0f, 500.0f), random.Range(-500.0f, 500.0f), random.Range(-500.0f, 500.0f) };
+			Float3 extent = { random.Range(0.5f, 5.0f), random.Range(0.5f, 5.0f), random.Range(0.5f, 5.0f) };
+			boxes[index] = AABB{ center - extent, center + extent };
+			tree.Insert(boxes[index], index);
+		}
+		double buildMs = Benchmark::MeasureMs(3, [&] { tree.Build(); });
+		double refitMs = Benchmark::MeasureMs(3, [&] { tree.Refit(); });
+
+		std::vector<AABB> queryBounds(kQueryCount);
+		std::vector<Float3> points(kQueryCount);
+		std::vector<Float3> directions(kQueryCount);
+		for (int query = 0; query < kQueryCount; ++query) {
+			points[query] = { random.Range(-500.0f, 500.0f), random.Range(-500.0f, 500.0f), random.Range(-500.0f, 500.0f) };
+			Float3 extent = { 10.0f, 10.0f, 10.0f };
+			queryBounds[query] = AABB{ points[query] - extent, points[query] + extent };
+			Float3 direction = { random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) };
+			directions[query] = direction * (1.0f / sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z));
+		}
+
+		std::vector<uint32_t> out;
+		auto measure = [&](auto&& queryOne) {
+			double ms = Benchmark::MeasureMs(3, [&] {
+				for (int query = 0; query < kQueryCount; ++query) {
+					out.clear();
+					queryOne(query);
+					Benchmark::DoNotOptimize(out.data());
+				}
+			});
+			return ms * 1e3 / kQueryCount;
+		};
+		auto linear = [&](auto&& hits) {
+			for (uint32_t index = 0; index < count; ++index) {
+				if (hits(boxes[index])) {
+					out.push_back(index);
+				}
+			}
+		};
+
+		double aabbTree = measure([&](int q) { tree.QueryAABB(queryBounds[q], out); });
+		double aabbLinear = measure([&](int q) { linear([&](const AABB& box) { return IsCollision(box, queryBounds[q]); }); });
+		double pointTree = measure([&](int q) { tree.QueryPoint(points[q], out); });
+		double pointLinear = measure([&](int q) { linear([&](const AABB& box) { return IsCollision(box, points[q]); }); });
+		double rayTree = measure([&](int q) { tree.QueryRay(points[q], directions[q], 300.0f, out); });
+		// 線形探索側もAABBTreeと同じスラブ法で判定する
+		double rayLinear = measure([&](int q) {
+			Float3 origin = points[q];
+			Float3 direction = directions[q];
+			linear([&](const AABB& box) {
+				float tMin = 0.0f;
+				float tMax = 300.0f;
+				const float o[3] = { origin.x, origin.y, origin.z };
+				const float d[3] = { direction.x, direction.y, direction.z };
+				const float lo[3] = { box.min.x, box.min.y, box.min.z };
+				const float hi[3] = { box.max.x, box.max.y, box.max.z };
+				for (int axis = 0; axis < 3; ++axis) {
+					float inverse = d[axis] != 0.0f ? 1.0f / d[axis] : 1.0e30f;
+					float t1 = (lo[axis] - o[axis]) * inverse;
+					float t2 = (hi[axis] - o[axis]) * inverse;
+					tMin = (std::max)(tMin, (std::min)(t1, t2));
+					tMax = (std::min)(tMax, (std::max)(t1, t2));
+				}
+				return tMin <= tMax;
+			});
+		});
+		double frustumTree = measure([&](int) { tree.QueryFrustum(planes, out); });
+		double frustumLinear = measure([&](int) { linear([&](const AABB& box) { return Culling::IsVisible(planes, box); }); });
+
+		std::printf("%8u %8.3f / %7.2f %8.3f / %7.2f %8.3f / %7.2f %8.2f / %7.2f %10.3f %10.3f\n", count,
+			aabbTree, aabbLinear, pointTree, pointLinear, rayTree, rayLinear, frustumTree, frustumLinear, buildMs, refitMs);
+	}
+	return 0;
+}
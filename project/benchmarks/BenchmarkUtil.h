@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+// ベンチマーク用の計測
+namespace Benchmark
+{
+	// functionをrepeat回実行し、最も速かった1回の時間（ミリ秒）を返す
+	template<class Function>
+	double MeasureMs(int repeat, Function&& function)
+	{
+		double best = 1e30;
+		for (int i = 0; i < repeat; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			function();
+			std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+			best = (std::min)(best, time.count());
+		}
+		return best;
+	}
+
+	// 結果を使わない計算が最適化で消されないようにする
+	template<class T>
+	void DoNotOptimize(const T& value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+}
@@ -0,0 +1,99 @@
+#include "ForceFieldSystem.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <algorithm>
+#include <vector>
+
+// 10万個のパーティクル（100個の塊）に、Fieldを1つだけ置いた場合と約50個置いた場合の1フレームの時間を比べる
+// ParticleManagerと同じく1024個ずつの区間でApplyする
+// ・1 field: 全体を覆う重力
+// ・50 local fields: 全体を覆う重力と、塊の大きさ程度の範囲を持つFieldを49個
+// ・50 global fields: 同じ49個の範囲を全体に広げたもの（絞り込みが効かない場合の比較用）
+int main()
+{
+	const size_t kCount = 100000;
+	const size_t kChunkSize = 1024;
+	const size_t kClusterCount = 100;
+	const int kLocalFieldCount = 49;
+	const float kDeltaTime = 1.0f / 60.0f;
+	const AABB kWorldBounds = { { -300.0f, -100.0f, -300.0f }, { 300.0f, 100.0f, 300.0f } };
+
+	Random random(5);
+	ParticleStorage base;
+	std::vector<Float3> clusterCenters;
+	for (size_t cluster = 0; cluster < kClusterCount; ++cluster) {
+		Float3 center = { random.Range(-200.0f, 200.0f), random.Range(0.0f, 40.0f), random.Range(-200.0f, 200.0f) };
+		clusterCenters.push_back(center);
+		size_t first = base.Append(kCount / kClusterCount);
+		for (size_t i = first; i < base.Size(); ++i) {
+			base.positionX[i] = center.x + random.Range(-3.0f, 3.0f);
+			base.positionY[i] = center.y + random.Range(-3.0f, 3.0f);
+			base.positionZ[i] = center.z + random.Range(-3.0f, 3.0f);
+			base.velocityX[i] = random.Range(-0.5f, 0.5f);
+			base.velocityY[i] = random.Range(-0.5f, 0.5f);
+			base.velocityZ[i] = random.Range(-0.5f, 0.5f);
+			base.lifeTime[i] = 10.0f;
+		}
+	}
+
+	ForceFieldSystem::Field gravity;
+	gravity.type = ForceFieldSystem::Type::Gravity;
+	gravity.bounds = kWorldBounds;
+	gravity.vector = { 0.0f, -9.8f, 0.0f };
+
+	// 塊の近くに置く、重力以外の種類のField
+	std::vector<ForceFieldSystem::Field> localFields;
+	const ForceFieldSystem::Type kLocalTypes[] = {
+		ForceFieldSystem::Type::Attractor, ForceFieldSystem::Type::Vortex, ForceFieldSystem::Type::Drag, ForceFieldSystem::Type::Turbulence,
+	};
+	for (int i = 0; i < kLocalFieldCount; ++i) {
+		ForceFieldSystem::Field field;
+		field.type = kLocalTypes[i % 4];
+		Float3 center = clusterCenters[random.NextUInt() % kClusterCount];
+		float extent = random.Range(2.0f, 6.0f);
+		field.bounds = { { center.x - extent, center.y - extent, center.z - extent }, { center.x + extent, center.y + extent, center.z + extent } };
+		field.center = center;
+		field.vector = { 0.0f, 1.0f, 0.0f };
+		field.strength = random.Range(0.5f, 2.0f);
+		field.frequency = 0.5f;
+		localFields.push_back(field);
+	}
+
+	auto measure = [&](const char* name, const std::vector<ForceFieldSystem::Field>& fields) {
+		ForceFieldSystem system;
+		for (const ForceFieldSystem::Field& field : fields) {
+			system.Add(field);
+		}
+		system.Build();
+
+		ParticleStorage particles;
+		double ms = Benchmark::MeasureMs(20, [&] {
+			particles = base;
+			for (size_t begin = 0; begin < particles.Size(); begin += kChunkSize) {
+				system.Apply(particles, begin, (std::min)(begin + kChunkSize, particles.Size()), kDeltaTime);
+			}
+			Benchmark::DoNotOptimize(particles.velocityX.data());
+		});
+		// 複製にかかる時間を除く
+		double copyMs = Benchmark::MeasureMs(20, [&] {
+			particles = base;
+			Benchmark::DoNotOptimize(particles.velocityX.data());
+		});
+		std::printf("%-18s %3zu fields  %7.3f ms\n", name, fields.size(), ms - copyMs);
+	};
+
+	std::printf("Force fields: %zu particles in %zu clusters, %zu per chunk (ms per frame, best of 20)\n", kCount, kClusterCount, kChunkSize);
+
+	measure("1 field", { gravity });
+
+	std::vector<ForceFieldSystem::Field> fields = { gravity };
+	fields.insert(fields.end(), localFields.begin(), localFields.end());
+	measure("50 local fields", fields);
+
+	for (size_t i = 1; i < fields.size(); ++i) {
+		fields[i].bounds = kWorldBounds;
+	}
+	measure("50 global fields", fields);
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include "JobSystem.h"
+#include "Culling.h"
+#include "ParticleKernel.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "Transform.h"
+#include "BenchmarkUtil.h"
+#include <cstdlib>
+#include <vector>
+
+// ParticleManager::Updateと同じく1024個ずつのチャンクに分けたパーティクルの更新を、
+// スレッド数を1から順に増やしてJobSystemで回し、1フレームの時間とスレッド1本に対する速度比を出す
+// チャンクの分け方はスレッド数によらないので、結果のハッシュは全てのスレッド数で一致する
+// 使い方: JobSystemScalingBenchmark [パーティクル数] [最大スレッド数]
+int main(int argc, char** argv)
+{
+	const size_t kCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	uint32_t maxThreads = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : std::thread::hardware_concurrency();
+	maxThreads = (std::max)(maxThreads, 1u);
+	const size_t kChunkSize = 1024;
+	const int kFrames = 20;
+	const float kDeltaTime = 1.0f / 60.0f;
+
+	Transform camera{ { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.3f, 0.0f }, { 0.0f, 0.0f, -20.0f } };
+	Matrix viewProjection = camera.MakeInverseAffineMatrix() * Matrix::PerspectiveFovLH(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	Culling::Planes planes = Culling::MakePlanes(Frustum::FromViewProjection(viewProjection));
+
+	std::printf("JobSystem scaling: %zu particles, %zu per chunk (ms per frame, best of %d frames)\n", kCount, kChunkSize, kFrames);
+	double baseMs = 0.0;
+	for (uint32_t threads = 1; threads <= maxThreads; ++threads) {
+		// スレッド数ごとに同じ初期状態から始める
+		Random random(10);
+		ParticleStorage particles;
+		particles.Append(kCount);
+		for (std::vector<float>* stream : { &particles.positionX, &particles.positionY, &particles.positionZ,
+			&particles.velocityX, &particles.velocityY, &particles.velocityZ }) {
+			random.FillUniform(stream->data(), kCount, -10.0f, 10.0f);
+		}
+		for (std::vector<float>* stream : { &particles.colorR, &particles.colorG, &particles.colorB, &particles.colorA }) {
+			random.FillUniform(stream->data(), kCount, 0.0f, 1.0f);
+		}
+		random.FillUniform(particles.lifeTime.data(), kCount, 100.0f, 200.0f);
+		std::vector<float> radius(kCount);
+		std::vector<uint8_t> visible(kCount);
+		std::vector<uint32_t> color(kCount);
+		std::vector<size_t> numVisible(JobSystem::GetChunkCount(kCount, kChunkSize));
+
+		// スレッド1本のときはワーカーを起動せず、呼び出し元だけで処理する
+		JobSystem* jobSystem = JobSystem::GetInstance();
+		if (threads > 1) {
+			jobSystem->Initialize(threads - 1);
+		}
+		double ms = Benchmark::MeasureMs(kFrames, [&] {
+			jobSystem->ParallelFor(kCount, kChunkSize, [&](size_t begin, size_t end, size_t chunkIndex) {
+				for (size_t i = begin; i < end; ++i) {
+					radius[i] = 1.5f * particles.scale[i];
+				}
+				numVisible[chunkIndex] = Culling::CullSpheres(planes,
+					particles.positionX.data() + begin, particles.positionY.data() + begin, particles.positionZ.data() + begin,
+					radius.data() + begin, end - begin, visible.data() + begin);
+				float alpha[kChunkSize];
+				ParticleKernel::ComputeAlpha(particles, begin, end, alpha);
+				ParticleKernel::PackColors(particles, begin, end, alpha, color.data() + begin);
+				ParticleKernel::Integrate(particles, begin, end, kDeltaTime);
+			});
+		});
+		jobSystem->Finalize();
+
+		// 結果がスレッド数によらないことを確かめるためのハッシュ（FNV-1a）
+		uint64_t hash = 14695981039346656037ull;
+		auto mix = [&](const void* data, size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+		mix(particles.positionX.data(), sizeof(float) * kCount);
+		mix(color.data(), sizeof(uint32_t) * kCount);
+		mix(numVisible.data(), sizeof(size_t) * numVisible.size());
+
+		if (threads == 1) {
+			baseMs = ms;
+		}
+		std::printf("%2u threads %8.3f ms  x%.2f  hash %016llx\n", threads, ms, baseMs / ms, static_cast<unsigned long long>(hash));
+	}
+	return 0;
+}
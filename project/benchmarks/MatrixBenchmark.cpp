@@ -0,0 +1,56 @@
+#include "MatrixKernels.h"
+#include "BenchmarkUtil.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Matrixの乗算・加算・逆行列を、SimdMath.hで選ばれたバックエンドとスカラー実装で比べる
+// （乗算・加算はMatrix.cppでどちらもスカラーの式にしているので、同じ速さになるのが正しい）
+int main()
+{
+	const size_t kCount = 4096;
+	const int kRepeat = 50;
+
+	// 逆行列が安定するよう、対角を大きくしたランダムな行列
+	std::mt19937 engine(1);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	std::vector<float> a(kCount * 16), b(kCount * 16), simdOut(kCount * 16), scalarOut(kCount * 16);
+	for (size_t i = 0; i < kCount * 16; ++i) {
+		bool isDiagonal = (i % 16) % 5 == 0;
+		a[i] = distribution(engine) + (isDiagonal ? 4.0f : 0.0f);
+		b[i] = distribution(engine);
+	}
+
+	std::printf("Matrix: %zu matrices, backend %s (ns per matrix, best of %d)\n", kCount, SimdMatrixBackend(), kRepeat);
+	std::printf("%-10s %10s %10s %8s %12s\n", "operation", "scalar", "simd", "speedup", "max diff");
+
+	// 両方の実装で測り、速さと結果の要素ごとの差の最大値を出す
+	auto compare = [&](const char* name, auto&& scalarFunction, auto&& simdFunction) {
+		double scalarMs = Benchmark::MeasureMs(kRepeat, [&] {
+			scalarFunction();
+			Benchmark::DoNotOptimize(scalarOut.data());
+		});
+		double simdMs = Benchmark::MeasureMs(kRepeat, [&] {
+			simdFunction();
+			Benchmark::DoNotOptimize(simdOut.data());
+		});
+		float difference = 0.0f;
+		for (size_t i = 0; i < kCount * 16; ++i) {
+			difference = (std::max)(difference, std::fabs(simdOut[i] - scalarOut[i]));
+		}
+		double scalarNs = scalarMs * 1e6 / kCount;
+		double simdNs = simdMs * 1e6 / kCount;
+		std::printf("%-10s %10.2f %10.2f %7.2fx %12.3g\n", name, scalarNs, simdNs, scalarNs / simdNs, difference);
+	};
+
+	compare("multiply",
+		[&] { ScalarMatrixMultiply(a.data(), b.data(), scalarOut.data(), kCount); },
+		[&] { SimdMatrixMultiply(a.data(), b.data(), simdOut.data(), kCount); });
+	compare("add",
+		[&] { ScalarMatrixAdd(a.data(), b.data(), scalarOut.data(), kCount); },
+		[&] { SimdMatrixAdd(a.data(), b.data(), simdOut.data(), kCount); });
+	compare("inverse",
+		[&] { ScalarMatrixInverse(a.data(), scalarOut.data(), kCount); },
+		[&] { SimdMatrixInverse(a.data(), simdOut.data(), kCount); });
+	return 0;
+}
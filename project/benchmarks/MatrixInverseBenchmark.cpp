@@ -0,0 +1,44 @@
+#include "Matrix.h"
+#include "Transform.h"
+#include "BenchmarkUtil.h"
+#include <random>
+#include <vector>
+
+// 一般の逆行列（Gauss-Jordan）と、アフィン・剛体変換用の閉じた式の逆行列を比べる
+int main()
+{
+	const size_t kCount = 4096;
+	const int kRepeat = 50;
+
+	std::mt19937 engine(2);
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> scale(0.2f, 3.0f);
+	std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+	std::vector<Matrix> affine(kCount), rigid(kCount), out(kCount);
+	for (size_t i = 0; i < kCount; ++i) {
+		Transform transform;
+		transform.scale = { scale(engine), scale(engine), scale(engine) };
+		transform.rotate = { angle(engine), angle(engine), angle(engine) };
+		transform.translate = { position(engine), position(engine), position(engine) };
+		affine[i] = transform.MakeAffineMatrix();
+		transform.scale = { 1.0f, 1.0f, 1.0f };
+		rigid[i] = transform.MakeAffineMatrix();
+	}
+
+	auto measure = [&](const char* name, auto&& inverse) {
+		double ms = Benchmark::MeasureMs(kRepeat, [&] {
+			for (size_t i = 0; i < kCount; ++i) {
+				out[i] = inverse(i);
+			}
+			Benchmark::DoNotOptimize(out.data());
+		});
+		std::printf("%-22s %8.2f ns\n", name, ms * 1e6 / kCount);
+	};
+
+	std::printf("Matrix inverse: %zu matrices (ns per matrix, best of %d)\n", kCount, kRepeat);
+	measure("Inverse (SRT)", [&](size_t i) { return Matrix::Inverse(affine[i]); });
+	measure("InverseAffine (SRT)", [&](size_t i) { return Matrix::InverseAffine(affine[i]); });
+	measure("Inverse (RT)", [&](size_t i) { return Matrix::Inverse(rigid[i]); });
+	measure("InverseRigid (RT)", [&](size_t i) { return Matrix::InverseRigid(rigid[i]); });
+	return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+
+// MatrixBenchmarkで比べるMatrixの演算
+// Matrix.cppをスカラー実装（MATH_NO_SIMD）とSIMD実装で別名のクラスとしてコンパイルし、
+// どちらも同じ翻訳単位の中でループさせて、呼び出しのコストを揃える
+// 行列はMatrixと同じ並び（float16個、行優先）で、count個ずつ処理する
+void ScalarMatrixMultiply(const float* a, const float* b, float* out, size_t count);
+void ScalarMatrixAdd(const float* a, const float* b, float* out, size_t count);
+void ScalarMatrixInverse(const float* m, float* out, size_t count);
+
+void SimdMatrixMultiply(const float* a, const float* b, float* out, size_t count);
+void SimdMatrixAdd(const float* a, const float* b, float* out, size_t count);
+void SimdMatrixInverse(const float* m, float* out, size_t count);
+
+// SIMD実装のバックエンド名
+const char* SimdMatrixBackend();
@@ -0,0 +1,40 @@
+// スカラー実装（MATH_NO_SIMD）のMatrixをScalarMatrixという名前でコンパイルする（MatrixKernels.hを参照）
+#ifndef MATH_NO_SIMD
+#define MATH_NO_SIMD
+#endif
+#define Matrix ScalarMatrix
+#define Simd ScalarSimd
+#include "Matrix.cpp"
+
+#include "MatrixKernels.h"
+
+static_assert(sizeof(ScalarMatrix) == sizeof(float) * 16, "ScalarMatrix must have the same layout as Matrix");
+
+void ScalarMatrixMultiply(const float* a, const float* b, float* out, size_t count)
+{
+	const ScalarMatrix* left = reinterpret_cast<const ScalarMatrix*>(a);
+	const ScalarMatrix* right = reinterpret_cast<const ScalarMatrix*>(b);
+	ScalarMatrix* result = reinterpret_cast<ScalarMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = left[i] * right[i];
+	}
+}
+
+void ScalarMatrixAdd(const float* a, const float* b, float* out, size_t count)
+{
+	const ScalarMatrix* left = reinterpret_cast<const ScalarMatrix*>(a);
+	const ScalarMatrix* right = reinterpret_cast<const ScalarMatrix*>(b);
+	ScalarMatrix* result = reinterpret_cast<ScalarMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = left[i] + right[i];
+	}
+}
+
+void ScalarMatrixInverse(const float* m, float* out, size_t count)
+{
+	const ScalarMatrix* source = reinterpret_cast<const ScalarMatrix*>(m);
+	ScalarMatrix* result = reinterpret_cast<ScalarMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = ScalarMatrix::Inverse(source[i]);
+	}
+}
@@ -0,0 +1,50 @@
+// SimdMath.hで選ばれたバックエンドのMatrixをSimdMatrixという名前でコンパイルする（MatrixKernels.hを参照）
+#define Matrix SimdMatrix
+#define Simd SimdSimd
+#include "Matrix.cpp"
+
+#include "MatrixKernels.h"
+
+static_assert(sizeof(SimdMatrix) == sizeof(float) * 16, "SimdMatrix must have the same layout as Matrix");
+
+void SimdMatrixMultiply(const float* a, const float* b, float* out, size_t count)
+{
+	const SimdMatrix* left = reinterpret_cast<const SimdMatrix*>(a);
+	const SimdMatrix* right = reinterpret_cast<const SimdMatrix*>(b);
+	SimdMatrix* result = reinterpret_cast<SimdMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = left[i] * right[i];
+	}
+}
+
+void SimdMatrixAdd(const float* a, const float* b, float* out, size_t count)
+{
+	const SimdMatrix* left = reinterpret_cast<const SimdMatrix*>(a);
+	const SimdMatrix* right = reinterpret_cast<const SimdMatrix*>(b);
+	SimdMatrix* result = reinterpret_cast<SimdMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = left[i] + right[i];
+	}
+}
+
+void SimdMatrixInverse(const float* m, float* out, size_t count)
+{
+	const SimdMatrix* source = reinterpret_cast<const SimdMatrix*>(m);
+	SimdMatrix* result = reinterpret_cast<SimdMatrix*>(out);
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = SimdMatrix::Inverse(source[i]);
+	}
+}
+
+const char* SimdMatrixBackend()
+{
+#if defined(MATH_SIMD_AVX)
+	return "AVX";
+#elif defined(MATH_SIMD_SSE)
+	return "SSE";
+#elif defined(MATH_SIMD_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,156 @@
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "BenchmarkUtil.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// resources/Models のモデルごとに、テキストからの読み込み（import）とMeshCacheからの読み込み（cache）の時間を比べる
+// このビルドにはassimpがないので、importはassimpの代わりにここでOBJを解析し、
+// その後はModelManager::ImportModelFileと同じく頂点の結合とMeshOptimizerの並べ替えを行う
+// キャッシュはresourcesを汚さないように、一時ディレクトリにコピーしたモデルの隣に書き出す
+// 引数でモデルのディレクトリを変えられる（既定はソースツリーの resources/Models）
+namespace {
+	// OBJの頂点・法線・UVと面を読み、ModelManagerと同じく左手系に直して三角形リストを作る
+	// （xを反転し、UVのvを反転し、巻き順を逆にする。多角形は扇形に分ける）
+	bool ImportObj(const std::string& path, ModelMesh* out)
+	{
+		std::ifstream stream(path);
+		if (!stream) {
+			return false;
+		}
+		std::vector<Float4> positions;
+		std::vector<Float3> normals;
+		std::vector<Float2> texcoords;
+		std::vector<ModelVertex> triangleList;
+		std::vector<ModelVertex> face;
+		std::string line;
+		while (std::getline(stream, line)) {
+			std::istringstream s(line);
+			std::string identifier;
+			s >> identifier;
+			if (identifier == "v") {
+				Float4 position = { 0.0f, 0.0f, 0.0f, 1.0f };
+				s >> position.x >> position.y >> position.z;
+				position.x *= -1.0f;
+				positions.push_back(position);
+			} else if (identifier == "vt") {
+				Float2 texcoord = {};
+				s >> texcoord.x >> texcoord.y;
+				texcoord.y = 1.0f - texcoord.y;
+				texcoords.push_back(texcoord);
+			} else if (identifier == "vn") {
+				Float3 normal = {};
+				s >> normal.x >> normal.y >> normal.z;
+				normal.x *= -1.0f;
+				normals.push_back(normal);
+			} else if (identifier == "f") {
+				face.clear();
+				std::string definition;
+				while (s >> definition) {
+					// 位置/UV/法線 の番号（1始まり）
+					uint32_t elementIndices[3] = {};
+					std::istringstream elements(definition);
+					std::string element;
+					for (uint32_t i = 0; i < 3 && std::getline(elements, element, '/'); ++i) {
+						elementIndices[i] = element.empty() ? 0 : static_cast<uint32_t>(std::stoul(element));
+					}
+					if (elementIndices[0] == 0 || elementIndices[0] > positions.size() ||
+						elementIndices[1] == 0 || elementIndices[1] > texcoords.size() ||
+						elementIndices[2] == 0 || elementIndices[2] > normals.size()) {
+						return false; // UVか法線がない面はModelManagerでも非対応
+					}
+					face.push_back({ positions[elementIndices[0] - 1], texcoords[elementIndices[1] - 1], normals[elementIndices[2] - 1] });
+				}
+				for (size_t i = 2; i < face.size(); ++i) {
+					triangleList.push_back(face[0]);
+					triangleList.push_back(face[i]);
+					triangleList.push_back(face[i - 1]);
+				}
+			}
+		}
+
+		// ModelManagerと同じく、頂点をまとめてインデックスにしてから並べ替える
+		ModelMesh mesh;
+		MeshOptimizer::WeldVertices(triangleList, &mesh.vertices, &mesh.indices);
+		MeshOptimizer::Optimize(mesh.vertices, mesh.indices);
+
+		mesh.bounds = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+		if (!mesh.vertices.empty()) {
+			const Float4& first = mesh.vertices.front().position;
+			mesh.bounds = { { first.x, first.y, first.z }, { first.x, first.y, first.z } };
+			for (const ModelVertex& vertex : mesh.vertices) {
+				mesh.bounds.min = { (std::min)(mesh.bounds.min.x, vertex.position.x), (std::min)(mesh.bounds.min.y, vertex.position.y), (std::min)(mesh.bounds.min.z, vertex.position.z) };
+				mesh.bounds.max = { (std::max)(mesh.bounds.max.x, vertex.position.x), (std::max)(mesh.bounds.max.y, vertex.position.y), (std::max)(mesh.bounds.max.z, vertex.position.z) };
+			}
+		}
+		mesh.rootNode.name = std::filesystem::path(path).filename().string();
+		mesh.rootNode.localMatrix = Matrix::Identity();
+		*out = std::move(mesh);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int kRepeat = 10;
+	std::filesystem::path modelDirectory = argc > 1 ? argv[1] : ENGINE_MODELS_DIRECTORY;
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "MeshCacheBenchmark";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	std::string directoryPath = directory.generic_string();
+
+	std::vector<std::filesystem::path> files;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(modelDirectory)) {
+		std::string extension = entry.path().extension().string();
+		if (extension == ".obj" || extension == ".gltf") {
+			files.push_back(entry.path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	std::printf("Model load: import vs MeshCache (ms, best of %d)\n", kRepeat);
+	std::printf("%-20s %10s %8s %8s %10s %10s %8s\n", "file", "bytes", "verts", "indices", "import", "cache", "speedup");
+	for (const std::filesystem::path& file : files) {
+		std::string filename = file.filename().string();
+		if (file.extension() != ".obj") {
+			std::printf("%-20s (skipped: only assimp reads this format)\n", filename.c_str());
+			continue;
+		}
+		std::string sourcePath = directoryPath + "/" + filename;
+		std::filesystem::copy_file(file, sourcePath, std::filesystem::copy_options::overwrite_existing);
+
+		ModelMesh imported;
+		bool isImported = true;
+		double importMs = Benchmark::MeasureMs(kRepeat, [&] {
+			isImported = ImportObj(sourcePath, &imported) && isImported;
+			Benchmark::DoNotOptimize(imported.vertices.data());
+		});
+		if (!isImported) {
+			std::printf("%-20s (skipped: faces without texcoords or normals)\n", filename.c_str());
+			continue;
+		}
+
+		MeshCache::Save(directoryPath, sourcePath, imported);
+		ModelMesh cached;
+		bool isCached = true;
+		double cacheMs = Benchmark::MeasureMs(kRepeat, [&] {
+			isCached = MeshCache::Load(directoryPath, sourcePath, &cached) && isCached;
+			Benchmark::DoNotOptimize(cached.vertices.data());
+		});
+		bool isSame = isCached && cached.indices == imported.indices && cached.vertices.size() == imported.vertices.size() &&
+			std::memcmp(cached.vertices.data(), imported.vertices.data(), sizeof(ModelVertex) * imported.vertices.size()) == 0;
+
+		std::printf("%-20s %10llu %8zu %8zu %10.3f %10.3f %7.1fx%s\n", filename.c_str(),
+			static_cast<unsigned long long>(std::filesystem::file_size(file)), imported.vertices.size(), imported.indices.size(),
+			importMs, cacheMs, importMs / cacheMs, isSame ? "" : "  MISMATCH");
+	}
+
+	std::filesystem::remove_all(directory);
+	return 0;
+}
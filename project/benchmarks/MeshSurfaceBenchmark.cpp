@@ -0,0 +1,92 @@
+#include "MeshSurfaceSampler.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+// UV球（緯度によって三角形の面積が大きく違う）の表面から100万個の点を選ぶ時間を、
+// MeshSurfaceSamplerのエイリアス表と、面積の累積和の二分探索・線形探索で比べる
+// 累積和の2つは三角形を選ぶだけで、位置は求めない
+int main()
+{
+	const int kLatitude = 100;
+	const int kLongitude = 100;
+	const size_t kCount = 1000000;
+	const float kPi = 3.14159265f;
+
+	// 極の三角形は面積が0になり、Buildで除かれる
+	std::vector<ModelVertex> vertices;
+	for (int i = 0; i <= kLatitude; ++i) {
+		for (int j = 0; j <= kLongitude; ++j) {
+			float theta = kPi * i / kLatitude;
+			float phi = 2.0f * kPi * j / kLongitude;
+			ModelVertex vertex = {};
+			vertex.position = { sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi), 1.0f };
+			vertices.push_back(vertex);
+		}
+	}
+	std::vector<uint32_t> indices;
+	for (int i = 0; i < kLatitude; ++i) {
+		for (int j = 0; j < kLongitude; ++j) {
+			uint32_t a = i * (kLongitude + 1) + j;
+			uint32_t b = a + kLongitude + 1;
+			indices.insert(indices.end(), { a, b, b + 1, a, b + 1, a + 1 });
+		}
+	}
+
+	MeshSurfaceSampler sampler;
+	double buildMs = Benchmark::MeasureMs(10, [&] { sampler.Build(vertices.data(), indices.data(), indices.size()); });
+	std::printf("Mesh surface sampling: UV sphere, %zu triangles with area (area %.4f, 4pi = %.4f)\n",
+		sampler.GetTriangleCount(), sampler.GetTotalArea(), 4.0f * kPi);
+	std::printf("%-34s %10.3f ms\n", "build alias table", buildMs);
+
+	Random random(19);
+	std::vector<float> x(kCount), y(kCount), z(kCount), normalX(kCount), normalY(kCount), normalZ(kCount);
+	double aliasMs = Benchmark::MeasureMs(10, [&] {
+		sampler.Sample(random, kCount, x.data(), y.data(), z.data(), normalX.data(), normalY.data(), normalZ.data());
+		Benchmark::DoNotOptimize(x.data());
+	});
+	// 球の表面から一様に選べていれば、y > 0.5の割合は (1 - 0.5) / 2 = 25%
+	size_t numCap = std::count_if(y.begin(), y.end(), [](float value) { return value > 0.5f; });
+	std::printf("%-34s %10.3f ms  (%.2f ns per point, y > 0.5: %.2f%%, expected 25%%)\n", "alias table (position + normal)",
+		aliasMs, aliasMs * 1e6 / kCount, 100.0 * numCap / kCount);
+
+	// 比較用: 三角形ごとの面積の累積和
+	std::vector<float> cumulativeArea;
+	float totalArea = 0.0f;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const Float4& p0 = vertices[indices[i]].position;
+		const Float4& p1 = vertices[indices[i + 1]].position;
+		const Float4& p2 = vertices[indices[i + 2]].position;
+		Float3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		Float3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		Float3 cross = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+		totalArea += 0.5f * sqrtf(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+		cumulativeArea.push_back(totalArea);
+	}
+	std::vector<float> targets(kCount);
+	random.FillUniform(targets.data(), kCount, 0.0f, totalArea);
+	std::vector<uint32_t> selected(kCount);
+	double binaryMs = Benchmark::MeasureMs(3, [&] {
+		for (size_t i = 0; i < kCount; ++i) {
+			selected[i] = static_cast<uint32_t>(std::upper_bound(cumulativeArea.begin(), cumulativeArea.end(), targets[i]) - cumulativeArea.begin());
+		}
+		Benchmark::DoNotOptimize(selected.data());
+	});
+	std::printf("%-34s %10.3f ms\n", "binary search (triangle only)", binaryMs);
+	// 線形探索は遅いので2万個だけ測り、100万個分に換算する
+	const size_t kLinearCount = 20000;
+	double linearMs = Benchmark::MeasureMs(1, [&] {
+		for (size_t i = 0; i < kLinearCount; ++i) {
+			uint32_t triangle = 0;
+			while (triangle + 1 < cumulativeArea.size() && cumulativeArea[triangle] < targets[i]) {
+				++triangle;
+			}
+			selected[i] = triangle;
+		}
+		Benchmark::DoNotOptimize(selected.data());
+	});
+	std::printf("%-34s %10.3f ms  (from %zu points)\n", "linear scan (triangle only)", linearMs * kCount / kLinearCount, kLinearCount);
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include "ParticleCollisionSystem.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <algorithm>
+#include <vector>
+
+// 10万個のパーティクル（100個の塊）に、地面の平面と球・箱のコライダーを当てる
+// ParticleManagerと同じく1024個ずつの区間でApplyし、コライダーの数を増やしたときの1フレームの時間を比べる
+// （候補の絞り込みが効いていれば、コライダーが増えても時間はほとんど増えない）
+int main()
+{
+	const size_t kCount = 100000;
+	const size_t kChunkSize = 1024;
+	const size_t kClusterCount = 100;
+	const int kColliderCounts[] = { 1, 10, 100, 1000 };
+
+	Random random(3);
+	ParticleStorage base;
+	for (size_t cluster = 0; cluster < kClusterCount; ++cluster) {
+		Float3 center = { random.Range(-200.0f, 200.0f), random.Range(0.0f, 40.0f), random.Range(-200.0f, 200.0f) };
+		size_t first = base.Append(kCount / kClusterCount);
+		for (size_t i = first; i < base.Size(); ++i) {
+			base.positionX[i] = center.x + random.Range(-3.0f, 3.0f);
+			base.positionY[i] = center.y + random.Range(-3.0f, 3.0f);
+			base.positionZ[i] = center.z + random.Range(-3.0f, 3.0f);
+			base.velocityX[i] = random.Range(-0.5f, 0.5f);
+			base.velocityY[i] = random.Range(-0.5f, 0.5f);
+			base.velocityZ[i] = random.Range(-0.5f, 0.5f);
+			base.lifeTime[i] = 10.0f;
+		}
+	}
+
+	std::printf("Particle collision: %zu particles in %zu clusters, %zu per chunk (ms per frame, best of 20)\n", kCount, kClusterCount, kChunkSize);
+	for (int numColliders : kColliderCounts) {
+		ParticleCollisionSystem system;
+		ParticleCollisionSystem::Collider ground;
+		ground.shape = ParticleCollisionSystem::Shape::Plane;
+		ground.distance = -5.0f;
+		system.Add(ground);
+		for (int i = 1; i < numColliders; ++i) {
+			ParticleCollisionSystem::Collider collider;
+			Float3 center = { random.Range(-200.0f, 200.0f), random.Range(0.0f, 40.0f), random.Range(-200.0f, 200.0f) };
+			float extent = random.Range(1.0f, 3.0f);
+			if (i % 2) {
+				collider.shape = ParticleCollisionSystem::Shape::Sphere;
+				collider.center = center;
+				collider.radius = extent;
+			} else {
+				collider.shape = ParticleCollisionSystem::Shape::Box;
+				collider.bounds = { { center.x - extent, center.y - extent, center.z - extent }, { center.x + extent, center.y + extent, center.z + extent } };
+			}
+			system.Add(collider);
+		}
+		double buildMs = Benchmark::MeasureMs(1, [&] { system.Build(); });
+
+		ParticleStorage particles;
+		double ms = Benchmark::MeasureMs(20, [&] {
+			particles = base;
+			for (size_t begin = 0; begin < particles.Size(); begin += kChunkSize) {
+				system.Apply(particles, begin, (std::min)(begin + kChunkSize, particles.Size()));
+			}
+			Benchmark::DoNotOptimize(particles.positionX.data());
+		});
+		// 複製にかかる時間を除く
+		double copyMs = Benchmark::MeasureMs(20, [&] {
+			particles = base;
+			Benchmark::DoNotOptimize(particles.positionX.data());
+		});
+		std::printf("%5d colliders  %7.3f ms  (build %.3f ms)\n", numColliders, ms - copyMs, buildMs);
+	}
+	return 0;
+}
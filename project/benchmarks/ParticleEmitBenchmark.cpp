@@ -0,0 +1,78 @@
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <random>
+
+// 100万個のパーティクルの発生（1個につき速度・位置・色・生存時間の10個の乱数）を比べる
+// ・mt19937: 以前のEmitと同じく、1個ずつuniform_real_distributionで値を作って書き込む
+// ・NextFloat: Randomから1個ずつ取り出す
+// ・FillUniform: ParticleManager::Emitと同じく、Appendした範囲を成分ごとにまとめて埋める
+int main()
+{
+	const size_t kCount = 1000000;
+	const int kRepeat = 10;
+
+	ParticleStorage particles;
+	particles.Reserve(kCount);
+
+	auto measure = [&](const char* name, auto&& emit) {
+		double ms = Benchmark::MeasureMs(kRepeat, [&] {
+			particles.Clear();
+			size_t first = particles.Append(kCount);
+			emit(first);
+			Benchmark::DoNotOptimize(particles.lifeTime.data());
+		});
+		std::printf("%-12s %8.2f ms  %6.2f ns per particle\n", name, ms, ms * 1e6 / kCount);
+	};
+
+	std::printf("Particle emission: %zu particles, 10 random floats each (best of %d)\n", kCount, kRepeat);
+
+	std::mt19937 engine(1);
+	measure("mt19937", [&](size_t first) {
+		for (size_t i = first; i < first + kCount; ++i) {
+			std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> distColor(0.0f, 1.0f);
+			std::uniform_real_distribution<float> distTime(1.0f, 3.0f);
+			particles.velocityX[i] = distribution(engine);
+			particles.velocityY[i] = distribution(engine);
+			particles.velocityZ[i] = distribution(engine);
+			particles.positionX[i] = distribution(engine);
+			particles.positionY[i] = distribution(engine);
+			particles.positionZ[i] = distribution(engine);
+			particles.colorR[i] = distColor(engine);
+			particles.colorG[i] = distColor(engine);
+			particles.colorB[i] = distColor(engine);
+			particles.lifeTime[i] = distTime(engine);
+		}
+	});
+
+	Random random(1);
+	measure("NextFloat", [&](size_t first) {
+		for (size_t i = first; i < first + kCount; ++i) {
+			particles.velocityX[i] = random.Range(-1.0f, 1.0f);
+			particles.velocityY[i] = random.Range(-1.0f, 1.0f);
+			particles.velocityZ[i] = random.Range(-1.0f, 1.0f);
+			particles.positionX[i] = random.Range(-1.0f, 1.0f);
+			particles.positionY[i] = random.Range(-1.0f, 1.0f);
+			particles.positionZ[i] = random.Range(-1.0f, 1.0f);
+			particles.colorR[i] = random.NextFloat();
+			particles.colorG[i] = random.NextFloat();
+			particles.colorB[i] = random.NextFloat();
+			particles.lifeTime[i] = random.Range(1.0f, 3.0f);
+		}
+	});
+
+	measure("FillUniform", [&](size_t first) {
+		random.FillUniform(particles.velocityX.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.velocityY.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.velocityZ.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.positionX.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.positionY.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.positionZ.data() + first, kCount, -1.0f, 1.0f);
+		random.FillUniform(particles.colorR.data() + first, kCount, 0.0f, 1.0f);
+		random.FillUniform(particles.colorG.data() + first, kCount, 0.0f, 1.0f);
+		random.FillUniform(particles.colorB.data() + first, kCount, 0.0f, 1.0f);
+		random.FillUniform(particles.lifeTime.data() + first, kCount, 1.0f, 3.0f);
+	});
+	return 0;
+}
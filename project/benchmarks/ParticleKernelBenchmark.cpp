@@ -0,0 +1,54 @@
+#include "ParticleKernel.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <vector>
+
+// ParticleKernelのSIMD版とReference版の処理速度（1nsあたりに処理できるパーティクル数）を比べる
+// ・1024個: ParticleManagerの1チャンク分（キャッシュに載る大きさ）
+// ・100万個: メモリの帯域で決まる大きさ
+// Reference版はコンパイラの自動ベクトル化を受けることがあるので、その場合は差が小さくなる
+int main()
+{
+	const size_t kSizes[] = { 1024, 1000000 };
+	const size_t kTotal = 100000000; // 大きさによらず、合計でこの数だけ処理する
+
+	for (size_t count : kSizes) {
+		Random random(11);
+		ParticleStorage particles;
+		particles.Append(count);
+		for (std::vector<float>* stream : { &particles.positionX, &particles.positionY, &particles.positionZ,
+			&particles.velocityX, &particles.velocityY, &particles.velocityZ,
+			&particles.colorR, &particles.colorG, &particles.colorB, &particles.colorA }) {
+			random.FillUniform(stream->data(), count, 0.0f, 1.0f);
+		}
+		random.FillUniform(particles.lifeTime.data(), count, 1.0f, 3.0f);
+		std::vector<float> alpha(count);
+		std::vector<uint32_t> color(count);
+		size_t numLoops = (std::max)(kTotal / count, size_t(1));
+
+		auto measure = [&](const char* name, auto&& kernel) {
+			double ms = Benchmark::MeasureMs(5, [&] {
+				for (size_t loop = 0; loop < numLoops; ++loop) {
+					kernel();
+					Benchmark::DoNotOptimize(particles.positionX.data());
+					Benchmark::DoNotOptimize(alpha.data());
+					Benchmark::DoNotOptimize(color.data());
+				}
+			});
+			double ns = ms * 1e6;
+			std::printf("  %-22s %6.2f particles/ns  (%5.3f ns per particle)\n", name, count * numLoops / ns, ns / (count * numLoops));
+		};
+
+		// 経過時間が生存時間を超えないよう、deltaTimeはごく小さくする
+		const float kDeltaTime = 1e-9f;
+		std::printf("%zu particles\n", count);
+		measure("Integrate", [&] { ParticleKernel::Integrate(particles, 0, count, kDeltaTime); });
+		measure("IntegrateReference", [&] { ParticleKernel::IntegrateReference(particles, 0, count, kDeltaTime); });
+		measure("ComputeAlpha", [&] { ParticleKernel::ComputeAlpha(particles, 0, count, alpha.data()); });
+		measure("ComputeAlphaReference", [&] { ParticleKernel::ComputeAlphaReference(particles, 0, count, alpha.data()); });
+		measure("PackColors", [&] { ParticleKernel::PackColors(particles, 0, count, alpha.data(), color.data()); });
+		measure("PackColorsReference", [&] { ParticleKernel::PackColorsReference(particles, 0, count, alpha.data(), color.data()); });
+	}
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include "Culling.h"
+#include "ParticleKernel.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "Transform.h"
+#include "BenchmarkUtil.h"
+#include <list>
+#include <vector>
+
+namespace {
+	// ParticleStorageにする前の、1つずつ確保していたパーティクル
+	struct ListParticle {
+		Transform transform;
+		Float3 velocity;
+		Float4 color;
+		float lifeTime;
+		float currentTime;
+	};
+
+	// Object3D::ParticleForGPUと同じ配置（32バイト）
+	struct Instance {
+		Float3 position;
+		float scale;
+		float rotation;
+		uint32_t color;
+		float padding[2];
+	};
+
+	constexpr float kDeltaTime = 1.0f / 60.0f;
+	constexpr float kModelRadius = 1.5f;
+	constexpr size_t kChunkSize = 1024;
+}
+
+// 1フレーム分の更新（寿命の判定と削除・球でのカリング・見えているもののインスタンスの書き込み・移動）と発生を、
+// std::list<ListParticle>とParticleStorageで比べる（どちらもスレッド1本、同じ乱数の同じパーティクル）
+int main()
+{
+	const size_t kSizes[] = { 10000, 100000, 1000000 };
+	const int kFrames = 10;
+
+	Transform camera{ { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.3f, 0.0f }, { 0.0f, 0.0f, -20.0f } };
+	Matrix viewProjection = camera.MakeInverseAffineMatrix() * Matrix::PerspectiveFovLH(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	Culling::Planes planes = Culling::MakePlanes(Frustum::FromViewProjection(viewProjection));
+
+	std::printf("Particle update / emit, std::list vs ParticleStorage (ns per particle, best of %d)\n", kFrames);
+	std::printf("%9s %12s %12s %12s %12s\n", "particles", "update list", "update SoA", "emit list", "emit SoA");
+	for (size_t count : kSizes) {
+		// 発生: 同じ乱数で位置・速度・色・寿命を決めて追加する
+		// （寿命は計測するフレームより長くし、どのフレームも同じ数を処理する）
+		std::list<ListParticle> list;
+		double emitListMs = Benchmark::MeasureMs(3, [&] {
+			list.clear();
+			Random random(9);
+			for (size_t i = 0; i < count; ++i) {
+				ListParticle particle;
+				particle.transform.scale = { 1.0f, 1.0f, 1.0f };
+				particle.transform.rotate = { 0.0f, 0.0f, 0.0f };
+				particle.transform.translate = { random.Range(-10.0f, 10.0f), random.Range(-10.0f, 10.0f), random.Range(-10.0f, 10.0f) };
+				particle.velocity = { random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) };
+				particle.color = { random.NextFloat(), random.NextFloat(), random.NextFloat(), 1.0f };
+				particle.lifeTime = random.Range(100.0f, 200.0f);
+				particle.currentTime = 0.0f;
+				list.push_back(particle);
+			}
+		});
+		ParticleStorage storage;
+		double emitStorageMs = Benchmark::MeasureMs(3, [&] {
+			storage.Clear();
+			Random random(9);
+			size_t first = storage.Append(count);
+			for (size_t i = first; i < storage.Size(); ++i) {
+				storage.positionX[i] = random.Range(-10.0f, 10.0f);
+				storage.positionY[i] = random.Range(-10.0f, 10.0f);
+				storage.positionZ[i] = random.Range(-10.0f, 10.0f);
+				storage.velocityX[i] = random.Range(-1.0f, 1.0f);
+				storage.velocityY[i] = random.Range(-1.0f, 1.0f);
+				storage.velocityZ[i] = random.Range(-1.0f, 1.0f);
+				storage.colorR[i] = random.NextFloat();
+				storage.colorG[i] = random.NextFloat();
+				storage.colorB[i] = random.NextFloat();
+				storage.colorA[i] = 1.0f;
+				storage.lifeTime[i] = random.Range(100.0f, 200.0f);
+			}
+		});
+
+		std::vector<Instance> instances(count);
+		size_t numListVisible = 0;
+		double updateListMs = Benchmark::MeasureMs(kFrames, [&] {
+			uint32_t numInstance = 0;
+			for (auto it = list.begin(); it != list.end();) {
+				if (it->lifeTime <= it->currentTime) {
+					it = list.erase(it);
+					continue;
+				}
+				if (Culling::IsVisible(planes, it->transform.translate, kModelRadius * it->transform.scale.x)) {
+					Instance& instance = instances[numInstance++];
+					instance.position = it->transform.translate;
+					instance.scale = it->transform.scale.x;
+					instance.rotation = it->transform.rotate.z;
+					instance.color = ParticleKernel::PackColor(it->color.x, it->color.y, it->color.z,
+						it->color.w * (1.0f - it->currentTime / it->lifeTime));
+				}
+				it->transform.translate += it->velocity * kDeltaTime;
+				it->currentTime += kDeltaTime;
+				++it;
+			}
+			numListVisible = numInstance;
+			Benchmark::DoNotOptimize(instances.data());
+		});
+
+		// ParticleManagerと同じく、1024個ずつの区間でカリング・書き込み・移動を行う
+		std::vector<float> radius(count);
+		std::vector<uint8_t> visible(count);
+		size_t numStorageVisible = 0;
+		double updateStorageMs = Benchmark::MeasureMs(kFrames, [&] {
+			storage.RemoveDead();
+			uint32_t numInstance = 0;
+			for (size_t begin = 0; begin < storage.Size(); begin += kChunkSize) {
+				size_t end = (std::min)(begin + kChunkSize, storage.Size());
+				for (size_t i = begin; i < end; ++i) {
+					radius[i] = kModelRadius * storage.scale[i];
+				}
+				Culling::CullSpheres(planes, storage.positionX.data() + begin, storage.positionY.data() + begin, storage.positionZ.data() + begin,
+					radius.data() + begin, end - begin, visible.data() + begin);
+				float alpha[kChunkSize];
+				uint32_t color[kChunkSize];
+				ParticleKernel::ComputeAlpha(storage, begin, end, alpha);
+				ParticleKernel::PackColors(storage, begin, end, alpha, color);
+				for (size_t i = begin; i < end; ++i) {
+					if (!visible[i]) {
+						continue;
+					}
+					Instance& instance = instances[numInstance++];
+					instance.position = { storage.positionX[i], storage.positionY[i], storage.positionZ[i] };
+					instance.scale = storage.scale[i];
+					instance.rotation = storage.rotation[i];
+					instance.color = color[i - begin];
+				}
+				ParticleKernel::Integrate(storage, begin, end, kDeltaTime);
+			}
+			numStorageVisible = numInstance;
+			Benchmark::DoNotOptimize(instances.data());
+		});
+
+		double toNs = 1e6 / static_cast<double>(count);
+		std::printf("%9zu %12.2f %12.2f %12.2f %12.2f   (visible %zu / %zu)\n", count,
+			updateListMs * toNs, updateStorageMs * toNs, emitListMs * toNs, emitStorageMs * toNs, numListVisible, numStorageVisible);
+	}
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "RadixSort.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// ParticleManager::SortInstancesと同じく、ビュー空間の深度を奥から手前の順に並べる時間を
+// RadixSort::Sort・RadixSort::SortParallel・std::stable_sortで比べる
+// 並べ替える前の状態に戻す複製の時間は除く
+int main()
+{
+	const size_t kSizes[] = { 10000, 100000, 1000000 };
+
+	JobSystem::GetInstance()->Initialize();
+	std::printf("Depth sort (ms per sort, %u threads for SortParallel)\n", JobSystem::GetInstance()->GetThreadCount());
+	std::printf("%9s %10s %10s %12s %14s\n", "count", "Sort", "Parallel", "stable_sort", "Sort / 100k");
+	for (size_t count : kSizes) {
+		Random random(16);
+		std::vector<float> depth(count);
+		random.FillUniform(depth.data(), count, -50.0f, 200.0f);
+		std::vector<uint32_t> baseKeys(count);
+		std::vector<uint32_t> baseValues(count);
+		for (size_t i = 0; i < count; ++i) {
+			baseKeys[i] = RadixSort::InvertKey(RadixSort::FloatToKey(depth[i]));
+		}
+		std::iota(baseValues.begin(), baseValues.end(), 0u);
+
+		std::vector<uint32_t> keys(count), values(count), tempKeys(count), tempValues(count);
+		const int kRepeat = count >= 1000000 ? 20 : 200;
+		auto measure = [&](auto&& sort) {
+			double copyMs = Benchmark::MeasureMs(kRepeat, [&] {
+				keys = baseKeys;
+				values = baseValues;
+				Benchmark::DoNotOptimize(values.data());
+			});
+			// 最後に並べた結果がvaluesに残る
+			double ms = Benchmark::MeasureMs(kRepeat, [&] {
+				keys = baseKeys;
+				values = baseValues;
+				sort();
+				Benchmark::DoNotOptimize(values.data());
+			});
+			return ms - copyMs;
+		};
+
+		double serialMs = measure([&] { RadixSort::Sort(keys.data(), values.data(), count, tempKeys.data(), tempValues.data()); });
+		std::vector<uint32_t> sorted = values;
+		double parallelMs = measure([&] { RadixSort::SortParallel(keys.data(), values.data(), count, tempKeys.data(), tempValues.data()); });
+		bool isMatched = values == sorted;
+		double stableMs = measure([&] {
+			std::stable_sort(values.begin(), values.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+		});
+		isMatched &= values == sorted;
+		// 奥（深度が大きい方）から順に並んでいるか
+		bool isBackToFront = true;
+		for (size_t i = 1; i < count; ++i) {
+			isBackToFront &= depth[sorted[i - 1]] >= depth[sorted[i]];
+		}
+
+		std::printf("%9zu %10.3f %10.3f %12.3f %14.3f   %s\n", count, serialMs, parallelMs, stableMs, serialMs * 1e5 / count,
+			isMatched && isBackToFront ? "ok" : "MISMATCH");
+	}
+	JobSystem::GetInstance()->Finalize();
+	return 0;
+}
@@ -0,0 +1,46 @@
+#include "TransformBatch.h"
+#include "Transform.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <vector>
+
+// ワールド行列の生成を、1つずつのMatrix::Affine（AoS）とTransformBatch（SoA・4要素ずつSIMD）で比べる
+// 数を変えて、キャッシュに収まる場合と収まらない場合のスループットを見る
+int main()
+{
+	const size_t kCounts[] = { 1000, 100000, 1000000 };
+
+	std::printf("World matrices (ns per transform, best of N)\n");
+	for (size_t count : kCounts) {
+		// 1回の計測が短すぎないように、数が少ないほど繰り返す
+		const int kRepeat = count <= 1000 ? 2000 : count <= 100000 ? 20 : 5;
+
+		Random random(11);
+		std::vector<Transform> transforms(count);
+		TransformBatch batch;
+		batch.Reserve(count);
+		for (Transform& transform : transforms) {
+			transform.scale = { random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f) };
+			transform.rotate = { random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f) };
+			transform.translate = { random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f) };
+			batch.Add(transform);
+		}
+		std::vector<Matrix> out(count);
+
+		double affineMs = Benchmark::MeasureMs(kRepeat, [&] {
+			for (size_t i = 0; i < count; ++i) {
+				const Transform& transform = transforms[i];
+				out[i] = Matrix::Affine(transform.scale, transform.rotate, transform.translate);
+			}
+			Benchmark::DoNotOptimize(out.data());
+		});
+		double batchMs = Benchmark::MeasureMs(kRepeat, [&] {
+			batch.MakeAffineMatrices(out.data());
+			Benchmark::DoNotOptimize(out.data());
+		});
+
+		std::printf("%8zu transforms (x%4d)  Matrix::Affine %6.2f ns  TransformBatch %6.2f ns  (%.2fx)\n",
+			count, kRepeat, affineMs * 1e6 / count, batchMs * 1e6 / count, affineMs / batchMs);
+	}
+	return 0;
+}
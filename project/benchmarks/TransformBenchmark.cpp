@@ -0,0 +1,44 @@
+#include "Transform.h"
+#include "Random.h"
+#include "BenchmarkUtil.h"
+#include <vector>
+
+// アフィン行列の生成を、Euler角の行列の積・Euler角の閉じた式・クォータニオンで比べる
+// （クォータニオン側は回転を変換済みのQuaternionTransformから作る）
+int main()
+{
+	const size_t kCount = 65536;
+	const int kRepeat = 20;
+
+	Random random(4);
+	std::vector<Transform> transforms(kCount);
+	std::vector<QuaternionTransform> quaternionTransforms(kCount);
+	for (size_t i = 0; i < kCount; ++i) {
+		transforms[i].scale = { random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f) };
+		transforms[i].rotate = { random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f) };
+		transforms[i].translate = { random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f) };
+		quaternionTransforms[i] = QuaternionTransform::FromTransform(transforms[i]);
+	}
+	std::vector<Matrix> out(kCount);
+
+	auto measure = [&](const char* name, auto&& makeMatrix) {
+		double ms = Benchmark::MeasureMs(kRepeat, [&] {
+			for (size_t i = 0; i < kCount; ++i) {
+				out[i] = makeMatrix(i);
+			}
+			Benchmark::DoNotOptimize(out.data());
+		});
+		std::printf("%-40s %8.2f ns\n", name, ms * 1e6 / kCount);
+	};
+
+	std::printf("Affine matrix: %zu transforms (ns per transform, best of %d)\n", kCount, kRepeat);
+	measure("Scaling * RollPitchYaw * Translation", [&](size_t i) {
+		const Transform& transform = transforms[i];
+		return Matrix::Scaling(transform.scale) *
+			Matrix::RotationRollPitchYaw(transform.rotate.z, transform.rotate.x, transform.rotate.y) *
+			Matrix::Translation(transform.translate);
+	});
+	measure("Transform::MakeAffineMatrix", [&](size_t i) { return transforms[i].MakeAffineMatrix(); });
+	measure("QuaternionTransform::MakeAffineMatrix", [&](size_t i) { return quaternionTransforms[i].MakeAffineMatrix(); });
+	return 0;
+}
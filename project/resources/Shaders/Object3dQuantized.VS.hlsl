@@ -0,0 +1,32 @@
+#include "Object3d.hlsli"
+
+// ModelManager::QuantizedVertexData の頂点を読む Object3d.VS
+struct TransformationMatrix {
+    float32_t4x4 WVP; // 0～1の位置をモデルの座標に戻す行列を含む
+    float32_t4x4 World;
+};
+
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+struct VertexShaderInput {
+    float32_t4 position : POSITION0; // R16G16B16A16_UNORM（モデルの範囲を0～1としたもの、wは使わない）
+    float32_t2 texcoord : TEXCOORD0; // R16G16_FLOAT
+    float32_t2 normal : NORMAL0; // R16G16_SNORM（八面体に写した法線）
+};
+
+// 八面体に写した法線を戻す
+float32_t3 DecodeOctahedral(float32_t2 encoded) {
+    float32_t3 normal = float32_t3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float32_t fold = saturate(-normal.z);
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+    return normalize(normal);
+}
+
+VertexShaderOutput main(VertexShaderInput input) {
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(input.position.xyz, 1.0f), gTransformationMatrix.WVP);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(DecodeOctahedral(input.normal), (float32_t3x3) gTransformationMatrix.World));
+    return output;
+}
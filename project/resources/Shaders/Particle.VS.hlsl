@@ -8,13 +8,24 @@
 
 struct ParticleForGPU
 {
-    float32_t4x4 WVP;
-    float32_t4x4 World;
-    float32_t4 color;
+    float32_t3 position;
+    float32_t scale; // 一様スケール
+    float32_t rotation; // ビルボードの面内（Z軸）の回転
+    uint32_t color; // RGBA8（下位からR, G, B, A）
+    float32_t2 padding;
 };
 
 StructuredBuffer<ParticleForGPU> gParticle : register(t0);
 
+// 全パーティクルで共通の行列
+struct ParticleView
+{
+    float32_t4x4 billboard; // 平行移動を含まないビルボード行列
+    float32_t4x4 viewProjection;
+};
+
+ConstantBuffer<ParticleView> gParticleView : register(b0);
+
 struct VertexShaderInput
 {
     float32_t4 position : POSITION0;
@@ -22,11 +33,30 @@ struct VertexShaderInput
     float32_t3 normal : NORMAL0;
 };
 
+// RGBA8を0～1の色に戻す
+float32_t4 UnpackColor(uint32_t color)
+{
+    return float32_t4(
+        color & 0xff,
+        (color >> 8) & 0xff,
+        (color >> 16) & 0xff,
+        (color >> 24) & 0xff) / 255.0f;
+}
+
 VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
 {
     VertexShaderOutput output;
-    output.position = mul(input.position, gParticle[instanceId].WVP);
+    ParticleForGPU particle = gParticle[instanceId];
+
+    // スケール → Z軸回転 → ビルボード → 平行移動 の順にかける
+    float32_t3 local = input.position.xyz * particle.scale;
+    float32_t s, c;
+    sincos(particle.rotation, s, c);
+    float32_t3 rotated = float32_t3(local.x * c - local.y * s, local.x * s + local.y * c, local.z);
+    float32_t3 world = mul(rotated, (float32_t3x3) gParticleView.billboard) + particle.position;
+
+    output.position = mul(float32_t4(world, 1.0f), gParticleView.viewProjection);
     output.texcoord = input.texcoord;
-    output.color = gParticle[instanceId].color;
+    output.color = UnpackColor(particle.color);
     return output;
-}
\ No newline at end of file
+}
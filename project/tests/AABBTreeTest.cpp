@@ -0,0 +1,166 @@
+#include "AABBTree.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+	// 全ての要素を1つずつ判定した結果（小さい順）
+	template <class Test>
+	std::vector<uint32_t> LinearQuery(const std::vector<AABB>& boxes, const std::vector<uint8_t>& alive, Test test)
+	{
+		std::vector<uint32_t> result;
+		for (uint32_t index = 0; index < boxes.size(); ++index) {
+			if (alive[index] && test(boxes[index])) {
+				result.push_back(index);
+			}
+		}
+		return result;
+	}
+
+	std::vector<uint32_t> Sorted(std::vector<uint32_t> values)
+	{
+		std::sort(values.begin(), values.end());
+		return values;
+	}
+
+	AABB MakeBox(Random& random, float range, float maxExtent)
+	{
+		Float3 center = { random.Range(-range, range), random.Range(-range, range), random.Range(-range, range) };
+		Float3 extent = { random.Range(0.1f, maxExtent), random.Range(0.1f, maxExtent), random.Range(0.1f, maxExtent) };
+		return AABB{ center - extent, center + extent };
+	}
+}
+
+// 点・AABBのクエリが線形探索と同じ集合を返すことを、移動・削除・無限大を含む要素とあわせて確かめる
+int main()
+{
+	constexpr uint32_t kCount = 2000;
+	constexpr int kQueryCount = 300;
+	Random random(8);
+
+	std::vector<AABB> boxes(kCount);
+	std::vector<uint8_t> alive(kCount, 1);
+	std::vector<int32_t> proxies(kCount);
+	AABBTree tree;
+	for (uint32_t index = 0; index < kCount; ++index) {
+		boxes[index] = MakeBox(random, 100.0f, 5.0f);
+		// 一部は無限大を含む範囲にする（全方向と、片側だけのもの）
+		if (index % 97 == 0) {
+			boxes[index] = AABB{ { -kInfinity, -kInfinity, -kInfinity }, { kInfinity, kInfinity, kInfinity } };
+		} else if (index % 89 == 0) {
+			boxes[index].min.y = -kInfinity;
+		}
+		proxies[index] = tree.Insert(boxes[index], index);
+	}
+	tree.Build();
+	TEST_CHECK(tree.GetItemCount() == kCount);
+
+	auto checkQueries = [&]() {
+		bool isMatched = true;
+		for (int query = 0; query < kQueryCount; ++query) {
+			Float3 point = { random.Range(-100.0f, 100.0f), random.Range(-100.0f, 100.0f), random.Range(-100.0f, 100.0f) };
+			std::vector<uint32_t> out;
+			tree.QueryPoint(point, out);
+			isMatched &= Sorted(out) == LinearQuery(boxes, alive, [&](const AABB& aabb) { return IsCollision(aabb, point); });
+
+			AABB bounds = MakeBox(random, 100.0f, 15.0f);
+			out.clear();
+			tree.QueryAABB(bounds, out);
+			isMatched &= Sorted(out) == LinearQuery(boxes, alive, [&](const AABB& aabb) { return IsCollision(aabb, bounds); });
+		}
+		return isMatched;
+	};
+	TEST_CHECK(checkQueries());
+
+	// 移動（Update / SetAABB + Refit）した後も一致する
+	for (uint32_t index = 0; index < kCount; index += 3) {
+		if (index % 97 == 0 || index % 89 == 0) {
+			continue;
+		}
+		Float3 offset = { random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f) };
+		boxes[index] = AABB{ boxes[index].min + offset, boxes[index].max + offset };
+		if (index % 2) {
+			tree.Update(proxies[index], boxes[index]);
+		} else {
+			tree.SetAABB(proxies[index], boxes[index]);
+		}
+	}
+	tree.Refit();
+	TEST_CHECK(checkQueries());
+
+	// 無限大を含む要素の範囲を書き換えても一致する
+	boxes[89].min.x = -kInfinity;
+	tree.SetAABB(proxies[89], boxes[89]);
+	TEST_CHECK(checkQueries());
+
+	// Buildした木から削除しても、作り直さずに一致する（無限大を含む要素も消える）
+	for (uint32_t index = 0; index < kCount; index += 7) {
+		tree.Remove(proxies[index]);
+		alive[index] = 0;
+	}
+	TEST_CHECK(tree.GetItemCount() == kCount - (kCount + 6) / 7);
+	TEST_CHECK(checkQueries());
+
+	// 削除と追加を交互に行っても、作り直さずに一致する
+	for (uint32_t index = 1; index < kCount; index += 5) {
+		if (!alive[index]) {
+			continue;
+		}
+		tree.Remove(proxies[index]);
+		boxes[index] = MakeBox(random, 100.0f, 5.0f);
+		proxies[index] = tree.Insert(boxes[index], index);
+	}
+	TEST_CHECK(checkQueries());
+
+	// 作り直した後も一致する
+	tree.Build();
+	TEST_CHECK(checkQueries());
+
+	// レイと視錐台のクエリでは、無限大を含む要素は常に結果に含まれる
+	std::vector<uint32_t> unbounded = LinearQuery(boxes, alive, [](const AABB& aabb) {
+		return aabb.min.x == -kInfinity || aabb.min.y == -kInfinity;
+	});
+	TEST_CHECK(!unbounded.empty());
+	std::vector<uint32_t> out;
+	tree.QueryRay({ 1000.0f, 1000.0f, 1000.0f }, { 1.0f, 0.0f, 0.0f }, 10.0f, out);
+	TEST_CHECK(Sorted(out) == unbounded);
+
+	// Buildせずに空の木へ追加・削除しても一致し、高さは要素数に対して対数程度に収まる
+	tree.Clear();
+	std::fill(alive.begin(), alive.end(), uint8_t(0));
+	for (uint32_t index = 0; index < kCount; ++index) {
+		if (index % 97 == 0 || index % 89 == 0) {
+			continue;
+		}
+		// 一方向に並べて入れても偏らないことを確かめる
+		Float3 center = { static_cast<float>(index) * 0.1f - 100.0f, 0.0f, 0.0f };
+		boxes[index] = AABB{ center - Float3{ 0.5f, 0.5f, 0.5f }, center + Float3{ 0.5f, 0.5f, 0.5f } };
+		proxies[index] = tree.Insert(boxes[index], index);
+		alive[index] = 1;
+	}
+	TEST_CHECK(tree.GetHeight() <= 20);
+	TEST_CHECK(checkQueries());
+	for (uint32_t index = 0; index < kCount; index += 2) {
+		if (alive[index]) {
+			tree.Remove(proxies[index]);
+			alive[index] = 0;
+		}
+	}
+	TEST_CHECK(tree.GetHeight() <= 20);
+	TEST_CHECK(tree.GetNodeCount() == tree.GetItemCount() * 2 - 1);
+	TEST_CHECK(checkQueries());
+
+	// 全て解除すると何も返さない
+	tree.Clear();
+	tree.Build();
+	out.clear();
+	tree.QueryPoint({ 0.0f, 0.0f, 0.0f }, out);
+	TEST_CHECK(out.empty());
+	TEST_CHECK(tree.GetItemCount() == 0);
+
+	return Test::Finish("AABBTreeTest");
+}
@@ -0,0 +1,152 @@
+#include "Culling.h"
+#include "Frustum.h"
+#include "Transform.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <vector>
+
+namespace {
+	constexpr float kTolerance = 1e-5f;
+	constexpr float kPi = 3.14159265f;
+
+	float Evaluate(const Plane& plane, const Float3& p)
+	{
+		return plane.normal.x * p.x + plane.normal.y * p.y + plane.normal.z * p.z + plane.distance;
+	}
+
+	void CheckPlane(const Plane& plane, const Float3& normal, float distance)
+	{
+		TEST_CHECK_NEAR(plane.normal.x, normal.x, kTolerance);
+		TEST_CHECK_NEAR(plane.normal.y, normal.y, kTolerance);
+		TEST_CHECK_NEAR(plane.normal.z, normal.z, kTolerance);
+		// farは行列の2つの要素の差から求めるので、桁落ちの分だけ誤差が大きい
+		TEST_CHECK_NEAR(plane.distance, distance, 1e-4f * (1.0f + std::fabs(distance)));
+	}
+
+	// クリップ座標で点が内側にあるか（D3Dの -w <= x,y <= w, 0 <= z <= w）
+	bool IsInsideClip(const Matrix& viewProjection, const Float3& p)
+	{
+		const Matrix& m = viewProjection;
+		float x = p.x * m.r[0][0] + p.y * m.r[1][0] + p.z * m.r[2][0] + m.r[3][0];
+		float y = p.x * m.r[0][1] + p.y * m.r[1][1] + p.z * m.r[2][1] + m.r[3][1];
+		float z = p.x * m.r[0][2] + p.y * m.r[1][2] + p.z * m.r[2][2] + m.r[3][2];
+		float w = p.x * m.r[0][3] + p.y * m.r[1][3] + p.z * m.r[2][3] + m.r[3][3];
+		return -w <= x && x <= w && -w <= y && y <= w && 0.0f <= z && z <= w;
+	}
+
+	// AABBの8頂点のうち、どの平面に対しても1つは内側にあれば見える（IsVisibleと同じ保守的な判定）
+	bool IsVisibleReference(const Frustum& frustum, const AABB& aabb)
+	{
+		for (const Plane& plane : frustum.planes) {
+			bool isAnyInside = false;
+			for (int corner = 0; corner < 8; ++corner) {
+				Float3 p = {
+					corner & 1 ? aabb.max.x : aabb.min.x,
+					corner & 2 ? aabb.max.y : aabb.min.y,
+					corner & 4 ? aabb.max.z : aabb.min.z,
+				};
+				isAnyInside = isAnyInside || Evaluate(plane, p) >= 0.0f;
+			}
+			if (!isAnyInside) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	AABB MakeBox(const Float3& center, float extent)
+	{
+		return { { center.x - extent, center.y - extent, center.z - extent }, { center.x + extent, center.y + extent, center.z + extent } };
+	}
+}
+
+int main()
+{
+	// 原点から+Zを向いた、縦横90度・near 1・far 100の視錐台
+	const float kNear = 1.0f, kFar = 100.0f;
+	Matrix projection = Matrix::PerspectiveFovLH(kPi * 0.5f, 1.0f, kNear, kFar);
+	Frustum frustum = Frustum::FromViewProjection(projection);
+
+	// 平面の取り出し（法線は内側向きで正規化済み）
+	const float s = 0.70710678f;
+	CheckPlane(frustum.planes[Frustum::kLeft], { s, 0.0f, s }, 0.0f);
+	CheckPlane(frustum.planes[Frustum::kRight], { -s, 0.0f, s }, 0.0f);
+	CheckPlane(frustum.planes[Frustum::kBottom], { 0.0f, s, s }, 0.0f);
+	CheckPlane(frustum.planes[Frustum::kTop], { 0.0f, -s, s }, 0.0f);
+	CheckPlane(frustum.planes[Frustum::kNear], { 0.0f, 0.0f, 1.0f }, -kNear);
+	CheckPlane(frustum.planes[Frustum::kFar], { 0.0f, 0.0f, -1.0f }, kFar);
+
+	TEST_CHECK(frustum.Contains({ 0.0f, 0.0f, 10.0f }));
+	TEST_CHECK(frustum.Contains({ 9.0f, -9.0f, 10.0f }));
+	TEST_CHECK(!frustum.Contains({ 11.0f, 0.0f, 10.0f }));
+	TEST_CHECK(!frustum.Contains({ 0.0f, 0.0f, 0.5f }));
+	TEST_CHECK(!frustum.Contains({ 0.0f, 0.0f, 101.0f }));
+	TEST_CHECK(!frustum.Contains({ 0.0f, 0.0f, -10.0f }));
+
+	// 回転・移動したカメラでも、平面の判定がクリップ座標での判定と一致する
+	Transform camera;
+	camera.scale = { 1.0f, 1.0f, 1.0f };
+	camera.rotate = { 0.3f, -1.1f, 0.2f };
+	camera.translate = { 5.0f, 2.0f, -8.0f };
+	Matrix viewProjection = Matrix::InverseRigid(camera.MakeAffineMatrix()) * Matrix::PerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 50.0f);
+	Frustum cameraFrustum = Frustum::FromViewProjection(viewProjection);
+	Random random(17);
+	int numInside = 0, numMismatch = 0;
+	for (int i = 0; i < 10000; ++i) {
+		Float3 p = { random.Range(-60.0f, 60.0f), random.Range(-60.0f, 60.0f), random.Range(-60.0f, 60.0f) };
+		// 境界のごく近くは丸め誤差でどちらにもなりうるので除く
+		bool isNearBoundary = false;
+		for (const Plane& plane : cameraFrustum.planes) {
+			isNearBoundary = isNearBoundary || std::fabs(Evaluate(plane, p)) < 1e-3f;
+		}
+		if (isNearBoundary) {
+			continue;
+		}
+		bool isInside = IsInsideClip(viewProjection, p);
+		numInside += isInside;
+		numMismatch += isInside != cameraFrustum.Contains(p);
+	}
+	std::printf("frustum vs clip space: %d inside, %d mismatches\n", numInside, numMismatch);
+	TEST_CHECK(numInside > 0);
+	TEST_CHECK(numMismatch == 0);
+
+	// Culling::IsVisible: 内側・外側・平面をまたぐもの
+	Culling::Planes planes = Culling::MakePlanes(frustum);
+	TEST_CHECK(Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, 10.0f }, 1.0f))); // 内側
+	TEST_CHECK(!Culling::IsVisible(planes, MakeBox({ -30.0f, 0.0f, 10.0f }, 1.0f))); // 左の外
+	TEST_CHECK(!Culling::IsVisible(planes, MakeBox({ 0.0f, 30.0f, 10.0f }, 1.0f))); // 上の外
+	TEST_CHECK(!Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, -10.0f }, 1.0f))); // 後ろ
+	TEST_CHECK(!Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, 120.0f }, 1.0f))); // farの外
+	TEST_CHECK(Culling::IsVisible(planes, MakeBox({ -10.0f, 0.0f, 10.0f }, 1.0f))); // 左の平面をまたぐ
+	TEST_CHECK(Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, 100.0f }, 1.0f))); // farの平面をまたぐ
+	TEST_CHECK(Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, 0.0f }, 2.0f))); // nearの平面とカメラを含む
+	TEST_CHECK(Culling::IsVisible(planes, MakeBox({ 0.0f, 0.0f, 50.0f }, 500.0f))); // 視錐台全体を含む
+
+	TEST_CHECK(Culling::IsVisible(planes, { 0.0f, 0.0f, 10.0f }, 1.0f));
+	TEST_CHECK(Culling::IsVisible(planes, { -10.5f, 0.0f, 10.0f }, 1.0f)); // 中心は外で、球は左の平面をまたぐ
+	TEST_CHECK(!Culling::IsVisible(planes, { -12.0f, 0.0f, 10.0f }, 1.0f));
+	TEST_CHECK(!Culling::IsVisible(planes, { 0.0f, 0.0f, -2.0f }, 1.0f));
+
+	// ランダムなAABBで、IsVisible・CullAABBsが8頂点の参照実装と一致する
+	Culling::Planes cameraPlanes = Culling::MakePlanes(cameraFrustum);
+	std::vector<AABB> boxes;
+	for (int i = 0; i < 1003; ++i) {
+		boxes.push_back(MakeBox({ random.Range(-60.0f, 60.0f), random.Range(-60.0f, 60.0f), random.Range(-60.0f, 60.0f) }, random.Range(0.1f, 8.0f)));
+	}
+	std::vector<uint8_t> visible(boxes.size());
+	size_t numVisible = Culling::CullAABBs(cameraPlanes, boxes.data(), boxes.size(), visible.data());
+	size_t numExpected = 0;
+	int numWrong = 0;
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		bool expected = IsVisibleReference(cameraFrustum, boxes[i]);
+		numExpected += expected;
+		numWrong += expected != Culling::IsVisible(cameraPlanes, boxes[i]);
+		numWrong += expected != (visible[i] != 0);
+	}
+	std::printf("random AABBs: %zu / %zu visible, %d wrong\n", numExpected, boxes.size(), numWrong);
+	TEST_CHECK(numExpected > 0 && numExpected < boxes.size());
+	TEST_CHECK(numVisible == numExpected);
+	TEST_CHECK(numWrong == 0);
+
+	return Test::Finish("CullingTest");
+}
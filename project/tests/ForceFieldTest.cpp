@@ -0,0 +1,158 @@
+#include "ForceFieldSystem.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+	using Field = ForceFieldSystem::Field;
+	using Type = ForceFieldSystem::Type;
+
+	// ForceFieldSystem.cppのAttractorと同じ値
+	constexpr float kAttractorSoftening = 0.01f;
+
+	// 1つのFieldを1つのパーティクルに適用する（範囲の判定も含めたスカラーの参照実装）
+	void ApplyFieldScalar(const Field& field, const Float3& p, Float3& v, float deltaTime)
+	{
+		if (!(p.x >= field.bounds.min.x && p.x <= field.bounds.max.x &&
+			p.y >= field.bounds.min.y && p.y <= field.bounds.max.y &&
+			p.z >= field.bounds.min.z && p.z <= field.bounds.max.z)) {
+			return;
+		}
+		Float3 delta = { 0.0f, 0.0f, 0.0f };
+		switch (field.type) {
+		case Type::Gravity:
+			delta = { field.vector.x * deltaTime, field.vector.y * deltaTime, field.vector.z * deltaTime };
+			break;
+		case Type::Attractor: {
+			Float3 d = { field.center.x - p.x, field.center.y - p.y, field.center.z - p.z };
+			float distanceSq = d.x * d.x + d.y * d.y + d.z * d.z + kAttractorSoftening;
+			float scale = field.strength * deltaTime / (distanceSq * std::sqrt(distanceSq));
+			delta = { d.x * scale, d.y * scale, d.z * scale };
+			break;
+		}
+		case Type::Vortex: {
+			Float3 r = { p.x - field.center.x, p.y - field.center.y, p.z - field.center.z };
+			float k = field.strength * deltaTime;
+			Float3 a = { field.vector.x * k, field.vector.y * k, field.vector.z * k };
+			delta = { a.y * r.z - a.z * r.y, a.z * r.x - a.x * r.z, a.x * r.y - a.y * r.x };
+			break;
+		}
+		case Type::Drag: {
+			float k = -(std::min)(field.strength * deltaTime, 1.0f);
+			delta = { v.x * k, v.y * k, v.z * k };
+			break;
+		}
+		case Type::Turbulence: {
+			float x = p.x * field.frequency, y = p.y * field.frequency, z = p.z * field.frequency;
+			float scale = field.strength * deltaTime;
+			delta = { std::sin(y) * std::cos(z) * scale, std::sin(z) * std::cos(x) * scale, std::sin(x) * std::cos(y) * scale };
+			break;
+		}
+		}
+		v.x += delta.x;
+		v.y += delta.y;
+		v.z += delta.z;
+	}
+}
+
+int main()
+{
+	// 範囲の一部だけが重なるFieldを並べ、範囲の内外が混ざった区間にApplyした結果をスカラーの参照実装と比べる
+	// 区間の長さを変えて、4つずつの処理と端数の両方を通す
+	const float kDeltaTime = 1.0f / 60.0f;
+	const float kTolerance = 1e-4f;
+
+	Random random(9);
+	std::vector<Field> fields;
+	const Type kTypes[] = { Type::Gravity, Type::Attractor, Type::Vortex, Type::Drag, Type::Turbulence };
+	for (int i = 0; i < 20; ++i) {
+		Field field;
+		field.type = kTypes[i % 5];
+		Float3 center = { random.Range(-4.0f, 4.0f), random.Range(-4.0f, 4.0f), random.Range(-4.0f, 4.0f) };
+		float extent = random.Range(1.0f, 3.0f);
+		field.bounds = { { center.x - extent, center.y - extent, center.z - extent }, { center.x + extent, center.y + extent, center.z + extent } };
+		field.center = center;
+		field.vector = field.type == Type::Gravity ? Float3{ 0.0f, -9.8f, 0.0f } : Float3{ 0.0f, 0.0f, 1.0f };
+		field.strength = random.Range(0.5f, 3.0f);
+		field.frequency = 0.7f;
+		fields.push_back(field);
+	}
+
+	ForceFieldSystem system;
+	for (const Field& field : fields) {
+		system.Add(field);
+	}
+	system.Build();
+
+	ParticleStorage particles;
+	const size_t kCount = 257;
+	particles.Append(kCount);
+	for (size_t i = 0; i < kCount; ++i) {
+		particles.positionX[i] = random.Range(-7.0f, 7.0f);
+		particles.positionY[i] = random.Range(-7.0f, 7.0f);
+		particles.positionZ[i] = random.Range(-7.0f, 7.0f);
+		particles.velocityX[i] = random.Range(-1.0f, 1.0f);
+		particles.velocityY[i] = random.Range(-1.0f, 1.0f);
+		particles.velocityZ[i] = random.Range(-1.0f, 1.0f);
+		particles.lifeTime[i] = 10.0f;
+	}
+	// 範囲の境界ちょうど（内側として扱う）と、わずかに外側
+	particles.positionX[0] = fields[0].bounds.min.x;
+	particles.positionY[0] = fields[0].bounds.max.y;
+	particles.positionZ[0] = fields[0].bounds.min.z;
+	particles.positionX[1] = std::nextafter(fields[0].bounds.max.x, 100.0f);
+	particles.positionY[1] = fields[0].bounds.min.y;
+	particles.positionZ[1] = fields[0].bounds.min.z;
+
+	// 参照の結果（Fieldは登録順に適用される）
+	std::vector<Float3> expected(kCount);
+	int numAffected = 0, numUnaffected = 0;
+	for (size_t i = 0; i < kCount; ++i) {
+		Float3 p = { particles.positionX[i], particles.positionY[i], particles.positionZ[i] };
+		Float3 v = { particles.velocityX[i], particles.velocityY[i], particles.velocityZ[i] };
+		Float3 before = v;
+		for (const Field& field : fields) {
+			ApplyFieldScalar(field, p, v, kDeltaTime);
+		}
+		expected[i] = v;
+		(v.x == before.x && v.y == before.y && v.z == before.z ? numUnaffected : numAffected)++;
+	}
+	// 範囲内と範囲外の両方があること
+	TEST_CHECK(numAffected > 0 && numUnaffected > 0);
+
+	// 1, 2, 3, ... 個ずつの区間に分けて適用する
+	size_t begin = 0;
+	for (size_t length = 1; begin < kCount; ++length) {
+		size_t end = (std::min)(begin + length, kCount);
+		system.Apply(particles, begin, end, kDeltaTime);
+		begin = end;
+	}
+
+	float maxError = 0.0f;
+	for (size_t i = 0; i < kCount; ++i) {
+		maxError = (std::max)(maxError, std::fabs(particles.velocityX[i] - expected[i].x) / (1.0f + std::fabs(expected[i].x)));
+		maxError = (std::max)(maxError, std::fabs(particles.velocityY[i] - expected[i].y) / (1.0f + std::fabs(expected[i].y)));
+		maxError = (std::max)(maxError, std::fabs(particles.velocityZ[i] - expected[i].z) / (1.0f + std::fabs(expected[i].z)));
+	}
+	std::printf("affected %d, unaffected %d, max error %g\n", numAffected, numUnaffected, maxError);
+	TEST_CHECK(maxError < kTolerance);
+
+	// 範囲外のパーティクルの速度は1ビットも変わらない
+	for (size_t i = 0; i < kCount; ++i) {
+		Float3 p = { particles.positionX[i], particles.positionY[i], particles.positionZ[i] };
+		bool isInside = false;
+		for (const Field& field : fields) {
+			isInside |= p.x >= field.bounds.min.x && p.x <= field.bounds.max.x &&
+				p.y >= field.bounds.min.y && p.y <= field.bounds.max.y &&
+				p.z >= field.bounds.min.z && p.z <= field.bounds.max.z;
+		}
+		if (!isInside) {
+			TEST_CHECK(particles.velocityX[i] == expected[i].x && particles.velocityY[i] == expected[i].y && particles.velocityZ[i] == expected[i].z);
+		}
+	}
+
+	return Test::Finish("ForceFieldTest");
+}
@@ -0,0 +1,97 @@
+#include "JobSystem.h"
+#include "TestUtil.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+	// [0, count)の全ての番号がちょうど1回ずつ処理され、チャンク番号が範囲と一致するか
+	bool RunAndCheck(JobSystem* jobSystem, size_t count, size_t chunkSize)
+	{
+		// 呼び出し元のスタックに置く（ParallelForが返った後にワーカーが触ると壊れる）
+		std::vector<std::atomic<uint32_t>> hits(count);
+		std::atomic<bool> isChunkValid = true;
+		jobSystem->ParallelFor(count, chunkSize, [&](size_t begin, size_t end, size_t chunkIndex) {
+			if (begin != chunkIndex * chunkSize || end > count || begin >= end) {
+				isChunkValid = false;
+			}
+			for (size_t i = begin; i < end; ++i) {
+				hits[i].fetch_add(1);
+			}
+		});
+		for (size_t i = 0; i < count; ++i) {
+			if (hits[i].load() != 1) {
+				return false;
+			}
+		}
+		return isChunkValid;
+	}
+}
+
+int main()
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(4);
+
+	// 大きさとチャンクの組み合わせ
+	for (size_t count : { 0, 1, 7, 64, 1000, 4097 }) {
+		for (size_t chunkSize : { 1, 3, 64, 5000 }) {
+			TEST_CHECK(RunAndCheck(jobSystem, count, chunkSize));
+		}
+	}
+
+	// 小さなジョブを続けて出す（前のジョブのワーカーが抜ける前に次のジョブを出すと、チャンクが重複・欠落する）
+	bool isAllValid = true;
+	for (int i = 0; i < 5000; ++i) {
+		isAllValid &= RunAndCheck(jobSystem, 1 + i % 13, 1);
+	}
+	TEST_CHECK(isAllValid);
+
+	// 別のスレッド（モデルの読み込みなど）と同時に出す
+	std::atomic<bool> isOtherValid = true;
+	std::thread other([&] {
+		for (int i = 0; i < 2000; ++i) {
+			if (!RunAndCheck(jobSystem, 1 + i % 29, 2)) {
+				isOtherValid = false;
+			}
+		}
+	});
+	isAllValid = true;
+	for (int i = 0; i < 2000; ++i) {
+		isAllValid &= RunAndCheck(jobSystem, 1 + i % 31, 1);
+	}
+	other.join();
+	TEST_CHECK(isAllValid);
+	TEST_CHECK(isOtherValid.load());
+
+	// ジョブの中から呼ぶとその場で順番に処理される
+	std::atomic<size_t> nestedTotal = 0;
+	jobSystem->ParallelFor(8, 1, [&](size_t, size_t, size_t) {
+		jobSystem->ParallelFor(10, 3, [&](size_t begin, size_t end, size_t) {
+			nestedTotal += end - begin;
+		});
+	});
+	TEST_CHECK(nestedTotal.load() == 80);
+
+	// 決定的な結果（チャンクごとに書き分けた和は、スレッド数によらない）
+	std::vector<uint64_t> sums(JobSystem::GetChunkCount(100000, 1000));
+	jobSystem->ParallelFor(100000, 1000, [&](size_t begin, size_t end, size_t chunkIndex) {
+		uint64_t sum = 0;
+		for (size_t i = begin; i < end; ++i) {
+			sum += i * i;
+		}
+		sums[chunkIndex] = sum;
+	});
+	uint64_t total = 0;
+	for (uint64_t sum : sums) {
+		total += sum;
+	}
+	uint64_t expected = 0;
+	for (uint64_t i = 0; i < 100000; ++i) {
+		expected += i * i;
+	}
+	TEST_CHECK(total == expected);
+
+	jobSystem->Finalize();
+	return Test::Finish("JobSystemTest");
+}
@@ -0,0 +1,82 @@
+#include "MPSCQueue.h"
+#include "TestUtil.h"
+#include <thread>
+#include <vector>
+
+namespace {
+	// 積んだ側と、その側での通し番号
+	struct Message {
+		uint32_t producer;
+		uint32_t sequence;
+	};
+}
+
+// 複数のスレッドから積んだ要素が、欠けたり重複したりせず、積んだ側ごとの順番を保って取り出せるか
+int main()
+{
+	// 1スレッドで、満杯と空の判定と、周回した後の順番
+	{
+		MPSCQueue<Message> queue(4);
+		TEST_CHECK(queue.GetCapacity() == 4);
+		Message message{};
+		TEST_CHECK(!queue.TryPop(message));
+		for (uint32_t round = 0; round < 3; ++round) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				TEST_CHECK(queue.TryPush(Message{ 0, round * 4 + i }));
+			}
+			TEST_CHECK(!queue.TryPush(Message{ 0, 99 }));
+			for (uint32_t i = 0; i < 4; ++i) {
+				TEST_CHECK(queue.TryPop(message) && message.sequence == round * 4 + i);
+			}
+			TEST_CHECK(!queue.TryPop(message));
+		}
+	}
+
+	// 複数スレッドから積む（容量を小さくして、満杯と周回を何度も起こす）
+	constexpr uint32_t kProducerCount = 4;
+	constexpr uint32_t kMessageCount = 100000;
+	MPSCQueue<Message> queue(64);
+
+	std::vector<std::thread> producers;
+	for (uint32_t producer = 0; producer < kProducerCount; ++producer) {
+		producers.emplace_back([&queue, producer]() {
+			for (uint32_t sequence = 0; sequence < kMessageCount; ++sequence) {
+				while (!queue.TryPush(Message{ producer, sequence })) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// 積んだ側ごとに次に来るはずの番号を持ち、1つずつ増えていくことを確かめる
+	std::vector<uint32_t> nextSequence(kProducerCount, 0);
+	bool isOrdered = true;
+	uint32_t received = 0;
+	while (received < kProducerCount * kMessageCount) {
+		Message message;
+		if (!queue.TryPop(message)) {
+			std::this_thread::yield();
+			continue;
+		}
+		++received;
+		// 順番が崩れても、積む側が終われるように最後まで取り出す
+		if (message.producer >= kProducerCount || message.sequence != nextSequence[message.producer]) {
+			isOrdered = false;
+			continue;
+		}
+		++nextSequence[message.producer];
+	}
+	for (std::thread& producer : producers) {
+		producer.join();
+	}
+
+	TEST_CHECK(isOrdered);
+	for (uint32_t producer = 0; producer < kProducerCount; ++producer) {
+		TEST_CHECK(nextSequence[producer] == kMessageCount);
+	}
+	// 全て取り出した後は空
+	Message message;
+	TEST_CHECK(!queue.TryPop(message));
+
+	return Test::Finish("MPSCQueueTest");
+}
@@ -0,0 +1,87 @@
+#include "Matrix.h"
+#include "Transform.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <random>
+
+namespace {
+	// 要素ごとの差の最大値（大きい要素は相対誤差で比べる）
+	float MaxRelativeDifference(const Matrix& a, const Matrix& b)
+	{
+		float difference = 0.0f;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				float scale = 1.0f + std::fabs(b.r[row][column]);
+				difference = (std::max)(difference, std::fabs(a.r[row][column] - b.r[row][column]) / scale);
+			}
+		}
+		return difference;
+	}
+
+	// m * inverseと単位行列との差の最大値
+	float IdentityError(const Matrix& m, const Matrix& inverse)
+	{
+		return MaxRelativeDifference(m * inverse, Matrix::Identity());
+	}
+}
+
+int main()
+{
+	// InverseAffine・InverseRigidを、ランダムなSRT・RT行列で一般の逆行列（Inverse）と比べる
+	const float kTolerance = 1e-4f;
+	// 比べる相手にする一般の逆行列の精度
+	const float kReferenceTolerance = 1e-5f;
+	const int kCount = 10000;
+
+	std::mt19937 engine(2);
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> scale(0.2f, 3.0f);
+	std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+
+	float maxAffineDifference = 0.0f, maxRigidDifference = 0.0f;
+	float maxAffineIdentityError = 0.0f, maxRigidIdentityError = 0.0f;
+	int numCompared = 0;
+	for (int i = 0; i < kCount; ++i) {
+		Transform transform;
+		transform.scale = { scale(engine), scale(engine), scale(engine) };
+		transform.rotate = { angle(engine), angle(engine), angle(engine) };
+		transform.translate = { position(engine), position(engine), position(engine) };
+		Matrix affine = transform.MakeAffineMatrix();
+		transform.scale = { 1.0f, 1.0f, 1.0f };
+		Matrix rigid = transform.MakeAffineMatrix();
+
+		Matrix affineInverse = Matrix::InverseAffine(affine);
+		Matrix rigidInverse = Matrix::InverseRigid(rigid);
+		maxAffineIdentityError = (std::max)(maxAffineIdentityError, IdentityError(affine, affineInverse));
+		maxRigidIdentityError = (std::max)(maxRigidIdentityError, IdentityError(rigid, rigidInverse));
+
+		// 一般の逆行列はピボット選択をしないので、それ自体が正確な場合だけ比べる
+		Matrix generalAffine = Matrix::Inverse(affine);
+		Matrix generalRigid = Matrix::Inverse(rigid);
+		if (IdentityError(affine, generalAffine) < kReferenceTolerance && IdentityError(rigid, generalRigid) < kReferenceTolerance) {
+			maxAffineDifference = (std::max)(maxAffineDifference, MaxRelativeDifference(affineInverse, generalAffine));
+			maxRigidDifference = (std::max)(maxRigidDifference, MaxRelativeDifference(rigidInverse, generalRigid));
+			++numCompared;
+		}
+	}
+
+	std::printf("compared with Inverse: %d / %d\n", numCompared, kCount);
+	std::printf("affine: max difference %g, max |M * M^-1 - I| %g\n", maxAffineDifference, maxAffineIdentityError);
+	std::printf("rigid:  max difference %g, max |M * M^-1 - I| %g\n", maxRigidDifference, maxRigidIdentityError);
+	TEST_CHECK(numCompared > kCount / 2);
+	TEST_CHECK(maxAffineDifference < kTolerance);
+	TEST_CHECK(maxRigidDifference < kTolerance);
+	TEST_CHECK(maxAffineIdentityError < kTolerance);
+	TEST_CHECK(maxRigidIdentityError < kTolerance);
+
+	// Transform::MakeInverseAffineMatrixはスケールによって使い分ける
+	Transform transform;
+	transform.scale = { 1.0f, 1.0f, 1.0f };
+	transform.rotate = { 0.3f, -1.2f, 2.0f };
+	transform.translate = { 4.0f, -5.0f, 6.0f };
+	TEST_CHECK(MaxRelativeDifference(transform.MakeInverseAffineMatrix(), Matrix::InverseRigid(transform.MakeAffineMatrix())) == 0.0f);
+	transform.scale = { 2.0f, 0.5f, 1.5f };
+	TEST_CHECK(MaxRelativeDifference(transform.MakeInverseAffineMatrix(), Matrix::InverseAffine(transform.MakeAffineMatrix())) == 0.0f);
+
+	return Test::Finish("MatrixInverseTest");
+}
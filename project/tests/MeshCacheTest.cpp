@@ -0,0 +1,165 @@
+#include "MeshCache.h"
+#include "TestUtil.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+	void WriteFile(const std::string& path, const std::vector<char>& bytes)
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	std::vector<char> ReadFile(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	// 格子状の頂点と、それを2つずつの三角形でつないだメッシュ
+	ModelMesh MakeGridMesh(uint32_t width, uint32_t height)
+	{
+		ModelMesh mesh;
+		for (uint32_t y = 0; y < height; ++y) {
+			for (uint32_t x = 0; x < width; ++x) {
+				float u = float(x) / float(width - 1), v = float(y) / float(height - 1);
+				mesh.vertices.push_back({ { u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f, 1.0f }, { u, v }, { 0.0f, 0.0f, -1.0f } });
+			}
+		}
+		for (uint32_t y = 0; y + 1 < height; ++y) {
+			for (uint32_t x = 0; x + 1 < width; ++x) {
+				uint32_t i = y * width + x;
+				mesh.indices.insert(mesh.indices.end(), { i, i + width, i + 1, i + 1, i + width, i + width + 1 });
+			}
+		}
+		mesh.bounds = { { -1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f } };
+		mesh.rootNode.name = "root";
+		mesh.rootNode.localMatrix = Matrix::Translation({ 1.0f, 2.0f, 3.0f });
+		mesh.rootNode.children.resize(2);
+		mesh.rootNode.children[0].name = "child0";
+		mesh.rootNode.children[0].localMatrix = Matrix::Scaling({ 2.0f, 2.0f, 2.0f });
+		mesh.rootNode.children[0].children.resize(1);
+		mesh.rootNode.children[0].children[0].name = "grandchild";
+		mesh.rootNode.children[0].children[0].localMatrix = Matrix::Identity();
+		mesh.rootNode.children[1].name = "child1";
+		mesh.rootNode.children[1].localMatrix = Matrix::Identity();
+		return mesh;
+	}
+
+	bool IsSameNode(const ModelNode& a, const ModelNode& b)
+	{
+		if (a.name != b.name || std::memcmp(&a.localMatrix, &b.localMatrix, sizeof(Matrix)) != 0 || a.children.size() != b.children.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a.children.size(); ++i) {
+			if (!IsSameNode(a.children[i], b.children[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IsSameMesh(const ModelMesh& a, const ModelMesh& b)
+	{
+		return a.vertices.size() == b.vertices.size() &&
+			std::memcmp(a.vertices.data(), b.vertices.data(), sizeof(ModelVertex) * a.vertices.size()) == 0 &&
+			a.indices == b.indices &&
+			a.material.textureFilePath == b.material.textureFilePath &&
+			a.bounds.min == b.bounds.min && a.bounds.max == b.bounds.max &&
+			IsSameNode(a.rootNode, b.rootNode);
+	}
+}
+
+int main()
+{
+	// 書き出したキャッシュが同じ内容で読めることと、使ってはいけないキャッシュを読まないことを確かめる
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "MeshCacheTest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	std::string directoryPath = directory.generic_string();
+	std::string sourcePath = directoryPath + "/grid.obj";
+	std::string cachePath = MeshCache::GetCachePath(sourcePath);
+	WriteFile(sourcePath, { 'o', ' ', 'g', 'r', 'i', 'd', '\n' });
+
+	// 16bitと32bitのインデックスの両方で往復させる
+	for (uint32_t width : { 8u, 300u }) {
+		ModelMesh mesh = MakeGridMesh(width, width);
+		mesh.material.textureFilePath = directoryPath + "/grid.png";
+		TEST_CHECK(ModelMesh::CanUse16BitIndices(mesh.vertices.size()) == (width == 8));
+		TEST_CHECK(MeshCache::Save(directoryPath, sourcePath, mesh));
+		ModelMesh loaded;
+		TEST_CHECK(MeshCache::Load(directoryPath, sourcePath, &loaded));
+		TEST_CHECK(IsSameMesh(loaded, mesh));
+	}
+
+	ModelMesh mesh = MakeGridMesh(8, 8);
+	ModelMesh loaded;
+	// 読めなかったときに渡す（中身は書き換えられないはず）
+	ModelMesh rejected;
+	TEST_CHECK(MeshCache::Save(directoryPath, sourcePath, mesh));
+	std::vector<char> cacheBytes = ReadFile(cachePath);
+	TEST_CHECK(cacheBytes.size() > sizeof(MeshCache::Header));
+
+	// 元のファイルのサイズが変わった
+	WriteFile(sourcePath, { 'o', ' ', 'g', 'r', 'i', 'd', '2', '\n' });
+	TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+	WriteFile(sourcePath, { 'o', ' ', 'g', 'r', 'i', 'd', '\n' });
+
+	// 元のファイルの更新時刻だけが変わった
+	TEST_CHECK(MeshCache::Save(directoryPath, sourcePath, mesh));
+	TEST_CHECK(MeshCache::Load(directoryPath, sourcePath, &loaded));
+	auto writeTime = std::filesystem::last_write_time(sourcePath);
+	std::filesystem::last_write_time(sourcePath, writeTime + std::chrono::seconds(10));
+	TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+
+	// 以降は元のファイルに合ったキャッシュを書き換えて試す
+	TEST_CHECK(MeshCache::Save(directoryPath, sourcePath, mesh));
+	cacheBytes = ReadFile(cachePath);
+	MeshCache::Header header;
+	std::memcpy(&header, cacheBytes.data(), sizeof(header));
+
+	// ヘッダのチェックサムが合わない（頂点数だけ書き換える）
+	{
+		std::vector<char> bytes = cacheBytes;
+		MeshCache::Header broken = header;
+		broken.vertexCount -= 1;
+		std::memcpy(bytes.data(), &broken, sizeof(broken));
+		WriteFile(cachePath, bytes);
+		TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+	}
+
+	// インデックスが頂点の範囲外を指す（チェックサムは正しい）
+	{
+		std::vector<char> bytes = cacheBytes;
+		uint16_t outOfRange = static_cast<uint16_t>(header.vertexCount);
+		TEST_CHECK(header.indexSize == sizeof(uint16_t));
+		std::memcpy(bytes.data() + header.indexOffset + sizeof(uint16_t) * 4, &outOfRange, sizeof(outOfRange));
+		WriteFile(cachePath, bytes);
+		TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+	}
+
+	// ファイルが途中で切れている
+	{
+		std::vector<char> bytes(cacheBytes.begin(), cacheBytes.end() - 5);
+		WriteFile(cachePath, bytes);
+		TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+		bytes.resize(sizeof(MeshCache::Header) / 2);
+		WriteFile(cachePath, bytes);
+		TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+	}
+
+	// キャッシュがない
+	std::filesystem::remove(cachePath);
+	TEST_CHECK(!MeshCache::Load(directoryPath, sourcePath, &rejected));
+
+	// 失敗した読み込みはoutを書き換えない。元に戻せばまた読める
+	TEST_CHECK(rejected.vertices.empty() && rejected.indices.empty());
+	WriteFile(cachePath, cacheBytes);
+	TEST_CHECK(MeshCache::Load(directoryPath, sourcePath, &loaded));
+	TEST_CHECK(IsSameMesh(loaded, mesh));
+
+	std::filesystem::remove_all(directory);
+	return Test::Finish("MeshCacheTest");
+}
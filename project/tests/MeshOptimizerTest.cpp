@@ -0,0 +1,193 @@
+#include "MeshOptimizer.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace {
+	// 頂点の中身をビット列で比べる
+	bool IsSameVertex(const ModelVertex& a, const ModelVertex& b)
+	{
+		return std::memcmp(&a, &b, sizeof(ModelVertex)) == 0;
+	}
+
+	bool LessVertex(const ModelVertex& a, const ModelVertex& b)
+	{
+		return std::memcmp(&a, &b, sizeof(ModelVertex)) < 0;
+	}
+
+	// 三角形を頂点の中身の3つ組にし、頂点の順（表裏）を保ったまま最小の頂点が先頭に来るように回す
+	using Triangle = std::array<ModelVertex, 3>;
+
+	bool LessTriangle(const Triangle& a, const Triangle& b)
+	{
+		for (size_t i = 0; i < 3; ++i) {
+			if (LessVertex(a[i], b[i])) {
+				return true;
+			}
+			if (LessVertex(b[i], a[i])) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	std::vector<Triangle> MakeTriangleMultiset(const std::vector<ModelVertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		std::vector<Triangle> triangles;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			Triangle triangle = { vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]] };
+			size_t first = 0;
+			for (size_t k = 1; k < 3; ++k) {
+				if (LessVertex(triangle[k], triangle[first])) {
+					first = k;
+				}
+			}
+			std::rotate(triangle.begin(), triangle.begin() + first, triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end(), LessTriangle);
+		return triangles;
+	}
+
+	bool IsSameTriangleMultiset(const std::vector<Triangle>& a, const std::vector<Triangle>& b)
+	{
+		if (a.size() != b.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a.size(); ++i) {
+			for (size_t k = 0; k < 3; ++k) {
+				if (!IsSameVertex(a[i][k], b[i][k])) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// 行ごとに並んだ格子（頂点は全て異なる）
+	void MakeGrid(uint32_t width, uint32_t height, std::vector<ModelVertex>* outVertices, std::vector<uint32_t>* outIndices)
+	{
+		outVertices->clear();
+		outIndices->clear();
+		for (uint32_t y = 0; y <= height; ++y) {
+			for (uint32_t x = 0; x <= width; ++x) {
+				float u = float(x) / float(width), v = float(y) / float(height);
+				outVertices->push_back({ { u, v, 0.0f, 1.0f }, { u, v }, { 0.0f, 0.0f, -1.0f } });
+			}
+		}
+		uint32_t stride = width + 1;
+		for (uint32_t y = 0; y < height; ++y) {
+			for (uint32_t x = 0; x < width; ++x) {
+				uint32_t i = y * stride + x;
+				outIndices->insert(outIndices->end(), { i, i + stride, i + 1, i + 1, i + stride, i + stride + 1 });
+			}
+		}
+	}
+}
+
+int main()
+{
+	// WeldVertices: 三角形リストから同じ頂点をまとめる
+	{
+		std::vector<ModelVertex> gridVertices;
+		std::vector<uint32_t> gridIndices;
+		MakeGrid(4, 3, &gridVertices, &gridIndices);
+		std::vector<ModelVertex> triangleList;
+		for (uint32_t index : gridIndices) {
+			triangleList.push_back(gridVertices[index]);
+		}
+
+		std::vector<ModelVertex> vertices;
+		std::vector<uint32_t> indices;
+		MeshOptimizer::WeldVertices(triangleList, &vertices, &indices);
+		// 格子の頂点数まで減り、インデックスで引くと元の三角形リストに戻る
+		TEST_CHECK(vertices.size() == gridVertices.size());
+		TEST_CHECK(indices.size() == triangleList.size());
+		bool isSameList = true;
+		for (size_t i = 0; i < indices.size(); ++i) {
+			isSameList = isSameList && indices[i] < vertices.size() && IsSameVertex(vertices[indices[i]], triangleList[i]);
+		}
+		TEST_CHECK(isSameList);
+		// 最初に現れた順に並ぶ
+		TEST_CHECK(indices[0] == 0 && indices[1] == 1 && indices[2] == 2);
+
+		// -0と+0は同じ頂点、法線だけ違うものは別の頂点
+		ModelVertex a = { { 0.0f, 1.0f, 2.0f, 1.0f }, { 0.5f, 0.5f }, { 0.0f, 1.0f, 0.0f } };
+		ModelVertex negativeZero = a;
+		negativeZero.position.x = -0.0f;
+		ModelVertex otherNormal = a;
+		otherNormal.normal = { 0.0f, -1.0f, 0.0f };
+		MeshOptimizer::WeldVertices({ a, negativeZero, otherNormal }, &vertices, &indices);
+		TEST_CHECK(vertices.size() == 2);
+		TEST_CHECK(indices == std::vector<uint32_t>({ 0, 0, 1 }));
+
+		MeshOptimizer::WeldVertices({}, &vertices, &indices);
+		TEST_CHECK(vertices.empty() && indices.empty());
+	}
+
+	// Optimize: 三角形と表裏を保ったまま並べ替え、頂点は並べ替えるだけで増減しない
+	// 行の順の格子と、三角形の順をばらばらにした格子で試す
+	Random random(13);
+	for (bool isShuffled : { false, true }) {
+		std::vector<ModelVertex> vertices;
+		std::vector<uint32_t> indices;
+		MakeGrid(64, 64, &vertices, &indices);
+		if (isShuffled) {
+			size_t numTriangles = indices.size() / 3;
+			for (size_t i = numTriangles - 1; i > 0; --i) {
+				size_t j = random.NextUInt() % (i + 1);
+				std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+			}
+		}
+
+		std::vector<Triangle> trianglesBefore = MakeTriangleMultiset(vertices, indices);
+		std::vector<ModelVertex> verticesBefore = vertices;
+		MeshOptimizer::VertexCacheStatistics cacheBefore = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+
+		MeshOptimizer::Optimize(vertices, indices);
+
+		MeshOptimizer::VertexCacheStatistics cacheAfter = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+		std::printf("grid 64x64 (%s): ACMR %.3f -> %.3f\n", isShuffled ? "shuffled" : "row order", cacheBefore.acmr, cacheAfter.acmr);
+
+		// 三角形の集合（頂点の順を含む）が変わらない
+		TEST_CHECK(indices.size() == trianglesBefore.size() * 3);
+		bool isIndexInRange = std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); });
+		TEST_CHECK(isIndexInRange);
+		if (isIndexInRange) {
+			TEST_CHECK(IsSameTriangleMultiset(MakeTriangleMultiset(vertices, indices), trianglesBefore));
+		}
+
+		// 頂点は元の頂点の並べ替え（全ての頂点が使われているので、過不足なく1つずつ）
+		TEST_CHECK(vertices.size() == verticesBefore.size());
+		std::vector<ModelVertex> sortedBefore = verticesBefore, sortedAfter = vertices;
+		std::sort(sortedBefore.begin(), sortedBefore.end(), LessVertex);
+		std::sort(sortedAfter.begin(), sortedAfter.end(), LessVertex);
+		bool isPermutation = sortedBefore.size() == sortedAfter.size();
+		for (size_t i = 0; isPermutation && i < sortedBefore.size(); ++i) {
+			isPermutation = IsSameVertex(sortedBefore[i], sortedAfter[i]) && (i == 0 || !IsSameVertex(sortedAfter[i - 1], sortedAfter[i]));
+		}
+		TEST_CHECK(isPermutation);
+
+		// 頂点キャッシュの効率は悪くならない（ばらばらの順からは大きく良くなる）
+		TEST_CHECK(cacheAfter.acmr <= cacheBefore.acmr);
+		if (isShuffled) {
+			TEST_CHECK(cacheAfter.acmr < cacheBefore.acmr * 0.5f);
+		}
+		// 頂点は初めて参照される順に並ぶ
+		uint32_t nextVertex = 0;
+		bool isFetchOrder = true;
+		for (uint32_t index : indices) {
+			if (index == nextVertex) {
+				++nextVertex;
+			} else {
+				isFetchOrder = isFetchOrder && index < nextVertex;
+			}
+		}
+		TEST_CHECK(isFetchOrder);
+	}
+
+	return Test::Finish("MeshOptimizerTest");
+}
@@ -0,0 +1,196 @@
+#include "ParticleCollisionSystem.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+	using Collider = ParticleCollisionSystem::Collider;
+	using Shape = ParticleCollisionSystem::Shape;
+	using Response = ParticleCollisionSystem::Response;
+
+	constexpr float kTolerance = 1e-5f;
+
+	// 末尾に1つ追加する（色は白、生存時間は10秒）
+	size_t AddParticle(ParticleStorage& particles, const Float3& position, const Float3& velocity)
+	{
+		size_t index = particles.Append(1);
+		particles.positionX[index] = position.x;
+		particles.positionY[index] = position.y;
+		particles.positionZ[index] = position.z;
+		particles.velocityX[index] = velocity.x;
+		particles.velocityY[index] = velocity.y;
+		particles.velocityZ[index] = velocity.z;
+		particles.colorR[index] = particles.colorG[index] = particles.colorB[index] = particles.colorA[index] = 1.0f;
+		particles.lifeTime[index] = 10.0f;
+		return index;
+	}
+
+	// コライダー1つだけを登録した状態でApplyする
+	void ApplySingle(const Collider& collider, ParticleStorage& particles)
+	{
+		ParticleCollisionSystem system;
+		system.Add(collider);
+		system.Build();
+		system.Apply(particles, 0, particles.Size());
+	}
+}
+
+int main()
+{
+	// 平面: 裏側に入ったものを面まで戻し、法線方向を反発係数で反射、接線方向を摩擦で減らす
+	{
+		Collider plane;
+		plane.shape = Shape::Plane;
+		plane.normal = { 0.0f, 1.0f, 0.0f };
+		plane.distance = 0.0f;
+		plane.restitution = 0.5f;
+		plane.friction = 0.1f;
+
+		ParticleStorage particles;
+		// 4つずつの処理と端数の両方を通るように7個
+		for (int i = 0; i < 7; ++i) {
+			AddParticle(particles, { float(i), -0.1f, 0.0f }, { 1.0f, -2.0f, 0.0f });
+		}
+		AddParticle(particles, { 0.0f, -0.1f, 0.0f }, { 0.0f, 3.0f, 0.0f }); // 離れていく向き
+		AddParticle(particles, { 0.0f, 0.5f, 0.0f }, { 0.0f, -1.0f, 0.0f }); // 表側
+		ApplySingle(plane, particles);
+
+		for (int i = 0; i < 7; ++i) {
+			TEST_CHECK_NEAR(particles.positionY[i], 0.0f, kTolerance);
+			TEST_CHECK_NEAR(particles.velocityX[i], 0.9f, kTolerance);
+			TEST_CHECK_NEAR(particles.velocityY[i], 1.0f, kTolerance);
+		}
+		// 離れていく向きなら、押し戻すだけで速度は変えない
+		TEST_CHECK_NEAR(particles.positionY[7], 0.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityY[7], 3.0f, kTolerance);
+		// 表側は変わらない
+		TEST_CHECK_NEAR(particles.positionY[8], 0.5f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityY[8], -1.0f, kTolerance);
+	}
+
+	// 球: 中心から外向きに表面まで押し出す（中心と重なった場合は+Y）
+	{
+		Collider sphere;
+		sphere.shape = Shape::Sphere;
+		sphere.center = { 0.0f, 0.0f, 0.0f };
+		sphere.radius = 1.0f;
+		sphere.restitution = 0.5f;
+		sphere.friction = 0.0f;
+
+		ParticleStorage particles;
+		AddParticle(particles, { 0.5f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f });
+		AddParticle(particles, { 0.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f });
+		AddParticle(particles, { 2.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f });
+		ApplySingle(sphere, particles);
+
+		TEST_CHECK_NEAR(particles.positionX[0], 1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityX[0], 0.5f, kTolerance);
+		TEST_CHECK_NEAR(particles.positionY[1], 1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityY[1], 0.5f, kTolerance);
+		TEST_CHECK_NEAR(particles.positionX[2], 2.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityX[2], -1.0f, kTolerance);
+	}
+
+	// 箱: 最も浅い面から外側に押し出す
+	{
+		Collider box;
+		box.shape = Shape::Box;
+		box.bounds = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+		box.restitution = 0.5f;
+		box.friction = 0.1f;
+
+		ParticleStorage particles;
+		AddParticle(particles, { 0.9f, 0.2f, 0.0f }, { -1.0f, 1.0f, 0.0f });
+		AddParticle(particles, { 0.0f, -0.95f, 0.1f }, { 0.0f, 2.0f, 0.0f });
+		AddParticle(particles, { 0.0f, 0.0f, -0.8f }, { 0.0f, 0.0f, 1.0f });
+		ApplySingle(box, particles);
+
+		TEST_CHECK_NEAR(particles.positionX[0], 1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityX[0], 0.5f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityY[0], 0.9f, kTolerance);
+		TEST_CHECK_NEAR(particles.positionY[1], -1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityY[1], -1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.positionZ[2], -1.0f, kTolerance);
+		TEST_CHECK_NEAR(particles.velocityZ[2], -0.5f, kTolerance);
+	}
+
+	// Kill: 内側に入ったものの寿命を終わらせ、RemoveDeadで消える
+	{
+		Collider sphere;
+		sphere.shape = Shape::Sphere;
+		sphere.radius = 1.0f;
+		sphere.response = Response::Kill;
+
+		ParticleStorage particles;
+		for (int i = 0; i < 5; ++i) {
+			AddParticle(particles, { i * 0.4f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f });
+		}
+		ApplySingle(sphere, particles);
+		TEST_CHECK(particles.RemoveDead() == 3);
+		TEST_CHECK(particles.Size() == 2);
+	}
+
+	// 候補の絞り込みを通しても、全てのコライダーを登録順に1つずつ適用した結果と一致する
+	{
+		Random random(20);
+		ParticleStorage particles;
+		for (int cluster = 0; cluster < 20; ++cluster) {
+			Float3 center = { random.Range(-50.0f, 50.0f), random.Range(0.0f, 10.0f), random.Range(-50.0f, 50.0f) };
+			for (int i = 0; i < 500; ++i) {
+				AddParticle(particles,
+					{ center.x + random.Range(-3.0f, 3.0f), center.y + random.Range(-3.0f, 3.0f), center.z + random.Range(-3.0f, 3.0f) },
+					{ random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) });
+			}
+		}
+
+		std::vector<Collider> colliders;
+		Collider ground;
+		ground.shape = Shape::Plane;
+		ground.distance = -1.0f;
+		colliders.push_back(ground);
+		for (int i = 0; i < 200; ++i) {
+			Collider collider;
+			Float3 center = { random.Range(-50.0f, 50.0f), random.Range(0.0f, 10.0f), random.Range(-50.0f, 50.0f) };
+			float extent = random.Range(1.0f, 3.0f);
+			if (i % 2) {
+				collider.shape = Shape::Sphere;
+				collider.center = center;
+				collider.radius = extent;
+			} else {
+				collider.shape = Shape::Box;
+				collider.bounds = { { center.x - extent, center.y - extent, center.z - extent }, { center.x + extent, center.y + extent, center.z + extent } };
+			}
+			colliders.push_back(collider);
+		}
+
+		ParticleStorage binned = particles;
+		ParticleCollisionSystem system;
+		for (const Collider& collider : colliders) {
+			system.Add(collider);
+		}
+		system.Build();
+		for (size_t begin = 0; begin < binned.Size(); begin += 1024) {
+			system.Apply(binned, begin, (std::min)(begin + 1024, binned.Size()));
+		}
+
+		ParticleStorage sequential = particles;
+		for (const Collider& collider : colliders) {
+			ApplySingle(collider, sequential);
+		}
+
+		bool isMatched = true;
+		size_t numMoved = 0;
+		for (size_t i = 0; i < particles.Size(); ++i) {
+			isMatched &= binned.positionX[i] == sequential.positionX[i] && binned.positionY[i] == sequential.positionY[i] &&
+				binned.positionZ[i] == sequential.positionZ[i] && binned.velocityY[i] == sequential.velocityY[i];
+			numMoved += binned.positionY[i] != particles.positionY[i];
+		}
+		TEST_CHECK(isMatched);
+		// 一部のパーティクルは実際に押し戻されている
+		TEST_CHECK(numMoved > 100);
+	}
+
+	return Test::Finish("ParticleCollisionTest");
+}
@@ -0,0 +1,99 @@
+#include "ParticleKernel.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+	// 乱数で埋めたパーティクルを作る（経過時間は生存時間より短くする）
+	ParticleStorage MakeParticles(size_t count, uint64_t seed)
+	{
+		Random random(seed);
+		ParticleStorage particles;
+		particles.Append(count);
+		for (std::vector<float>* stream : { &particles.positionX, &particles.positionY, &particles.positionZ,
+			&particles.velocityX, &particles.velocityY, &particles.velocityZ }) {
+			random.FillUniform(stream->data(), count, -50.0f, 50.0f);
+		}
+		random.FillUniform(particles.colorA.data(), count, 0.0f, 1.0f);
+		random.FillUniform(particles.lifeTime.data(), count, 1.0f, 3.0f);
+		random.FillUniform(particles.age.data(), count, 0.0f, 1.0f);
+		return particles;
+	}
+
+	// 2つの配列の先頭count個がビット単位で一致するか
+	bool IsBitEqual(const float* a, const float* b, size_t count)
+	{
+		return std::memcmp(a, b, sizeof(float) * count) == 0;
+	}
+}
+
+// SIMD版がReference版とビット単位で一致することを、開始位置と端数を変えながら確かめる
+int main()
+{
+	constexpr size_t kCount = 300;
+	const float kDeltaTimes[] = { 1.0f / 60.0f, 1.0f / 30.0f, 0.1f };
+
+	// Integrate: [begin, end)だけが進み、範囲外は変わらない
+	bool isIntegrateMatched = true;
+	for (float deltaTime : kDeltaTimes) {
+		for (size_t begin = 0; begin < 9; ++begin) {
+			for (size_t end = begin; end <= kCount; ++end) {
+				ParticleStorage simd = MakeParticles(kCount, end);
+				ParticleStorage reference = MakeParticles(kCount, end);
+				ParticleKernel::Integrate(simd, begin, end, deltaTime);
+				ParticleKernel::IntegrateReference(reference, begin, end, deltaTime);
+				for (std::vector<float> ParticleStorage::* stream : { &ParticleStorage::positionX, &ParticleStorage::positionY,
+					&ParticleStorage::positionZ, &ParticleStorage::age }) {
+					if (!IsBitEqual((simd.*stream).data(), (reference.*stream).data(), kCount)) {
+						isIntegrateMatched = false;
+					}
+				}
+			}
+		}
+	}
+	TEST_CHECK(isIntegrateMatched);
+
+	// Integrateで範囲外が変わらない
+	{
+		ParticleStorage before = MakeParticles(kCount, 1);
+		ParticleStorage after = MakeParticles(kCount, 1);
+		ParticleKernel::Integrate(after, 13, 200, 0.5f);
+		TEST_CHECK(IsBitEqual(before.positionX.data(), after.positionX.data(), 13));
+		TEST_CHECK(IsBitEqual(before.age.data() + 200, after.age.data() + 200, kCount - 200));
+		TEST_CHECK_NEAR(after.age[13], before.age[13] + 0.5f, 1e-6f);
+		TEST_CHECK_NEAR(after.positionY[100], before.positionY[100] + before.velocityY[100] * 0.5f, 1e-4f);
+	}
+
+	// ComputeAlpha
+	bool isAlphaMatched = true;
+	std::vector<float> alpha(kCount);
+	std::vector<float> alphaReference(kCount);
+	ParticleStorage particles = MakeParticles(kCount, 2);
+	for (size_t begin = 0; begin < 9; ++begin) {
+		for (size_t end = begin; end <= kCount; ++end) {
+			ParticleKernel::ComputeAlpha(particles, begin, end, alpha.data());
+			ParticleKernel::ComputeAlphaReference(particles, begin, end, alphaReference.data());
+			if (!IsBitEqual(alpha.data(), alphaReference.data(), end - begin)) {
+				isAlphaMatched = false;
+			}
+		}
+	}
+	TEST_CHECK(isAlphaMatched);
+
+	// 生まれた直後は元のAlpha、寿命の半分で半分、寿命で0
+	particles.colorA[0] = 0.8f;
+	particles.lifeTime[0] = 2.0f;
+	particles.age[0] = 0.0f;
+	ParticleKernel::ComputeAlpha(particles, 0, 1, alpha.data());
+	TEST_CHECK(alpha[0] == 0.8f);
+	particles.age[0] = 1.0f;
+	ParticleKernel::ComputeAlpha(particles, 0, 1, alpha.data());
+	TEST_CHECK_NEAR(alpha[0], 0.4f, 1e-6f);
+	particles.age[0] = 2.0f;
+	ParticleKernel::ComputeAlpha(particles, 0, 1, alpha.data());
+	TEST_CHECK(alpha[0] == 0.0f);
+
+	return Test::Finish("ParticleKernelTest");
+}
@@ -0,0 +1,85 @@
+#include "ParticleKernel.h"
+#include "ParticleStorage.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace {
+	// Particle.VS.hlslと同じ順序（下位からR, G, B, A）で8bitを取り出し、0～1に戻す
+	float UnpackChannel(uint32_t color, uint32_t channel)
+	{
+		return static_cast<float>((color >> (channel * 8)) & 0xFF) / 255.0f;
+	}
+
+	float Saturate(float value)
+	{
+		return (std::min)((std::max)(value, 0.0f), 1.0f);
+	}
+}
+
+int main()
+{
+	// 範囲外（負の値や1より大きい値）も含めた色を用意する
+	constexpr size_t kCount = 1024;
+	Random random(12);
+	ParticleStorage particles;
+	particles.Append(kCount);
+	random.FillUniform(particles.colorR.data(), kCount, -0.25f, 1.25f);
+	random.FillUniform(particles.colorG.data(), kCount, -0.25f, 1.25f);
+	random.FillUniform(particles.colorB.data(), kCount, -0.25f, 1.25f);
+	std::vector<float> alpha(kCount);
+	random.FillUniform(alpha.data(), kCount, -0.25f, 1.25f);
+
+	// 境界値（0, 1, ちょうど中間）を先頭に置く
+	const float kEdges[] = { 0.0f, 1.0f, 0.5f, 127.5f / 255.0f, -0.0f, 1.0f / 255.0f, 254.5f / 255.0f, 2.0f };
+	for (size_t i = 0; i < std::size(kEdges); ++i) {
+		particles.colorR[i] = kEdges[i];
+		particles.colorG[i] = kEdges[std::size(kEdges) - 1 - i];
+		particles.colorB[i] = kEdges[i];
+		alpha[i] = kEdges[i];
+	}
+
+	// SIMD版とスカラー版が、端数や開始位置によらずビット単位で一致する
+	std::vector<uint32_t> packed(kCount);
+	std::vector<uint32_t> reference(kCount);
+	bool isMatched = true;
+	for (size_t begin = 0; begin < 5; ++begin) {
+		for (size_t end = begin + 1; end <= kCount; ++end) {
+			ParticleKernel::PackColors(particles, begin, end, alpha.data(), packed.data());
+			ParticleKernel::PackColorsReference(particles, begin, end, alpha.data(), reference.data());
+			if (!std::equal(packed.begin(), packed.begin() + (end - begin), reference.begin())) {
+				isMatched = false;
+			}
+		}
+	}
+	TEST_CHECK(isMatched);
+
+	// 詰めた値を戻すと、0～1に収めた元の値との差は量子化の半目盛り以内
+	ParticleKernel::PackColors(particles, 0, kCount, alpha.data(), packed.data());
+	const float kTolerance = 0.5f / 255.0f + 1e-6f;
+	float maxError = 0.0f;
+	for (size_t i = 0; i < kCount; ++i) {
+		const float inputs[4] = { particles.colorR[i], particles.colorG[i], particles.colorB[i], alpha[i] };
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			maxError = (std::max)(maxError, std::fabs(UnpackChannel(packed[i], channel) - Saturate(inputs[channel])));
+		}
+	}
+	TEST_CHECK(maxError <= kTolerance);
+
+	// 0と1は誤差なく表せる
+	TEST_CHECK(ParticleKernel::PackColor(0.0f, 0.0f, 0.0f, 0.0f) == 0x00000000u);
+	TEST_CHECK(ParticleKernel::PackColor(1.0f, 1.0f, 1.0f, 1.0f) == 0xFFFFFFFFu);
+	// 下位からR, G, B, Aの順に並ぶ
+	TEST_CHECK(ParticleKernel::PackColor(1.0f, 0.0f, 0.0f, 0.0f) == 0x000000FFu);
+	TEST_CHECK(ParticleKernel::PackColor(0.0f, 1.0f, 0.0f, 0.0f) == 0x0000FF00u);
+	TEST_CHECK(ParticleKernel::PackColor(0.0f, 0.0f, 1.0f, 0.0f) == 0x00FF0000u);
+	TEST_CHECK(ParticleKernel::PackColor(0.0f, 0.0f, 0.0f, 1.0f) == 0xFF000000u);
+	// 中間は四捨五入（0.5 * 255 = 127.5 → 128）
+	TEST_CHECK(ParticleKernel::PackColor(0.5f, 0.0f, 0.0f, 0.0f) == 128u);
+	// 範囲外は0～1に収める
+	TEST_CHECK(ParticleKernel::PackColor(-1.0f, 2.0f, -0.0f, 100.0f) == 0xFF00FF00u);
+
+	return Test::Finish("ParticlePackingTest");
+}
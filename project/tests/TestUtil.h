@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdio>
+#include <cmath>
+
+// テスト用の判定（失敗しても最後まで続け、Finishで失敗の数から終了コードを決める）
+namespace Test
+{
+	inline int& FailureCount()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline bool Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (!condition) {
+			std::printf("%s(%d): failed: %s\n", file, line, expression);
+			++FailureCount();
+		}
+		return condition;
+	}
+
+	inline int Finish(const char* name)
+	{
+		std::printf("%s: %s (%d failures)\n", name, FailureCount() == 0 ? "passed" : "FAILED", FailureCount());
+		return FailureCount() == 0 ? 0 : 1;
+	}
+}
+
+#define TEST_CHECK(condition) Test::Check((condition), #condition, __FILE__, __LINE__)
+#define TEST_CHECK_NEAR(actual, expected, tolerance) \
+	Test::Check(std::fabs(double(actual) - double(expected)) <= double(tolerance), #actual " ~= " #expected, __FILE__, __LINE__)
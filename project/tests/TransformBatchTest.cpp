@@ -0,0 +1,88 @@
+#include "TransformBatch.h"
+#include "Transform.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+	// 要素ごとの差の最大値（大きい要素は相対誤差で比べる）
+	float MaxRelativeDifference(const Matrix& a, const Matrix& b)
+	{
+		float difference = 0.0f;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				float scale = 1.0f + std::fabs(b.r[row][column]);
+				difference = (std::max)(difference, std::fabs(a.r[row][column] - b.r[row][column]) / scale);
+			}
+		}
+		return difference;
+	}
+}
+
+int main()
+{
+	// TransformBatchの結果を、1つずつ作ったMatrix::Affineと比べる
+	// 端数の処理を確かめるため、4の倍数でない数も試す
+	const float kTolerance = 1e-5f;
+	const size_t kCounts[] = { 0, 1, 3, 4, 5, 7, 8, 1001 };
+
+	Random random(7);
+	for (size_t count : kCounts) {
+		TransformBatch batch;
+		batch.Reserve(count);
+		std::vector<Transform> transforms(count);
+		for (Transform& transform : transforms) {
+			transform.scale = { random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f), random.Range(0.2f, 3.0f) };
+			transform.rotate = { random.Range(-6.0f, 6.0f), random.Range(-6.0f, 6.0f), random.Range(-6.0f, 6.0f) };
+			transform.translate = { random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f), random.Range(-30.0f, 30.0f) };
+			batch.Add(transform);
+		}
+		TEST_CHECK(batch.Size() == count);
+
+		// 書き込むのはcount個だけで、その先は触らない
+		Matrix sentinel = Matrix::Scaling({ 9.0f, 9.0f, 9.0f });
+		std::vector<Matrix> out(count + 1, sentinel);
+		batch.MakeAffineMatrices(out.data());
+
+		float maxDifference = 0.0f;
+		for (size_t i = 0; i < count; ++i) {
+			const Transform& transform = transforms[i];
+			Matrix expected = Matrix::Affine(transform.scale, transform.rotate, transform.translate);
+			maxDifference = (std::max)(maxDifference, MaxRelativeDifference(out[i], expected));
+		}
+		std::printf("count %4zu: max difference %g\n", count, maxDifference);
+		TEST_CHECK(maxDifference < kTolerance);
+		TEST_CHECK(MaxRelativeDifference(out[count], sentinel) == 0.0f);
+	}
+
+	// 一様スケールは同じ配列を3成分に使える
+	{
+		const size_t kCount = 6;
+		float scale[kCount], rotateX[kCount], rotateY[kCount], rotateZ[kCount], translateX[kCount], translateY[kCount], translateZ[kCount];
+		for (size_t i = 0; i < kCount; ++i) {
+			scale[i] = random.Range(0.2f, 3.0f);
+			rotateX[i] = random.Range(-3.0f, 3.0f);
+			rotateY[i] = random.Range(-3.0f, 3.0f);
+			rotateZ[i] = random.Range(-3.0f, 3.0f);
+			translateX[i] = random.Range(-30.0f, 30.0f);
+			translateY[i] = random.Range(-30.0f, 30.0f);
+			translateZ[i] = random.Range(-30.0f, 30.0f);
+		}
+		TransformBatch::Streams streams = { scale, scale, scale, rotateX, rotateY, rotateZ, translateX, translateY, translateZ };
+		Matrix out[kCount];
+		TransformBatch::MakeAffineMatrices(streams, out, kCount);
+		for (size_t i = 0; i < kCount; ++i) {
+			Matrix expected = Matrix::Affine({ scale[i], scale[i], scale[i] }, { rotateX[i], rotateY[i], rotateZ[i] }, { translateX[i], translateY[i], translateZ[i] });
+			TEST_CHECK(MaxRelativeDifference(out[i], expected) < kTolerance);
+		}
+	}
+
+	// Clearすると空になる
+	TransformBatch batch;
+	batch.Add(Transform{ { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 3.0f } });
+	batch.Clear();
+	TEST_CHECK(batch.Size() == 0);
+
+	return Test::Finish("TransformBatchTest");
+}
@@ -0,0 +1,163 @@
+#include "VertexQuantization.h"
+#include "Random.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+namespace {
+	uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	// 2^exponent
+	float Pow2(int exponent)
+	{
+		return ldexpf(1.0f, exponent);
+	}
+}
+
+// VertexQuantization.hに書いた誤差の上限と、halfへの変換の特殊な値を確かめる
+int main()
+{
+	Random random(24);
+
+	// 位置: 軸ごとの誤差は範囲の1/131070以下（16bitの半目盛り）
+	{
+		AABB bounds = { { -3.0f, 0.5f, -100.0f }, { 7.0f, 0.75f, 250.0f } };
+		const float extent[3] = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+		Matrix dequantize = VertexQuantization::MakeDequantizeMatrix(bounds);
+		float maxRelativeError = 0.0f;
+		float maxMatrixError = 0.0f;
+		for (int i = 0; i < 100000; ++i) {
+			ModelVertex vertex = {};
+			vertex.position = { random.Range(bounds.min.x, bounds.max.x), random.Range(bounds.min.y, bounds.max.y), random.Range(bounds.min.z, bounds.max.z), 1.0f };
+			// 範囲の端もちょうど表せる
+			if (i < 2) {
+				Float3 corner = i == 0 ? bounds.min : bounds.max;
+				vertex.position = { corner.x, corner.y, corner.z, 1.0f };
+			}
+			QuantizedModelVertex quantized = VertexQuantization::Quantize(vertex, bounds);
+			ModelVertex restored = VertexQuantization::Dequantize(quantized, bounds);
+			const float input[3] = { vertex.position.x, vertex.position.y, vertex.position.z };
+			const float output[3] = { restored.position.x, restored.position.y, restored.position.z };
+			for (int axis = 0; axis < 3; ++axis) {
+				maxRelativeError = (std::max)(maxRelativeError, fabsf(output[axis] - input[axis]) / extent[axis]);
+			}
+
+			// VSと同じく、0～1の位置に行列を掛けても同じ位置に戻る
+			float u[3];
+			for (int axis = 0; axis < 3; ++axis) {
+				u[axis] = float(quantized.position[axis]) / 65535.0f;
+			}
+			for (int axis = 0; axis < 3; ++axis) {
+				float transformed = u[0] * dequantize.r[0][axis] + u[1] * dequantize.r[1][axis] + u[2] * dequantize.r[2][axis] + dequantize.r[3][axis];
+				maxMatrixError = (std::max)(maxMatrixError, fabsf(transformed - output[axis]) / extent[axis]);
+			}
+		}
+		// 1/131070に、float自体の丸め誤差の分だけ余裕を持たせる
+		TEST_CHECK(maxRelativeError <= 1.0f / 131070.0f + 1e-7f);
+		TEST_CHECK(maxMatrixError <= 1e-6f);
+	}
+
+	// UV: 0～1では誤差2^-12以下
+	{
+		float maxError = 0.0f;
+		for (int i = 0; i <= 1000000; ++i) {
+			float u = float(i) / 1000000.0f;
+			maxError = (std::max)(maxError, fabsf(VertexQuantization::HalfToFloat(VertexQuantization::FloatToHalf(u)) - u));
+		}
+		TEST_CHECK(maxError <= Pow2(-12));
+	}
+
+	// half: NaN以外の全てのhalfはfloatを経由してもビット単位で戻る（非正規化数・無限大・-0を含む）
+	{
+		bool isRoundTrip = true;
+		for (uint32_t bits = 0; bits < 0x10000u; ++bits) {
+			uint16_t half = static_cast<uint16_t>(bits);
+			bool isNaN = (half & 0x7C00u) == 0x7C00u && (half & 0x03FFu) != 0;
+			if (isNaN) {
+				continue;
+			}
+			isRoundTrip &= VertexQuantization::FloatToHalf(VertexQuantization::HalfToFloat(half)) == half;
+		}
+		TEST_CHECK(isRoundTrip);
+	}
+
+	// half: 特殊な値
+	{
+		using VQ = VertexQuantization;
+		// 0と-0
+		TEST_CHECK(VQ::FloatToHalf(0.0f) == 0x0000u);
+		TEST_CHECK(VQ::FloatToHalf(-0.0f) == 0x8000u);
+		// 非正規化数（2^-24単位）
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-24)) == 0x0001u);
+		TEST_CHECK(VQ::FloatToHalf(-Pow2(-24)) == 0x8001u);
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-15)) == 0x0200u);
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-14) - Pow2(-24)) == 0x03FFu);
+		TEST_CHECK(VQ::HalfToFloat(0x0001u) == Pow2(-24));
+		TEST_CHECK(VQ::HalfToFloat(0x03FFu) == Pow2(-14) - Pow2(-24));
+		// 最小の非正規化数の半分以下は0に、ちょうど中間は偶数側に丸める
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-25)) == 0x0000u);
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-25) * 1.01f) == 0x0001u);
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-24) * 1.5f) == 0x0002u);
+		TEST_CHECK(VQ::FloatToHalf(1e-10f) == 0x0000u);
+		// 最小の正規化数
+		TEST_CHECK(VQ::FloatToHalf(Pow2(-14)) == 0x0400u);
+		// 正規化数の中間は偶数側に丸める（1 + 2^-11 は 1 と 1 + 2^-10 の中間）
+		TEST_CHECK(VQ::FloatToHalf(1.0f) == 0x3C00u);
+		TEST_CHECK(VQ::FloatToHalf(1.0f + Pow2(-11)) == 0x3C00u);
+		TEST_CHECK(VQ::FloatToHalf(1.0f + 3.0f * Pow2(-11)) == 0x3C02u);
+		// 最大値と、丸めると溢れる値
+		TEST_CHECK(VQ::FloatToHalf(65504.0f) == 0x7BFFu);
+		TEST_CHECK(VQ::FloatToHalf(65519.0f) == 0x7BFFu);
+		TEST_CHECK(VQ::FloatToHalf(65520.0f) == 0x7C00u);
+		TEST_CHECK(VQ::FloatToHalf(1e10f) == 0x7C00u);
+		// 無限大
+		TEST_CHECK(VQ::FloatToHalf(INFINITY) == 0x7C00u);
+		TEST_CHECK(VQ::FloatToHalf(-INFINITY) == 0xFC00u);
+		TEST_CHECK(VQ::HalfToFloat(0x7C00u) == INFINITY);
+		TEST_CHECK(VQ::HalfToFloat(0xFC00u) == -INFINITY);
+		// NaNはNaNのまま（指数が全て1で仮数が0以外）
+		uint16_t nan = VQ::FloatToHalf(NAN);
+		TEST_CHECK((nan & 0x7C00u) == 0x7C00u && (nan & 0x03FFu) != 0);
+		TEST_CHECK(isnan(VQ::HalfToFloat(nan)));
+		uint16_t negativeNaN = VQ::FloatToHalf(-NAN);
+		TEST_CHECK((negativeNaN & 0x7C00u) == 0x7C00u && (negativeNaN & 0x03FFu) != 0);
+		TEST_CHECK(isnan(VQ::HalfToFloat(0x7E00u)) && (FloatBits(VQ::HalfToFloat(0x7E00u)) & 0x7F800000u) == 0x7F800000u);
+	}
+
+	// 法線: 向きの誤差は0.04度以下（軸の向きと、球面上の一様な向き）
+	{
+		const float kMaxDegrees = 0.04f;
+		double maxDegrees = 0.0;
+		auto check = [&](const Float3& normal) {
+			int16_t x, y;
+			VertexQuantization::EncodeOctahedral(normal, &x, &y);
+			Float3 decoded = VertexQuantization::DecodeOctahedral(x, y);
+			double dot = double(decoded.x) * normal.x + double(decoded.y) * normal.y + double(decoded.z) * normal.z;
+			double degrees = acos((std::min)(dot, 1.0)) * 180.0 / 3.14159265358979;
+			maxDegrees = (std::max)(maxDegrees, degrees);
+		};
+		const Float3 kAxes[] = {
+			{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+			{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+		};
+		for (const Float3& axis : kAxes) {
+			check(axis);
+		}
+		for (int i = 0; i < 200000; ++i) {
+			// 球面上の一様な向き（zを一様に、まわりの角度を一様に取る）
+			float z = random.Range(-1.0f, 1.0f);
+			float angle = random.Range(0.0f, 6.2831853f);
+			float radius = sqrtf((std::max)(1.0f - z * z, 0.0f));
+			check({ radius * cosf(angle), radius * sinf(angle), z });
+		}
+		TEST_CHECK(maxDegrees <= kMaxDegrees);
+	}
+
+	return Test::Finish("VertexQuantizationTest");
+}